@@ -95,9 +95,18 @@ void setup()
 
 void loop()
 {
-    bool fdValid = mySensor.isFlickerDetectionValid(); // Get the flicker detection valid status
-    bool fdSaturation = mySensor.isFlickerDetectionSaturated(); // Get the flicker detection saturation status
-    uint8_t fdFrequency = mySensor.getFlickerDetectionFrequency(); // Get the flicker detection frequency
+    // Read the flicker detection status once, one FD_STATUS read for all of the fields below
+    sfe_as7343_flicker_status_t fdStatus;
+    if (mySensor.readFlickerStatus(fdStatus) == false)
+    {
+        Serial.println("Failed to read the flicker detection status.");
+        delay(1000);
+        return;
+    }
+
+    bool fdValid = fdStatus.valid;            // The flicker detection valid status
+    bool fdSaturation = fdStatus.saturated;   // The flicker detection saturation status
+    uint8_t fdFrequency = fdStatus.frequency; // The flicker detection frequency
 
     // Check if the flicker detection measurement is valid
     // if it is not valid, print a message and return
@@ -124,7 +133,7 @@ void loop()
 
     if(fdValid == true && fdSaturation == false)
     {
-        if (fdFrequency == 0) // if getFlickerDetectionFrequency() returns 0, no frequency detected
+        if (fdFrequency == 0) // if the frequency is 0, no frequency detected
             Serial.print("No Flicker Detected");
         else
         {
@@ -0,0 +1,131 @@
+/*
+  Using the AMS AS7343 Sensor.
+
+  This example shows how to stream spectral data through the AS7343 FIFO.
+  The sensor runs continuously with a short integration time and pushes four
+  channels (FZ, FY, FXL, NIR) into its 256 byte FIFO after every measurement.
+  The loop drains all waiting samples with a single burst read, instead of
+  polling the data registers after every integration.
+
+  By: SparkFun Electronics
+  Date: 2026/10/14
+  SparkFun code, firmware, and software is released under the MIT License.
+    Please see LICENSE.md for further details.
+
+  Hardware Connections:
+  IoT RedBoard --> AS7343
+  QWIIC --> QWIIC
+
+  Serial.print it out at 115200 baud to serial monitor.
+
+  Feel like supporting our work? Buy a board from SparkFun!
+  https://www.sparkfun.com/products/23220
+*/
+
+#include <SparkFun_AS7343.h>
+
+SfeAS7343ArdI2C mySensor;
+
+#define FIFO_CHANNELS 4 // Number of channels mapped into the FIFO (CH0-CH3)
+
+uint16_t myFifoData[ksfAS7343FifoMaxEntries]; // Array to hold the drained FIFO entries
+
+void setup()
+{
+    Serial.begin(115200);
+    while (!Serial)
+    {
+        delay(100);
+    };
+    Serial.println("AS7343 Example 08 - FIFO");
+
+    Wire.begin();
+
+    // Initialize sensor and run default setup.
+    if (mySensor.begin() == false)
+    {
+        Serial.println("Sensor failed to begin. Please check your wiring!");
+        Serial.println("Halting...");
+        while (1)
+            ;
+    }
+
+    Serial.println("Sensor began.");
+
+    // Power on the device
+    if (mySensor.powerOn() == false)
+    {
+        Serial.println("Failed to power on the device.");
+        Serial.println("Halting...");
+        while (1)
+            ;
+    }
+    Serial.println("Device powered on.");
+
+    // Set up the measurement in one batch: 6 channel AutoSmux, and a short
+    // integration time of (ATIME + 1) x (ASTEP + 1) x 2.78us = 1 x 1000 x 2.78us = 2.78ms.
+    sfe_as7343_config_t config;
+    mySensor.getConfig(config);
+    config.autoSmux = AUTOSMUX_6_CHANNELS;
+    config.again = AGAIN_256;
+    config.atime = 0;
+    config.astep = 999;
+
+    if (mySensor.applyConfig(config) == false)
+    {
+        Serial.println("Failed to apply the configuration.");
+        Serial.println("Halting...");
+        while (1)
+            ;
+    }
+    Serial.println("Configuration applied.");
+
+    // Push channels CH0-CH3 (FZ, FY, FXL, NIR) into the FIFO after every measurement
+    if (mySensor.setFifoMap(0x0F) == false)
+    {
+        Serial.println("Failed to set the FIFO map.");
+        Serial.println("Halting...");
+        while (1)
+            ;
+    }
+    Serial.println("FIFO map set to CH0-CH3.");
+
+    // Start with an empty FIFO
+    mySensor.clearFifo();
+
+    // Enable Spectral Measurement
+    if (mySensor.enableSpectralMeasurement() == false)
+    {
+        Serial.println("Failed to enable spectral measurement.");
+        Serial.println("Halting...");
+        while (1)
+            ;
+    }
+    Serial.println("Spectral measurement enabled.");
+}
+
+void loop()
+{
+    // Drain everything waiting in the FIFO with one burst read
+    size_t numEntries = mySensor.readFifo(myFifoData, ksfAS7343FifoMaxEntries);
+
+    // If the FIFO filled up before we got to it, some samples were lost
+    if (mySensor.getFifoOverflowStatus() == true)
+    {
+        Serial.println("FIFO overflow, samples were lost.");
+        mySensor.clearFifo();
+    }
+
+    // Print one line per measurement: FZ, FY, FXL, NIR
+    for (size_t entry = 0; entry + FIFO_CHANNELS <= numEntries; entry += FIFO_CHANNELS)
+    {
+        for (int channel = 0; channel < FIFO_CHANNELS; channel++)
+        {
+            Serial.print(myFifoData[entry + channel]);
+            Serial.print(",");
+        }
+        Serial.println();
+    }
+
+    delay(50);
+}
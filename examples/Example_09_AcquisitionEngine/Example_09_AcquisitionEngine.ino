@@ -0,0 +1,141 @@
+/*
+  Using the AMS AS7343 Sensor.
+
+  This example shows how to use the interrupt driven acquisition engine.
+  The sensor pulls its INT pin low after every measurement. The pin's ISR
+  only notes the time, and the engine does the bus work (read status, read
+  data, clear the interrupt) the next time loop() calls service(). Finished
+  frames are queued, so loop() just pops them - nothing is busy-polled.
+
+  By: SparkFun Electronics
+  Date: 2026/10/14
+  SparkFun code, firmware, and software is released under the MIT License.
+    Please see LICENSE.md for further details.
+
+  Hardware Connections:
+  IoT RedBoard --> AS7343
+  QWIIC --> QWIIC
+  Pin 4 --> INT
+
+  Serial.print it out at 115200 baud to serial monitor.
+
+  Feel like supporting our work? Buy a board from SparkFun!
+  https://www.sparkfun.com/products/23220
+*/
+
+#include <SparkFun_AS7343.h>
+
+SfeAS7343ArdI2C mySensor;
+
+sfDevAS7343Acquisition<4> myEngine; // Acquisition engine with a queue of 4 frames
+
+#define INT_HW_READ_PIN 4 // Pin connected to the INT pin of the AS7343
+
+// INT pin ISR, keep it short: just hand the time of the edge to the engine
+void onSensorInterrupt()
+{
+    myEngine.onInterrupt(micros());
+}
+
+void setup()
+{
+    // Set the pin mode for the interrupt pin
+    pinMode(INT_HW_READ_PIN, INPUT); // Set the pin to input, the qwiic bob has a pullup resistor
+
+    Serial.begin(115200);
+    while (!Serial)
+    {
+        delay(100);
+    };
+    Serial.println("AS7343 Example 09 - Acquisition Engine");
+
+    Wire.begin();
+
+    // Initialize sensor and run default setup.
+    if (mySensor.begin() == false)
+    {
+        Serial.println("Sensor failed to begin. Please check your wiring!");
+        Serial.println("Halting...");
+        while (1)
+            ;
+    }
+
+    Serial.println("Sensor began.");
+
+    // Power on the device
+    if (mySensor.powerOn() == false)
+    {
+        Serial.println("Failed to power on the device.");
+        Serial.println("Halting...");
+        while (1)
+            ;
+    }
+    Serial.println("Device powered on.");
+
+    // Measure all 18 channels, and wait 100ms ((WTIME + 1) x 2.78ms) between measurements
+    sfe_as7343_config_t config;
+    mySensor.getConfig(config);
+    config.autoSmux = AUTOSMUX_18_CHANNELS;
+    config.wtime = 35;
+    config.waitTime = true;
+
+    if (mySensor.applyConfig(config) == false)
+    {
+        Serial.println("Failed to apply the configuration.");
+        Serial.println("Halting...");
+        while (1)
+            ;
+    }
+    Serial.println("Configuration applied.");
+
+    // Attach the engine and arm the interrupt after every measurement
+    if (myEngine.begin(&mySensor) == false || myEngine.arm(ACQUISITION_MODE_FRAME) == false)
+    {
+        Serial.println("Failed to arm the acquisition engine.");
+        Serial.println("Halting...");
+        while (1)
+            ;
+    }
+    Serial.println("Acquisition engine armed.");
+
+    attachInterrupt(digitalPinToInterrupt(INT_HW_READ_PIN), onSensorInterrupt, FALLING);
+
+    // Enable Spectral Measurement
+    if (mySensor.enableSpectralMeasurement() == false)
+    {
+        Serial.println("Failed to enable spectral measurement.");
+        Serial.println("Halting...");
+        while (1)
+            ;
+    }
+    Serial.println("Spectral measurement enabled.");
+}
+
+void loop()
+{
+    // Does nothing (and touches no bus) unless the INT pin fired
+    myEngine.service();
+
+    // Print every finished frame: timestamp, then all 18 channels
+    sfe_as7343_frame_t frame;
+
+    while (myEngine.pop(frame))
+    {
+        Serial.print(frame.timestamp);
+        Serial.print(":\t");
+
+        for (int channel = 0; channel < ksfAS7343NumChannels; channel++)
+        {
+            Serial.print(frame.data[channel]);
+            Serial.print(",");
+        }
+
+        // Each frame also carries the gain it was measured with, and saturation flags
+        if (frame.saturatedAnalog || frame.saturatedDigital)
+            Serial.print(" saturated");
+
+        Serial.println();
+    }
+
+    // The loop is free to do other work here
+}
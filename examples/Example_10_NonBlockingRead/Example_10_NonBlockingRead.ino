@@ -0,0 +1,136 @@
+/*
+  Using the AMS AS7343 Sensor.
+
+  This example shows how to read the spectral data without blocking the loop,
+  using startRead(), poll() and isReadComplete(). The loop keeps blinking the
+  built in LED while the data is read.
+
+  Plain Wire has no background transfers, so here startRead() falls back to a
+  blocking read and the read is already complete when it returns. On a board
+  with an asynchronous (DMA or interrupt driven) I2C implementation, hand it to
+  setAsyncBus() and the same loop code runs the read in the background, see
+  sfDevAS7343AsyncBus. The library ships no such bus for a board yet, the host
+  benchmark in extras/host_bench runs this loop on a simulated one.
+
+  By: SparkFun Electronics
+  Date: 2026/10/14
+  SparkFun code, firmware, and software is released under the MIT License.
+    Please see LICENSE.md for further details.
+
+  Hardware Connections:
+  IoT RedBoard --> AS7343
+  QWIIC --> QWIIC
+
+  Serial.print it out at 115200 baud to serial monitor.
+
+  Feel like supporting our work? Buy a board from SparkFun!
+  https://www.sparkfun.com/products/23220
+*/
+
+#include <SparkFun_AS7343.h>
+
+SfeAS7343ArdI2C mySensor;
+
+unsigned long lastStart = 0; // Time the last read was started
+unsigned long lastBlink = 0; // Time the LED was last toggled
+bool newData = false;        // True while a started read has not been printed yet
+
+void setup()
+{
+    pinMode(LED_BUILTIN, OUTPUT);
+
+    Serial.begin(115200);
+    while (!Serial)
+    {
+        delay(100);
+    };
+    Serial.println("AS7343 Example 10 - Non-Blocking Read");
+
+    Wire.begin();
+
+    // Initialize sensor and run default setup.
+    if (mySensor.begin() == false)
+    {
+        Serial.println("Sensor failed to begin. Please check your wiring!");
+        Serial.println("Halting...");
+        while (1)
+            ;
+    }
+
+    Serial.println("Sensor began.");
+
+    // Power on the device
+    if (mySensor.powerOn() == false)
+    {
+        Serial.println("Failed to power on the device.");
+        Serial.println("Halting...");
+        while (1)
+            ;
+    }
+    Serial.println("Device powered on.");
+
+    // Set the AutoSmux to output all 18 channels
+    if (mySensor.setAutoSmux(AUTOSMUX_18_CHANNELS) == false)
+    {
+        Serial.println("Failed to set AutoSmux.");
+        Serial.println("Halting...");
+        while (1)
+            ;
+    }
+    Serial.println("AutoSmux set to 18 channels.");
+
+    // Enable Spectral Measurement
+    if (mySensor.enableSpectralMeasurement() == false)
+    {
+        Serial.println("Failed to enable spectral measurement.");
+        Serial.println("Halting...");
+        while (1)
+            ;
+    }
+    Serial.println("Spectral measurement enabled.");
+}
+
+void loop()
+{
+    // Start a new read every 500ms, unless one is still in flight
+    if (millis() - lastStart >= 500 && mySensor.poll() != READ_STATE_BUSY)
+    {
+        lastStart = millis();
+
+        if (mySensor.startRead() == false)
+        {
+            Serial.println("Failed to start the read.");
+        }
+        else
+        {
+            newData = true;
+        }
+    }
+
+    // Print the data once, as soon as the read is complete
+    if (newData && mySensor.isReadComplete())
+    {
+        newData = false;
+
+        Serial.print(mySensor.getBlue());
+        Serial.print(",");
+
+        Serial.print(mySensor.getRed());
+        Serial.print(",");
+
+        Serial.print(mySensor.getGreen());
+        Serial.print(",");
+
+        Serial.print(mySensor.getNIR());
+        Serial.print(",");
+
+        Serial.println();
+    }
+
+    // Work that must not be held up by the sensor
+    if (millis() - lastBlink >= 100)
+    {
+        lastBlink = millis();
+        digitalWrite(LED_BUILTIN, !digitalRead(LED_BUILTIN));
+    }
+}
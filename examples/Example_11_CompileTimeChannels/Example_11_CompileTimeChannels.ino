@@ -0,0 +1,99 @@
+/*
+  Using the AMS AS7343 Sensor.
+
+  This example shows how to fix the AutoSmux mode at compile time with
+  SfeAS7343ArdI2CT. begin() sets the mode, each read only fetches the
+  channels that mode produces, and get<CHANNEL>() checks at compile time
+  that the channel is produced at all. Try get<CH_RED_F7_690NM>() below:
+  it is a cycle 3 channel, so with 6 channels the sketch does not compile.
+
+  By: SparkFun Electronics
+  Date: 2026/10/14
+  SparkFun code, firmware, and software is released under the MIT License.
+    Please see LICENSE.md for further details.
+
+  Hardware Connections:
+  IoT RedBoard --> AS7343
+  QWIIC --> QWIIC
+
+  Serial.print it out at 115200 baud to serial monitor.
+
+  Feel like supporting our work? Buy a board from SparkFun!
+  https://www.sparkfun.com/products/23220
+*/
+
+#include <SparkFun_AS7343.h>
+
+SfeAS7343ArdI2CT<AUTOSMUX_6_CHANNELS> mySensor; // Sensor producing the 6 cycle 1 channels
+
+void setup()
+{
+    Serial.begin(115200);
+    while (!Serial)
+    {
+        delay(100);
+    };
+    Serial.println("AS7343 Example 11 - Compile Time Channels");
+
+    Wire.begin();
+
+    // Initialize sensor, run default setup and set the AutoSmux to 6 channels.
+    if (mySensor.begin() == false)
+    {
+        Serial.println("Sensor failed to begin. Please check your wiring!");
+        Serial.println("Halting...");
+        while (1)
+            ;
+    }
+
+    Serial.println("Sensor began.");
+
+    // Power on the device
+    if (mySensor.powerOn() == false)
+    {
+        Serial.println("Failed to power on the device.");
+        Serial.println("Halting...");
+        while (1)
+            ;
+    }
+    Serial.println("Device powered on.");
+
+    // Enable Spectral Measurement
+    if (mySensor.enableSpectralMeasurement() == false)
+    {
+        Serial.println("Failed to enable spectral measurement.");
+        Serial.println("Halting...");
+        while (1)
+            ;
+    }
+    Serial.println("Spectral measurement enabled.");
+}
+
+void loop()
+{
+    delay(500);
+
+    // Read the data registers, only the 6 channels the mode produces (12 bytes)
+    // if it fails, print a failure message and continue
+    if (mySensor.readSpectraDataFromSensor() == false)
+    {
+        Serial.println("Failed to read spectral data.");
+        return;
+    }
+
+    Serial.print(mySensor.get<CH_BLUE_FZ_450NM>());
+    Serial.print(",");
+
+    Serial.print(mySensor.get<CH_GREEN_FY_555NM>());
+    Serial.print(",");
+
+    Serial.print(mySensor.get<CH_ORANGE_FXL_600NM>());
+    Serial.print(",");
+
+    Serial.print(mySensor.get<CH_NIR_855NM>());
+    Serial.print(",");
+
+    // Serial.print(mySensor.get<CH_RED_F7_690NM>()); // Does not compile, not produced with 6 channels
+
+    Serial.println();
+}
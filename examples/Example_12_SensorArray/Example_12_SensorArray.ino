@@ -0,0 +1,124 @@
+/*
+  Using the AMS AS7343 Sensor.
+
+  This example shows how to run several AS7343 sensors on one bus. All
+  AS7343s share the same I2C address, so each sits on its own channel of a
+  TCA9548A I2C mux (SparkFun Qwiic Mux). The array selects the mux channel
+  of whichever sensor it talks to, starts the sensors staggered across one
+  frame period, and then reads them round-robin as each one finishes.
+
+  By: SparkFun Electronics
+  Date: 2026/10/14
+  SparkFun code, firmware, and software is released under the MIT License.
+    Please see LICENSE.md for further details.
+
+  Hardware Connections:
+  IoT RedBoard --> Qwiic Mux (0x70)
+  QWIIC --> QWIIC
+  Qwiic Mux channel 0..3 --> AS7343 #0..#3
+
+  Serial.print it out at 115200 baud to serial monitor.
+
+  Feel like supporting our work? Buy a board from SparkFun!
+  https://www.sparkfun.com/products/23220
+*/
+
+#include <SparkFun_AS7343.h>
+#include <SparkFun_AS7343_Array.h>
+
+#define NUM_SENSORS 4 // Sensors on mux channels 0 to NUM_SENSORS - 1
+
+SfeAS7343ArdI2CArray<NUM_SENSORS> myArray;
+
+void setup()
+{
+    Serial.begin(115200);
+    while (!Serial)
+    {
+        delay(100);
+    };
+    Serial.println("AS7343 Example 12 - Sensor Array");
+
+    Wire.begin();
+
+    // One sensor per mux channel
+    for (uint8_t channel = 0; channel < NUM_SENSORS; channel++)
+        myArray.addSensor(kTCA9548AAddr, channel);
+
+    // Initialize all sensors and run default setup.
+    if (myArray.begin() == false)
+    {
+        Serial.println("A sensor failed to begin. Please check your wiring!");
+        Serial.println("Halting...");
+        while (1)
+            ;
+    }
+
+    Serial.println("Sensors began.");
+
+    // Configure every sensor: 6 channels per frame, about 50ms each
+    for (uint8_t i = 0; i < myArray.size(); i++)
+    {
+        SfeAS7343ArdI2C *sensor = myArray.getSensor(i);
+
+        if (!sensor || sensor->setAutoSmux(AUTOSMUX_6_CHANNELS) == false ||
+            sensor->setIntegrationTime(50000UL) == false)
+        {
+            Serial.print("Failed to configure sensor ");
+            Serial.println(i);
+            Serial.println("Halting...");
+            while (1)
+                ;
+        }
+    }
+    Serial.println("Sensors configured.");
+
+    // Power on and start the sensors, staggered
+    if (myArray.start() == false)
+    {
+        Serial.println("Failed to start the sensors.");
+        Serial.println("Halting...");
+        while (1)
+            ;
+    }
+    Serial.println("Sensors started.");
+}
+
+void loop()
+{
+    sfe_as7343_frame_t frame;
+    uint8_t index;
+
+    // Reads the next sensor that is done, if any
+    if (myArray.service(frame, index))
+    {
+        Serial.print("Sensor ");
+        Serial.print(index);
+        Serial.print(" @ ");
+        Serial.print(frame.timestamp);
+        Serial.print(":\t");
+
+        for (int channel = 0; channel < 6; channel++)
+        {
+            Serial.print(frame.data[channel]);
+            Serial.print(",");
+        }
+
+        Serial.println();
+    }
+
+    // Print the aggregate frame rate every few seconds
+    static uint32_t lastReport = 0;
+    static uint32_t lastCount = 0;
+
+    if (millis() - lastReport >= 5000)
+    {
+        uint32_t frames = myArray.getFrameCount();
+
+        Serial.print("Aggregate frames/s: ");
+        Serial.println((frames - lastCount) / 5.0);
+
+        lastCount = frames;
+        lastReport = millis();
+    }
+}
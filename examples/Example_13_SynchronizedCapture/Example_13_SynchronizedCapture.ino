@@ -0,0 +1,113 @@
+/*
+  Using the AMS AS7343 Sensor.
+
+  This example shows how to capture a frame on several AS7343 sensors at
+  the same moment, so their spectra can be compared frame by frame. The
+  sensors sit on the channels of a TCA9548A I2C mux (SparkFun Qwiic Mux).
+  arm() gets every sensor ready, trigger() opens all mux channels and
+  starts all sensors with one write, and readCapture() collects the frames
+  once the measurement is done.
+
+  By: SparkFun Electronics
+  Date: 2026/10/14
+  SparkFun code, firmware, and software is released under the MIT License.
+    Please see LICENSE.md for further details.
+
+  Hardware Connections:
+  IoT RedBoard --> Qwiic Mux (0x70)
+  QWIIC --> QWIIC
+  Qwiic Mux channel 0..3 --> AS7343 #0..#3
+
+  Serial.print it out at 115200 baud to serial monitor.
+
+  Feel like supporting our work? Buy a board from SparkFun!
+  https://www.sparkfun.com/products/23220
+*/
+
+#include <SparkFun_AS7343.h>
+#include <SparkFun_AS7343_Array.h>
+
+#define NUM_SENSORS 4 // Sensors on mux channels 0 to NUM_SENSORS - 1
+
+SfeAS7343ArdI2CArray<NUM_SENSORS> myArray;
+
+sfe_as7343_frame_t frames[NUM_SENSORS]; // One frame per sensor, from the same trigger
+
+void setup()
+{
+    Serial.begin(115200);
+    while (!Serial)
+    {
+        delay(100);
+    };
+    Serial.println("AS7343 Example 13 - Synchronized Capture");
+
+    Wire.begin();
+
+    // One sensor per mux channel
+    for (uint8_t channel = 0; channel < NUM_SENSORS; channel++)
+        myArray.addSensor(kTCA9548AAddr, channel);
+
+    // Initialize all sensors and run default setup.
+    if (myArray.begin() == false)
+    {
+        Serial.println("A sensor failed to begin. Please check your wiring!");
+        Serial.println("Halting...");
+        while (1)
+            ;
+    }
+
+    Serial.println("Sensors began.");
+
+    // Configure every sensor the same way: 6 channels per frame, about 50ms each
+    for (uint8_t i = 0; i < myArray.size(); i++)
+    {
+        SfeAS7343ArdI2C *sensor = myArray.getSensor(i);
+
+        if (!sensor || sensor->setAutoSmux(AUTOSMUX_6_CHANNELS) == false ||
+            sensor->setIntegrationTime(50000UL) == false)
+        {
+            Serial.print("Failed to configure sensor ");
+            Serial.println(i);
+            Serial.println("Halting...");
+            while (1)
+                ;
+        }
+    }
+    Serial.println("Sensors configured.");
+}
+
+void loop()
+{
+    // Get every sensor ready, then start them all on the same edge
+    if (myArray.arm() == false || myArray.trigger() == false)
+    {
+        Serial.println("Failed to trigger the sensors.");
+        delay(1000);
+        return;
+    }
+
+    // Collect the frames once the measurement is done
+    while (myArray.readCapture(frames, NUM_SENSORS) == false)
+        ;
+
+    // Print the frames of this trigger, one line per sensor
+    for (uint8_t i = 0; i < NUM_SENSORS; i++)
+    {
+        Serial.print("Sensor ");
+        Serial.print(i);
+        Serial.print(" @ ");
+        Serial.print(frames[i].timestamp);
+        Serial.print(":\t");
+
+        for (int channel = 0; channel < 6; channel++)
+        {
+            Serial.print(frames[i].data[channel]);
+            Serial.print(",");
+        }
+
+        Serial.println();
+    }
+
+    delay(500);
+}
@@ -0,0 +1,138 @@
+/*
+  Using the AMS AS7343 Sensor.
+
+  This example shows how to run the AS7343 duty-cycled for battery powered
+  nodes. The sensor takes one measurement, pulls INT low and goes to sleep
+  (sleep after interrupt) until the MCU has read the data and resumes it.
+  It then idles in low power for the wait time and measures again. Nothing
+  needs the bus in between, so the MCU can sleep until INT wakes it.
+
+  By: SparkFun Electronics
+  Date: 2026/10/14
+  SparkFun code, firmware, and software is released under the MIT License.
+    Please see LICENSE.md for further details.
+
+  Hardware Connections:
+  IoT RedBoard --> AS7343
+  QWIIC --> QWIIC
+  Pin 4 --> INT
+
+  Serial.print it out at 115200 baud to serial monitor.
+
+  Feel like supporting our work? Buy a board from SparkFun!
+  https://www.sparkfun.com/products/23220
+*/
+
+#include <SparkFun_AS7343.h>
+
+SfeAS7343ArdI2C mySensor;
+
+#define INT_HW_READ_PIN 4 // Pin connected to the INT pin of the AS7343
+
+#define WAIT_TIME_MS 10000 // Time between measurements, up to about 11.4s
+
+volatile bool sensorInterrupt = false; // Set by the INT pin ISR
+
+void onSensorInterrupt()
+{
+    sensorInterrupt = true;
+}
+
+void setup()
+{
+    // Set the pin mode for the interrupt pin
+    pinMode(INT_HW_READ_PIN, INPUT); // Set the pin to input, the qwiic bob has a pullup resistor
+
+    Serial.begin(115200);
+    while (!Serial)
+    {
+        delay(100);
+    };
+    Serial.println("AS7343 Example 14 - Duty Cycle");
+
+    Wire.begin();
+
+    // Initialize sensor and run default setup.
+    if (mySensor.begin() == false)
+    {
+        Serial.println("Sensor failed to begin. Please check your wiring!");
+        Serial.println("Halting...");
+        while (1)
+            ;
+    }
+
+    Serial.println("Sensor began.");
+
+    // Power on the device
+    if (mySensor.powerOn() == false)
+    {
+        Serial.println("Failed to power on the device.");
+        Serial.println("Halting...");
+        while (1)
+            ;
+    }
+    Serial.println("Device powered on.");
+
+    // Measure all 18 channels
+    if (mySensor.setAutoSmux(AUTOSMUX_18_CHANNELS) == false)
+    {
+        Serial.println("Failed to set AutoSmux.");
+        Serial.println("Halting...");
+        while (1)
+            ;
+    }
+    Serial.println("AutoSmux set to 18 channels.");
+
+    // One measurement, INT, then sleep until resumed, then wait WAIT_TIME_MS in low power
+    if (mySensor.setDutyCycle(WAIT_TIME_MS) == false)
+    {
+        Serial.println("Failed to set the duty cycle.");
+        Serial.println("Halting...");
+        while (1)
+            ;
+    }
+    Serial.println("Duty cycle set.");
+
+    attachInterrupt(digitalPinToInterrupt(INT_HW_READ_PIN), onSensorInterrupt, FALLING);
+
+    // Enable Spectral Measurement, the first measurement starts now
+    if (mySensor.enableSpectralMeasurement() == false)
+    {
+        Serial.println("Failed to enable spectral measurement.");
+        Serial.println("Halting...");
+        while (1)
+            ;
+    }
+    Serial.println("Spectral measurement enabled.");
+}
+
+void loop()
+{
+    // Nothing to do until the sensor has a measurement. This is where a battery
+    // powered node would put the MCU into its deepest sleep that can still wake
+    // on the INT pin (see your board's low power library).
+    if (!sensorInterrupt)
+        return;
+
+    sensorInterrupt = false;
+
+    // The sensor is asleep now, with the data of its last measurement
+    sfe_as7343_frame_t frame;
+
+    if (mySensor.readFrame(frame) && frame.valid)
+    {
+        for (int channel = 0; channel < ksfAS7343NumChannels; channel++)
+        {
+            Serial.print(frame.data[channel]);
+            Serial.print(",");
+        }
+
+        Serial.println();
+    }
+
+    // Clear the interrupt and wake the sensor, it measures again after the wait time
+    if (mySensor.resumeAfterInterrupt() == false)
+        Serial.println("Failed to resume the sensor.");
+
+    Serial.flush();
+}
@@ -0,0 +1,106 @@
+/*
+  Using the AMS AS7343 Sensor.
+
+  This example shows the fast start sequence for nodes that wake up, take
+  one reading and go back to sleep. beginFast() checks the device ID,
+  applies the whole configuration and powers the sensor on in one batch,
+  then tells how long the first measurement takes - so there is no need
+  for fixed delays. The time from wake up to data is printed each round.
+
+  By: SparkFun Electronics
+  Date: 2026/10/14
+  SparkFun code, firmware, and software is released under the MIT License.
+    Please see LICENSE.md for further details.
+
+  Hardware Connections:
+  IoT RedBoard --> AS7343
+  QWIIC --> QWIIC
+
+  Serial.print it out at 115200 baud to serial monitor.
+
+  Feel like supporting our work? Buy a board from SparkFun!
+  https://www.sparkfun.com/products/23220
+*/
+
+#include <SparkFun_AS7343.h>
+
+SfeAS7343ArdI2C mySensor;
+
+sfe_as7343_config_t myConfig; // The configuration applied on every wake up
+
+void setup()
+{
+    Serial.begin(115200);
+    while (!Serial)
+    {
+        delay(100);
+    };
+    Serial.println("AS7343 Example 15 - Fast Start");
+
+    Wire.begin();
+
+    // Start from the power-on defaults, no I2C traffic needed
+    SfeAS7343ArdI2C::getDefaultConfig(myConfig);
+
+    // 6 channels, about 20ms integration ((29 + 1) x (239 + 1) x 2.78us), 64x gain
+    myConfig.autoSmux = AUTOSMUX_6_CHANNELS;
+    myConfig.atime = 29;
+    myConfig.astep = 239;
+    myConfig.again = AGAIN_64;
+
+    // Start measuring as soon as the configuration is in
+    myConfig.spectralMeasurement = true;
+}
+
+void loop()
+{
+    uint32_t wakeUs = micros();
+    uint32_t firstDataUs;
+
+    // Check the ID, configure, power on and start measuring
+    if (mySensor.beginFast(myConfig, firstDataUs) == false)
+    {
+        Serial.println("Sensor failed to begin. Please check your wiring!");
+        delay(1000);
+        return;
+    }
+
+    // The first data is ready firstDataUs from now, the MCU could sleep here
+    delay(firstDataUs / 1000 + 1);
+
+    sfe_as7343_frame_t frame;
+
+    bool readOk;
+
+    // The first measurement, if it isn't quite done yet try again
+    do
+    {
+        readOk = mySensor.readFrame(frame);
+    } while (readOk && !frame.valid);
+
+    uint32_t elapsedUs = micros() - wakeUs;
+
+    // Back to sleep
+    mySensor.powerOff();
+
+    if (!readOk)
+    {
+        Serial.println("Failed to read spectral data.");
+        delay(2000);
+        return;
+    }
+
+    Serial.print("Wake to data: ");
+    Serial.print(elapsedUs);
+    Serial.print("us\t");
+
+    for (int channel = 0; channel < 6; channel++)
+    {
+        Serial.print(frame.data[channel]);
+        Serial.print(",");
+    }
+
+    Serial.println();
+
+    delay(2000);
+}
@@ -0,0 +1,126 @@
+/*
+  Using the AMS AS7343 Sensor.
+
+  This example shows how to measure the flicker of any light source, not
+  just the 100Hz and 120Hz the on-chip flicker detection reports. The raw
+  flicker detection samples stream into the FIFO at about 2kHz, and the
+  flicker analyzer finds the dominant frequency and the modulation depth
+  (percent flicker) in blocks of 512 samples. Point the sensor at a PWM
+  dimmed LED or a fluorescent lamp.
+
+  By: SparkFun Electronics
+  Date: 2026/10/14
+  SparkFun code, firmware, and software is released under the MIT License.
+    Please see LICENSE.md for further details.
+
+  Hardware Connections:
+  IoT RedBoard --> AS7343
+  QWIIC --> QWIIC
+
+  Serial.print it out at 115200 baud to serial monitor.
+
+  Feel like supporting our work? Buy a board from SparkFun!
+  https://www.sparkfun.com/products/23220
+*/
+
+#include <SparkFun_AS7343.h>
+
+SfeAS7343ArdI2C mySensor;
+
+sfDevAS7343FlickerAnalyzer myAnalyzer;
+
+void setup()
+{
+    Serial.begin(115200);
+    while (!Serial)
+    {
+        delay(100);
+    };
+    Serial.println("AS7343 Example 16 - Flicker Stream");
+
+    Wire.begin();
+
+    // Initialize sensor and run default setup.
+    if (mySensor.begin() == false)
+    {
+        Serial.println("Sensor failed to begin. Please check your wiring!");
+        Serial.println("Halting...");
+        while (1)
+            ;
+    }
+
+    Serial.println("Sensor began.");
+
+    // 180 x 2.78us = 500us per sample, about 2kHz. Streamed samples are 8-bit,
+    // so the time has to stay below 256 steps.
+    // A lower gain keeps bright light from saturating the samples.
+    if (mySensor.setFlickerTime(180) == false || mySensor.setFlickerGain(FD_GAIN_16) == false)
+    {
+        Serial.println("Failed to set the flicker detection time and gain.");
+        Serial.println("Halting...");
+        while (1)
+            ;
+    }
+
+    // 512 sample blocks (about 4Hz resolution), looking for 50Hz to 900Hz
+    if (myAnalyzer.begin(mySensor.getFlickerSamplePeriodNs(), 512, 50, 900) == false)
+    {
+        Serial.println("Failed to set up the flicker analyzer.");
+        Serial.println("Halting...");
+        while (1)
+            ;
+    }
+
+    // Stream the flicker samples into the FIFO
+    if (mySensor.enableFlickerStream() == false)
+    {
+        Serial.println("Failed to start the flicker stream.");
+        Serial.println("Halting...");
+        while (1)
+            ;
+    }
+}
+
+void loop()
+{
+    // The FIFO holds 256 samples (128ms), so keep draining it without delays
+    if (mySensor.getFifoOverflowStatus())
+    {
+        // Samples were lost, start over with a clean FIFO and block
+        mySensor.clearFifo();
+        myAnalyzer.reset();
+        Serial.println("FIFO overflow, samples lost.");
+        return;
+    }
+
+    uint8_t samples[32];
+    size_t numSamples = mySensor.readFlickerSamples(samples, sizeof(samples));
+
+    if (myAnalyzer.addSamples(samples, numSamples) == false)
+        return;
+
+    // A block is complete
+    sfe_as7343_flicker_result_t result;
+    myAnalyzer.getResult(result);
+
+    if (result.detected)
+    {
+        Serial.print("Flicker: ");
+        Serial.print(result.frequency, 1);
+        Serial.print("Hz\tModulation: ");
+        Serial.print(result.modulation);
+        Serial.print("%");
+    }
+    else
+    {
+        Serial.print("No flicker");
+    }
+
+    Serial.print("\tMean: ");
+    Serial.print(result.mean);
+
+    if (result.saturated)
+        Serial.print("\tSaturated, lower the gain");
+
+    Serial.println();
+}
@@ -0,0 +1,162 @@
+/*
+  Using the AMS AS7343 Sensor.
+
+  This example shows how to capture the dark offsets of every channel, and
+  let readFrame() subtract them. The offsets make up for the offset drift
+  between auto zeros, so the sensor can keep its power-on schedule of one
+  auto zero before the first measurement. Auto zeroing before every
+  measurement (setAutoZeroInterval(1)) would cost about 15ms each time.
+
+  Cover the sensor when asked, the dark frames of three gains are captured
+  and printed as a blob that can be stored in EEPROM or flash and loaded
+  with load() on the next start. Then uncover the sensor to see the
+  corrected readings.
+
+  By: SparkFun Electronics
+  Date: 2026/10/14
+  SparkFun code, firmware, and software is released under the MIT License.
+    Please see LICENSE.md for further details.
+
+  Hardware Connections:
+  IoT RedBoard --> AS7343
+  QWIIC --> QWIIC
+
+  Serial.print it out at 115200 baud to serial monitor.
+
+  Feel like supporting our work? Buy a board from SparkFun!
+  https://www.sparkfun.com/products/23220
+*/
+
+#include <SparkFun_AS7343.h>
+
+SfeAS7343ArdI2C mySensor;
+
+sfDevAS7343DarkOffsets myOffsets;
+
+const sfe_as7343_again_t kGains[] = {AGAIN_16, AGAIN_64, AGAIN_256};
+
+// Read frames until one is complete
+bool readCompleteFrame(sfe_as7343_frame_t &frame)
+{
+    do
+    {
+        if (mySensor.readFrame(frame) == false)
+            return false;
+    } while (!frame.valid);
+
+    // Clear the status for the next measurement
+    mySensor.clearStatusReg(frame.status);
+
+    return true;
+}
+
+void setup()
+{
+    Serial.begin(115200);
+    while (!Serial)
+    {
+        delay(100);
+    };
+    Serial.println("AS7343 Example 17 - Dark Calibration");
+
+    Wire.begin();
+
+    // Initialize sensor and run default setup.
+    if (mySensor.begin() == false)
+    {
+        Serial.println("Sensor failed to begin. Please check your wiring!");
+        Serial.println("Halting...");
+        while (1)
+            ;
+    }
+
+    Serial.println("Sensor began.");
+
+    // Auto zero once, before the first measurement, the offsets do the rest. This is the power-on setting,
+    // it is set here in case the sensor was left at another interval.
+    if (mySensor.powerOn() == false || mySensor.setAutoSmux(AUTOSMUX_18_CHANNELS) == false ||
+        mySensor.setAutoZeroInterval(ksfAS7343AutoZeroFirstOnly) == false || mySensor.ledOff() == false ||
+        mySensor.enableSpectralMeasurement() == false)
+    {
+        Serial.println("Failed to set up the sensor.");
+        Serial.println("Halting...");
+        while (1)
+            ;
+    }
+
+    Serial.println("Cover the sensor, then send any character.");
+    while (!Serial.available())
+        delay(10);
+    while (Serial.available())
+        Serial.read();
+
+    // Average 8 dark frames for each gain
+    for (uint8_t i = 0; i < sizeof(kGains) / sizeof(kGains[0]); i++)
+    {
+        if (myOffsets.beginCapture(&mySensor, kGains[i], 8) == false)
+        {
+            Serial.println("Failed to start the capture.");
+            Serial.println("Halting...");
+            while (1)
+                ;
+        }
+
+        sfe_as7343_frame_t frame;
+
+        // Frames of the old gain are skipped by the capture
+        while (myOffsets.isCapturing())
+        {
+            if (readCompleteFrame(frame))
+                myOffsets.captureFrame(frame);
+        }
+
+        Serial.print("Captured gain setting ");
+        Serial.println(kGains[i]);
+    }
+
+    // The blob to store, load() takes it back
+    uint8_t blob[ksfAS7343DarkMaxBytes];
+    size_t blobSize = myOffsets.save(blob, sizeof(blob));
+
+    Serial.print("Dark offset blob (");
+    Serial.print(blobSize);
+    Serial.println(" bytes):");
+    for (size_t i = 0; i < blobSize; i++)
+    {
+        if (blob[i] < 0x10)
+            Serial.print("0");
+        Serial.print(blob[i], HEX);
+        Serial.print((i % 16) == 15 ? "\n" : " ");
+    }
+    Serial.println();
+
+    // readFrame() subtracts the offsets from now on
+    mySensor.setDarkOffsets(&myOffsets);
+    mySensor.setAgain(AGAIN_64);
+
+    Serial.println("Uncover the sensor.");
+}
+
+void loop()
+{
+    sfe_as7343_frame_t frame;
+
+    if (readCompleteFrame(frame) == false)
+    {
+        Serial.println("Failed to read spectral data.");
+        delay(1000);
+        return;
+    }
+
+    Serial.print(frame.darkCorrected ? "Corrected: " : "Raw: ");
+
+    for (int channel = 0; channel < ksfAS7343NumChannels; channel++)
+    {
+        Serial.print(frame.data[channel]);
+        Serial.print(",");
+    }
+
+    Serial.println();
+
+    delay(500);
+}
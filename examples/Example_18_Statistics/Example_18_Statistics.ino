@@ -0,0 +1,104 @@
+/*
+  Using the AMS AS7343 Sensor.
+
+  This example shows how to summarize frames on the board instead of
+  sending every one of them. The accumulator keeps the mean, minimum,
+  maximum and variance of all 18 channels over a window of 50 frames, and
+  only the summary is printed - one line per 50 measurements.
+
+  By: SparkFun Electronics
+  Date: 2026/10/14
+  SparkFun code, firmware, and software is released under the MIT License.
+    Please see LICENSE.md for further details.
+
+  Hardware Connections:
+  IoT RedBoard --> AS7343
+  QWIIC --> QWIIC
+
+  Serial.print it out at 115200 baud to serial monitor.
+
+  Feel like supporting our work? Buy a board from SparkFun!
+  https://www.sparkfun.com/products/23220
+*/
+
+#include <SparkFun_AS7343.h>
+
+SfeAS7343ArdI2C mySensor;
+
+sfDevAS7343Accumulator myAccumulator;
+
+void setup()
+{
+    Serial.begin(115200);
+    while (!Serial)
+    {
+        delay(100);
+    };
+    Serial.println("AS7343 Example 18 - Statistics");
+
+    Wire.begin();
+
+    // Initialize sensor and run default setup.
+    if (mySensor.begin() == false)
+    {
+        Serial.println("Sensor failed to begin. Please check your wiring!");
+        Serial.println("Halting...");
+        while (1)
+            ;
+    }
+
+    Serial.println("Sensor began.");
+
+    // Measure all 18 channels, back to back
+    if (mySensor.powerOn() == false || mySensor.setAutoSmux(AUTOSMUX_18_CHANNELS) == false ||
+        mySensor.enableSpectralMeasurement() == false)
+    {
+        Serial.println("Failed to set up the sensor.");
+        Serial.println("Halting...");
+        while (1)
+            ;
+    }
+
+    // One summary per 50 frames, box car mean
+    myAccumulator.begin(50);
+}
+
+void loop()
+{
+    sfe_as7343_frame_t frame;
+
+    // Only complete frames are accumulated
+    if (mySensor.readFrame(frame) == false || !frame.valid)
+        return;
+
+    // Clear the status for the next measurement
+    mySensor.clearStatusReg(frame.status);
+
+    if (myAccumulator.addFrame(frame) == false)
+        return;
+
+    sfe_as7343_summary_t summary;
+    myAccumulator.getSummary(summary);
+
+    Serial.print(summary.timestamp);
+    Serial.print("us, ");
+    Serial.print(summary.frames);
+    Serial.print(" frames");
+    if (summary.saturated)
+        Serial.print(" (saturated)");
+
+    // Mean / min / max / standard deviation of each channel
+    for (int channel = 0; channel < ksfAS7343NumChannels; channel++)
+    {
+        Serial.print("\t");
+        Serial.print(summary.mean[channel]);
+        Serial.print("/");
+        Serial.print(summary.min[channel]);
+        Serial.print("/");
+        Serial.print(summary.max[channel]);
+        Serial.print("/");
+        Serial.print(sqrt(summary.variance[channel]), 1);
+    }
+
+    Serial.println();
+}
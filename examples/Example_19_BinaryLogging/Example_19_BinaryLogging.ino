@@ -0,0 +1,84 @@
+/*
+  Using the AMS AS7343 Sensor.
+
+  This example shows how to log frames as compact binary records instead of
+  text. Each 18 channel frame becomes a record of about 30 to 45 bytes with
+  the sequence number, timestamp, gain, integration time, SMUX mode and
+  saturation flags, so the serial port keeps up with short integration times.
+
+  The output is binary - capture it to a file, then turn it into CSV on the
+  computer with the decoder in the tools folder of the library:
+
+    python3 tools/as7343_decode.py capture.bin > capture.csv
+
+  By: SparkFun Electronics
+  Date: 2026/10/14
+  SparkFun code, firmware, and software is released under the MIT License.
+    Please see LICENSE.md for further details.
+
+  Hardware Connections:
+  IoT RedBoard --> AS7343
+  QWIIC --> QWIIC
+
+  Capture the serial port at 115200 baud to a file.
+
+  Feel like supporting our work? Buy a board from SparkFun!
+  https://www.sparkfun.com/products/23220
+*/
+
+#include <SparkFun_AS7343.h>
+
+SfeAS7343ArdI2C mySensor;
+
+sfDevAS7343RecordEncoder myEncoder;
+
+void setup()
+{
+    Serial.begin(115200);
+    while (!Serial)
+    {
+        delay(100);
+    };
+
+    Wire.begin();
+
+    // Text messages stay out of the log unless something goes wrong, the decoder skips them anyway.
+    if (mySensor.begin() == false)
+    {
+        Serial.println("Sensor failed to begin. Please check your wiring!");
+        Serial.println("Halting...");
+        while (1)
+            ;
+    }
+
+    // Measure all 18 channels, back to back
+    if (mySensor.powerOn() == false || mySensor.setAutoSmux(AUTOSMUX_18_CHANNELS) == false ||
+        mySensor.enableSpectralMeasurement() == false)
+    {
+        Serial.println("Failed to set up the sensor.");
+        Serial.println("Halting...");
+        while (1)
+            ;
+    }
+
+    // A key record every 16 records, the rest only hold the changes
+    myEncoder.begin(&mySensor, 16);
+}
+
+void loop()
+{
+    sfe_as7343_frame_t frame;
+
+    // Only complete frames are logged
+    if (mySensor.readFrame(frame) == false || !frame.valid)
+        return;
+
+    // Clear the status for the next measurement
+    mySensor.clearStatusReg(frame.status);
+
+    uint8_t record[ksfAS7343RecordMaxBytes];
+    size_t length = myEncoder.encode(frame, record, sizeof(record));
+
+    if (length > 0)
+        Serial.write(record, length);
+}
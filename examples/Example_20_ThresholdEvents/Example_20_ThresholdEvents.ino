@@ -0,0 +1,125 @@
+/*
+  Using the AMS AS7343 Sensor.
+
+  This example shows how to only hear from the sensor when the light changes.
+  The hardware threshold watches the VIS channel and asserts INT when it moves
+  more than 5 percent. Only then is a frame read, and checked against the
+  thresholds of the channels we care about. Frames that don't move a channel
+  across its thresholds are dropped, so steady lighting prints nothing.
+
+  By: SparkFun Electronics
+  Date: 2026/10/14
+  SparkFun code, firmware, and software is released under the MIT License.
+    Please see LICENSE.md for further details.
+
+  Hardware Connections:
+  IoT RedBoard --> AS7343
+  QWIIC --> QWIIC
+  4 --> INT
+
+  Serial.print it out at 115200 baud to serial monitor.
+
+  Feel like supporting our work? Buy a board from SparkFun!
+  https://www.sparkfun.com/products/23220
+*/
+
+#include <SparkFun_AS7343.h>
+
+SfeAS7343ArdI2C mySensor;
+
+sfDevAS7343EventDetector myDetector;
+
+#define INT_HW_READ_PIN 4 // Pin to read the interrupt pin from the AS7343
+
+void setup()
+{
+    // Set the pin mode for the interrupt pin
+    pinMode(INT_HW_READ_PIN, INPUT); // Set the pin to input, the qwiic bob has a pullup resistor
+
+    Serial.begin(115200);
+    while (!Serial)
+    {
+        delay(100);
+    };
+    Serial.println("AS7343 Example 20 - Threshold Events");
+
+    Wire.begin();
+
+    // Initialize sensor and run default setup.
+    if (mySensor.begin() == false)
+    {
+        Serial.println("Sensor failed to begin. Please check your wiring!");
+        Serial.println("Halting...");
+        while (1)
+            ;
+    }
+
+    Serial.println("Sensor began.");
+
+    // Measure all 18 channels every ~100ms. The wait time keeps the sensor idle in between.
+    if (mySensor.powerOn() == false || mySensor.setAutoSmux(AUTOSMUX_18_CHANNELS) == false ||
+        mySensor.enableWaitTime() == false || mySensor.setWaitTimeMs(100) == false)
+    {
+        Serial.println("Failed to set up the sensor.");
+        Serial.println("Halting...");
+        while (1)
+            ;
+    }
+
+    // Gate on a 5 percent change of VIS, for 2 measurements in a row
+    if (myDetector.begin(&mySensor, 5, 2) == false)
+    {
+        Serial.println("Failed to set up the event detector.");
+        Serial.println("Halting...");
+        while (1)
+            ;
+    }
+
+    // Red and NIR leave their bands, with 50 counts of hysteresis
+    myDetector.setThreshold(CH_RED_F7_690NM, 200, 4000, 50);
+    myDetector.setThreshold(CH_NIR_855NM, 200, 4000, 50);
+
+    if (mySensor.enableSpectralMeasurement() == false)
+    {
+        Serial.println("Failed to enable spectral measurement.");
+        Serial.println("Halting...");
+        while (1)
+            ;
+    }
+
+    Serial.println("Waiting for events.");
+}
+
+void loop()
+{
+    // INT is active low. Until it asserts there is nothing to read - an MCU could sleep here.
+    if (digitalRead(INT_HW_READ_PIN) == HIGH)
+        return;
+
+    sfe_as7343_frame_t frame;
+
+    if (myDetector.service(frame) == false)
+        return;
+
+    Serial.print(millis());
+    Serial.print("ms");
+
+    const sfe_as7343_channel_t channels[] = {CH_RED_F7_690NM, CH_NIR_855NM};
+    const char *names[] = {"Red", "NIR"};
+    const char *states[] = {"inside", "below", "above"};
+
+    for (int i = 0; i < 2; i++)
+    {
+        Serial.print("\t");
+        Serial.print(names[i]);
+        Serial.print(": ");
+        Serial.print(frame.data[channels[i]]);
+        Serial.print(" ");
+        Serial.print(states[myDetector.getState(channels[i])]);
+
+        if (myDetector.getChangedMask() & (1UL << channels[i]))
+            Serial.print(" (changed)");
+    }
+
+    Serial.println();
+}
@@ -0,0 +1,187 @@
+/*
+  Using the AMS AS7343 Sensor.
+
+  This example benchmarks the bus cost of the ways to get data from the
+  sensor: a plain data read, the fused frame read (status and data in one
+  burst), and draining the FIFO. For each one, at 100kHz, 400kHz and 1MHz,
+  it prints the I2C transactions and bytes per frame, the bus time the
+  I2C clock allows for them, and the time the calls actually took.
+
+  The counts come from the bus instrumentation of the library, which is off
+  by default. Turn it on by uncommenting
+    #define SFE_AS7343_STATS
+  at the top of src/sfTk/sfDevAS7343.h in the library (or by defining it for
+  the whole build), then build this example.
+
+  Not every board runs its I2C at 1MHz, the times show what it really does.
+
+  This example is an optional check on real hardware. The reference numbers,
+  including the round-robin reads of several sensors behind a mux, come from
+  the host benchmark in extras/host_bench, which needs no board.
+
+  By: SparkFun Electronics
+  Date: 2026/10/14
+  SparkFun code, firmware, and software is released under the MIT License.
+    Please see LICENSE.md for further details.
+
+  Hardware Connections:
+  IoT RedBoard --> AS7343
+  QWIIC --> QWIIC
+
+  Serial.print it out at 115200 baud to serial monitor.
+
+  Feel like supporting our work? Buy a board from SparkFun!
+  https://www.sparkfun.com/products/23220
+*/
+
+#include <SparkFun_AS7343.h>
+
+SfeAS7343ArdI2C mySensor;
+
+#define NUM_FRAMES 20   // Frames measured per mode and clock
+#define FIFO_CHANNELS 6 // Channels mapped into the FIFO in the FIFO mode
+
+uint16_t myFifoData[ksfAS7343FifoMaxEntries]; // Array to hold the drained FIFO entries
+
+const uint32_t clocks[] = {100000, 400000, 1000000};
+
+// Add up the statistics of all operations - a frame read can also change the gain, or read a register.
+void totalStats(const sfe_as7343_stats_t &stats, uint32_t &transactions, uint32_t &bytes, uint32_t &time)
+{
+    transactions = bytes = time = 0;
+
+    for (int op = 0; op < STATS_OP_NUM; op++)
+    {
+        transactions += stats.op[op].reads + stats.op[op].writes;
+        bytes += stats.op[op].bytes;
+
+        // Inner calls are part of the outer call's time, only count the calls the sketch makes
+        if (op == STATS_OP_READ_DATA || op == STATS_OP_READ_FRAME || op == STATS_OP_READ_FIFO)
+            time += stats.op[op].totalTime;
+    }
+}
+
+// Bus time the clock allows: 9 clocks per byte, plus the address and register bytes and the
+// start / stop conditions. Reads send the register first, then restart and address again.
+uint32_t modeledBusUs(const sfe_as7343_stats_t &stats, uint32_t clockHz)
+{
+    uint32_t bits = 0;
+
+    for (int op = 0; op < STATS_OP_NUM; op++)
+        bits += stats.op[op].bytes * 9 + stats.op[op].reads * (3 * 9 + 3) + stats.op[op].writes * (2 * 9 + 2);
+
+    return (uint32_t)((uint64_t)bits * 1000000 / clockHz);
+}
+
+void printResult(const char *mode, uint32_t clockHz, uint32_t frames)
+{
+    sfe_as7343_stats_t stats;
+    mySensor.getStats(stats);
+
+    uint32_t transactions, bytes, time;
+    totalStats(stats, transactions, bytes, time);
+
+    if (frames == 0)
+        frames = 1;
+
+    Serial.print(mode);
+    Serial.print("\t");
+    Serial.print(clockHz / 1000);
+    Serial.print("kHz\t");
+    Serial.print((float)transactions / frames, 2);
+    Serial.print("\t\t");
+    Serial.print((float)bytes / frames, 1);
+    Serial.print("\t");
+    Serial.print(modeledBusUs(stats, clockHz) / frames);
+    Serial.print("\t\t");
+    Serial.println(time / frames);
+}
+
+void setup()
+{
+    Serial.begin(115200);
+    while (!Serial)
+    {
+        delay(100);
+    };
+    Serial.println("AS7343 Example 21 - Bus Benchmark");
+
+    Wire.begin();
+
+    // Initialize sensor and run default setup.
+    if (mySensor.begin() == false)
+    {
+        Serial.println("Sensor failed to begin. Please check your wiring!");
+        Serial.println("Halting...");
+        while (1)
+            ;
+    }
+
+    Serial.println("Sensor began.");
+
+    sfe_as7343_stats_t stats;
+    if (mySensor.getStats(stats) == false)
+    {
+        Serial.println("The bus instrumentation is not built in, see the comment at the top of this example.");
+        Serial.println("Halting...");
+        while (1)
+            ;
+    }
+
+    // 6 channels, 2.78ms integration time, all 6 channels into the FIFO
+    if (mySensor.powerOn() == false || mySensor.setAutoSmux(AUTOSMUX_6_CHANNELS) == false ||
+        mySensor.setIntegrationTime(0, 999) == false || mySensor.setFifoMap(0x3F) == false ||
+        mySensor.enableSpectralMeasurement() == false)
+    {
+        Serial.println("Failed to set up the sensor.");
+        Serial.println("Halting...");
+        while (1)
+            ;
+    }
+
+    // One measurement, with the SMUX overhead, fits in a frame period
+    uint32_t periodMs = mySensor.getFramePeriodUs() / 1000 + 2;
+
+    Serial.println();
+    Serial.println("Mode\tClock\tTransactions\tBytes\tModeled us\tMeasured us (per frame)");
+
+    for (int c = 0; c < 3; c++)
+    {
+        Wire.setClock(clocks[c]);
+
+        // Plain data read: just the data registers
+        mySensor.resetStats();
+        for (int i = 0; i < NUM_FRAMES; i++)
+        {
+            delay(periodMs);
+            mySensor.readSpectraDataFromSensor();
+        }
+        printResult("Data", clocks[c], NUM_FRAMES);
+
+        // Fused frame read: status and data in one burst, then clear the status
+        sfe_as7343_frame_t frame;
+        mySensor.resetStats();
+        for (int i = 0; i < NUM_FRAMES; i++)
+        {
+            delay(periodMs);
+            if (mySensor.readFrame(frame))
+                mySensor.clearStatusReg(frame.status);
+        }
+        printResult("Frame", clocks[c], NUM_FRAMES);
+
+        // FIFO: let frames pile up, then drain them in one burst
+        mySensor.clearFifo();
+        delay(periodMs * 8);
+        mySensor.resetStats();
+        uint32_t frames = mySensor.readFifo(myFifoData, ksfAS7343FifoMaxEntries) / FIFO_CHANNELS;
+        printResult("FIFO", clocks[c], frames);
+    }
+
+    // Back to the standard clock
+    Wire.setClock(100000);
+}
+
+void loop()
+{
+    // Nothing to do here, the benchmark runs once in setup()
+}
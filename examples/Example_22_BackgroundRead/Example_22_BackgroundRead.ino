@@ -0,0 +1,140 @@
+/*
+  Using the AMS AS7343 Sensor.
+
+  This example shows how to drain the FIFO with startFifoRead(), and get told
+  by the read callback when it is done.
+
+  Plain Wire has no background transfers, so here startFifoRead() reads the
+  FIFO before it returns. On a board with an asynchronous (DMA or interrupt
+  driven) I2C implementation, wrap it in an sfDevAS7343AsyncBus and hand it to
+  setAsyncBus(): startFifoRead() then returns right after submitting the
+  burst, and the same loop code keeps running while the bytes come in.
+  The library ships no such bus for a board yet. SimAsyncI2CBus in
+  extras/host_bench implements the interface on a simulated bus, and the host
+  benchmark runs this read path with it.
+
+  By: SparkFun Electronics
+  Date: 2026/10/14
+  SparkFun code, firmware, and software is released under the MIT License.
+    Please see LICENSE.md for further details.
+
+  Hardware Connections:
+  IoT RedBoard --> AS7343
+  QWIIC --> QWIIC
+
+  Serial.print it out at 115200 baud to serial monitor.
+
+  Feel like supporting our work? Buy a board from SparkFun!
+  https://www.sparkfun.com/products/23220
+*/
+
+#include <SparkFun_AS7343.h>
+
+SfeAS7343ArdI2C mySensor;
+
+#define FIFO_CHANNELS 6 // Channels mapped into the FIFO
+
+uint16_t myFifoData[ksfAS7343FifoMaxEntries]; // Array to hold the FIFO entries, written in the background
+
+volatile bool readDone = false; // Set by the read callback
+unsigned long lastStart = 0;    // Time the last read was started
+uint32_t idleLoops = 0;         // Loops run while the read was in flight
+
+// Called when the read finishes, with a background bus maybe from an interrupt or another task, keep it short.
+void onReadDone(sfDevAS7343 *, sfe_as7343_read_state_t)
+{
+    readDone = true;
+}
+
+void setup()
+{
+    Serial.begin(115200);
+    while (!Serial)
+    {
+        delay(100);
+    };
+    Serial.println("AS7343 Example 22 - Background Read");
+
+    Wire.begin();
+
+    // Initialize sensor and run default setup.
+    if (mySensor.begin() == false)
+    {
+        Serial.println("Sensor failed to begin. Please check your wiring!");
+        Serial.println("Halting...");
+        while (1)
+            ;
+    }
+
+    Serial.println("Sensor began.");
+
+    mySensor.setReadCallback(onReadDone);
+
+    // 6 channels every ~50ms, all of them into the FIFO
+    if (mySensor.powerOn() == false || mySensor.setAutoSmux(AUTOSMUX_6_CHANNELS) == false ||
+        mySensor.setIntegrationTime(29, 599) == false || mySensor.setFifoMap(0x3F) == false ||
+        mySensor.enableSpectralMeasurement() == false)
+    {
+        Serial.println("Failed to set up the sensor.");
+        Serial.println("Halting...");
+        while (1)
+            ;
+    }
+
+    // Let a few measurements pile up first
+    lastStart = millis();
+}
+
+void loop()
+{
+    // Buses that don't report finished reads are checked here, the callback then runs from poll()
+    mySensor.poll();
+
+    // Drain the FIFO every 500ms, unless a read is still in flight
+    if (millis() - lastStart >= 500 && mySensor.poll() != READ_STATE_BUSY)
+    {
+        lastStart = millis();
+        idleLoops = 0;
+
+        if (mySensor.startFifoRead(myFifoData, ksfAS7343FifoMaxEntries) == false)
+            Serial.println("Failed to start the read.");
+    }
+
+    // Print the entries once the callback reported the read
+    if (readDone)
+    {
+        readDone = false;
+
+        if (mySensor.poll() == READ_STATE_COMPLETE)
+        {
+            size_t numEntries = mySensor.getFifoReadCount();
+
+            Serial.print(numEntries / FIFO_CHANNELS);
+            Serial.print(" measurements, ");
+            Serial.print(idleLoops);
+            Serial.print(" loops while reading.");
+
+            // The newest whole measurement
+            if (numEntries >= FIFO_CHANNELS)
+            {
+                size_t first = (numEntries / FIFO_CHANNELS - 1) * FIFO_CHANNELS;
+
+                Serial.print(" Last:");
+                for (size_t i = 0; i < FIFO_CHANNELS; i++)
+                {
+                    Serial.print(" ");
+                    Serial.print(myFifoData[first + i]);
+                }
+            }
+
+            Serial.println();
+        }
+        else
+        {
+            Serial.println("The read failed.");
+        }
+    }
+
+    // Work that goes on while the bytes come in
+    idleLoops++;
+}
@@ -0,0 +1,111 @@
+/*
+  Using the AMS AS7343 Sensor.
+
+  This example shows how to let the library pick the measurement settings.
+  Given a frame rate (10 frames per second) and the lowest SNR index to accept
+  (30), the scheduler chooses the SMUX mode (6, 12 or 18 channels), the
+  integration time, the gain and the wait time, and re-tunes them as the light
+  changes. In bright light all 18 channels are measured. As it gets darker,
+  the scheduler gives up channels for longer integrations, so the rate and SNR
+  hold. Cover the sensor and uncover it to watch it switch.
+
+  The SNR index is sqrt(counts / gain) of the brightest channel. It follows
+  the shot noise limited SNR up to a constant factor, it is not calibrated.
+
+  By: SparkFun Electronics
+  Date: 2026/10/14
+  SparkFun code, firmware, and software is released under the MIT License.
+    Please see LICENSE.md for further details.
+
+  Hardware Connections:
+  IoT RedBoard --> AS7343
+  QWIIC --> QWIIC
+
+  Serial.print it out at 115200 baud to serial monitor.
+
+  Feel like supporting our work? Buy a board from SparkFun!
+  https://www.sparkfun.com/products/23220
+*/
+
+#include <SparkFun_AS7343.h>
+
+SfeAS7343ArdI2C mySensor;
+
+sfDevAS7343Scheduler myScheduler;
+
+#define TARGET_FPS 10 // Frames per second
+#define MIN_SNR 30    // Lowest SNR index of the brightest channel
+
+void setup()
+{
+    Serial.begin(115200);
+    while (!Serial)
+    {
+        delay(100);
+    };
+    Serial.println("AS7343 Example 23 - Adaptive Scheduler");
+
+    Wire.begin();
+
+    // Initialize sensor and run default setup.
+    if (mySensor.begin() == false)
+    {
+        Serial.println("Sensor failed to begin. Please check your wiring!");
+        Serial.println("Halting...");
+        while (1)
+            ;
+    }
+
+    Serial.println("Sensor began.");
+
+    if (mySensor.powerOn() == false)
+    {
+        Serial.println("Failed to power on the device.");
+        Serial.println("Halting...");
+        while (1)
+            ;
+    }
+
+    // The scheduler takes it from here, and starts the measurement
+    if (myScheduler.begin(&mySensor, TARGET_FPS, MIN_SNR) == false)
+    {
+        Serial.println("Failed to set up the scheduler.");
+        Serial.println("Halting...");
+        while (1)
+            ;
+    }
+
+    Serial.println("Channels\tGain\tIntegration us\tPeriod us\tSNR index\tSaturated %");
+}
+
+void loop()
+{
+    sfe_as7343_frame_t frame;
+
+    if (mySensor.readFrame(frame) == false || !frame.valid)
+        return;
+
+    // Clear the status for the next measurement
+    mySensor.clearStatusReg(frame.status);
+
+    uint8_t channels = myScheduler.getChannelCount();
+
+    // Re-tune for the next frames, this one holds the channels measured so far
+    if (myScheduler.update(frame) == false)
+    {
+        Serial.println("Failed to update the scheduler.");
+        return;
+    }
+
+    Serial.print(channels);
+    Serial.print("\t\t");
+    Serial.print(mySensor.getAgain());
+    Serial.print("\t");
+    Serial.print(mySensor.getIntegrationTimeUs());
+    Serial.print("\t\t");
+    Serial.print(mySensor.getFramePeriodUs());
+    Serial.print("\t\t");
+    Serial.print(myScheduler.getSnrIndex());
+    Serial.print("\t");
+    Serial.println(myScheduler.getSaturationPercent());
+}
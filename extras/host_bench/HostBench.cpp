@@ -0,0 +1,426 @@
+/**
+ * @file HostBench.cpp
+ * @brief Host benchmark of the AS7343 driver reads on a simulated sensor and bus.
+ *
+ * @details
+ * Runs the unchanged driver (src/sfTk/sfDevAS7343.cpp) against SimAS7343
+ * and SimI2CWire, and prints what each way of getting data costs on the bus
+ * at 100kHz, 400kHz and 1MHz:
+ *
+ * - Single: readSpectraDataFromSensor(), one read per frame period.
+ * - Frame: readFrame() and clearStatusReg(), one per frame period.
+ * - FIFO: 8 frame periods of FIFO entries, drained with readFifo().
+ * - Round-robin: 4 sensors behind a TCA9548A, the mux switched and
+ *   readFrame() and clearStatusReg() for each in turn.
+ * - Async poll: startRead() on a SimAsyncI2CBus, then poll() until it is
+ *   done, once per frame period.
+ * - Async FIFO: startFifoRead() on a SimAsyncI2CBus that reports the end
+ *   with the completion callback, the read callback counts the frames.
+ *
+ * For the asynchronous modes it also prints the time the CPU was free while
+ * the burst was on the bus. It ends with a rejected submit and a failed
+ * transfer, and checks that both come back as READ_STATE_FAILED.
+ *
+ * The numbers come from the simulated bus, so they don't need
+ * SFE_AS7343_STATS, and they are the same on every host. Example 21 measures
+ * the same on real hardware.
+ *
+ * @author SparkFun Electronics
+ * @date 2026
+ * @copyright Copyright (c) 2026, SparkFun Electronics Inc. This project is released under the MIT License.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * @section Repository Repository
+ * https://github.com/sparkfun/SparkFun_AS7343_Arduino_Library
+ */
+
+#include "SimAS7343.h"
+
+#include <sfTk/sfDevAS7343.h>
+
+#include <stdio.h>
+
+#define NUM_FRAMES 20       // Frames measured per mode and clock
+#define FIFO_PERIODS 8      // Frame periods the FIFO fills for in the FIFO mode
+#define FIFO_CHANNELS 6     // Channels mapped into the FIFO in the FIFO mode
+#define NUM_RR_SENSORS 4    // Sensors behind the mux in the round-robin mode
+#define POLL_STEP_US 10     // CPU time between two poll() calls in the async modes
+
+const uint32_t clocks[] = {100000, 400000, 1000000};
+
+static SimI2CWire wire;
+static SimAS7343 sensors[NUM_RR_SENSORS]; // sensors[0] is straight on the bus, the others only behind the mux
+
+static uint16_t fifoData[ksfAS7343FifoMaxEntries];
+static uint32_t rrLastCount[NUM_RR_SENSORS]; // Measurement count of each sensor at its last round-robin read
+
+// Timestamp source of the drivers: the simulated time in microseconds.
+static uint32_t simMicros(void)
+{
+    return (uint32_t)(wire.nowNs() / 1000);
+}
+
+// Traffic of one mode, how many of the frames read held a new measurement, and the CPU time free during the reads.
+struct result_t
+{
+    uint32_t frames;
+    uint32_t fresh;
+    uint32_t failed;
+    uint64_t freeNs;
+};
+
+// Read callback of the async modes.
+static uint32_t readsDone;
+static uint32_t readsFailed;
+static uint64_t readDoneNs;
+
+static void onReadDone(sfDevAS7343 *device, sfe_as7343_read_state_t state)
+{
+    (void)device;
+
+    if (state == READ_STATE_COMPLETE)
+        readsDone++;
+    else
+        readsFailed++;
+
+    readDoneNs = wire.nowNs();
+}
+
+static void printResult(const char *mode, uint32_t clockHz, const result_t &result)
+{
+    uint32_t frames = result.frames ? result.frames : 1;
+    double busUs = (double)wire.getBusNs() / 1000 / frames;
+
+    printf("%-12s %5lukHz %8.2f %8.1f %10.1f %10.0f %8.1f %6lu %6lu %6lu\n", mode, (unsigned long)(clockHz / 1000),
+           (double)wire.getTransactions() / frames, (double)wire.getBytes() / frames, busUs,
+           busUs > 0 ? 1000000 / busUs : 0, (double)result.freeNs / 1000 / frames, (unsigned long)result.frames,
+           (unsigned long)result.fresh, (unsigned long)result.failed);
+}
+
+// Configure one driver: 6 channels, 2.78ms integration time, all 6 channels into the FIFO.
+static bool setupSensor(sfDevAS7343 &device, SimI2CBus &bus)
+{
+    if (device.begin(&bus) == false)
+        return false;
+
+    device.setTimestampSource(simMicros);
+
+    return device.powerOn() && device.setAutoSmux(AUTOSMUX_6_CHANNELS) && device.setIntegrationTime(0, 999) &&
+           device.setFifoMap(0x3F) && device.enableSpectralMeasurement();
+}
+
+static result_t runSingle(sfDevAS7343 &device, SimAS7343 &sim, uint32_t periodUs)
+{
+    result_t result = {0, 0, 0, 0};
+    uint32_t lastCount = sim.getMeasurementCount();
+
+    wire.resetCounters();
+    for (int i = 0; i < NUM_FRAMES; i++)
+    {
+        wire.idle(periodUs);
+
+        if (device.readSpectraDataFromSensor() == false)
+        {
+            result.failed++;
+            continue;
+        }
+
+        result.frames++;
+        if (sim.getMeasurementCount() != lastCount)
+            result.fresh++;
+        lastCount = sim.getMeasurementCount();
+    }
+
+    return result;
+}
+
+static result_t runFrame(sfDevAS7343 &device, SimAS7343 &sim, uint32_t periodUs)
+{
+    result_t result = {0, 0, 0, 0};
+    uint32_t lastCount = sim.getMeasurementCount();
+    sfe_as7343_frame_t frame;
+
+    wire.resetCounters();
+    for (int i = 0; i < NUM_FRAMES; i++)
+    {
+        wire.idle(periodUs);
+
+        if (device.readFrame(frame) == false || device.clearStatusReg(frame.status) == false)
+        {
+            result.failed++;
+            continue;
+        }
+
+        result.frames++;
+        if (frame.valid && sim.getMeasurementCount() != lastCount)
+            result.fresh++;
+        lastCount = sim.getMeasurementCount();
+    }
+
+    return result;
+}
+
+static result_t runFifo(sfDevAS7343 &device, SimAS7343 &sim, uint32_t periodUs)
+{
+    result_t result = {0, 0, 0, 0};
+
+    if (device.clearFifo() == false)
+        result.failed++;
+
+    uint32_t firstCount = sim.getMeasurementCount();
+    wire.idle(periodUs * FIFO_PERIODS);
+
+    wire.resetCounters();
+    size_t entries = device.readFifo(fifoData, ksfAS7343FifoMaxEntries);
+
+    // Every FIFO entry is fresh, one measurement each 6 entries.
+    result.frames = entries / FIFO_CHANNELS;
+    result.fresh = sim.getMeasurementCount() - firstCount;
+    if (result.fresh > result.frames)
+        result.fresh = result.frames;
+
+    return result;
+}
+
+static result_t runAsyncPoll(sfDevAS7343 &device, SimAS7343 &sim, uint32_t periodUs)
+{
+    result_t result = {0, 0, 0, 0};
+    uint32_t lastCount = sim.getMeasurementCount();
+
+    wire.resetCounters();
+    for (int i = 0; i < NUM_FRAMES; i++)
+    {
+        wire.idle(periodUs);
+
+        if (device.startRead() == false)
+        {
+            result.failed++;
+            continue;
+        }
+
+        // The CPU is free until poll() sees the end of the burst.
+        uint64_t submittedNs = wire.nowNs();
+        sfe_as7343_read_state_t state;
+
+        while ((state = device.poll()) == READ_STATE_BUSY)
+            wire.idle(POLL_STEP_US);
+
+        if (state != READ_STATE_COMPLETE)
+        {
+            result.failed++;
+            continue;
+        }
+
+        result.frames++;
+        result.freeNs += readDoneNs - submittedNs;
+        if (sim.getMeasurementCount() != lastCount)
+            result.fresh++;
+        lastCount = sim.getMeasurementCount();
+    }
+
+    return result;
+}
+
+static result_t runAsyncFifo(sfDevAS7343 &device, SimAS7343 &sim, uint32_t periodUs)
+{
+    result_t result = {0, 0, 0, 0};
+
+    if (device.clearFifo() == false)
+        result.failed++;
+
+    uint32_t firstCount = sim.getMeasurementCount();
+    wire.idle(periodUs * FIFO_PERIODS);
+
+    readsDone = readsFailed = 0;
+
+    wire.resetCounters();
+    if (device.startFifoRead(fifoData, ksfAS7343FifoMaxEntries) == false)
+    {
+        result.failed++;
+        return result;
+    }
+
+    // Nothing to poll, the completion callback of the bus finishes the read and calls onReadDone().
+    uint64_t submittedNs = wire.nowNs();
+
+    while (readsDone + readsFailed == 0)
+        wire.idle(POLL_STEP_US);
+
+    result.failed += readsFailed;
+    result.freeNs = readDoneNs - submittedNs;
+    result.frames = device.getFifoReadCount() / FIFO_CHANNELS;
+    result.fresh = sim.getMeasurementCount() - firstCount;
+    if (result.fresh > result.frames)
+        result.fresh = result.frames;
+
+    return result;
+}
+
+// A rejected submit and a failed transfer must both end the read as failed.
+static bool checkAsyncFailures(sfDevAS7343 &device, SimAsyncI2CBus &pollBus, SimAsyncI2CBus &notifyBus)
+{
+    bool ok = true;
+
+    device.setAsyncBus(&pollBus);
+    pollBus.failNextSubmit();
+    if (device.startRead() || device.poll() != READ_STATE_FAILED)
+        ok = false;
+
+    pollBus.failNextTransfer();
+    if (device.startRead() == false)
+        ok = false;
+    while (device.poll() == READ_STATE_BUSY)
+        wire.idle(POLL_STEP_US);
+    if (device.poll() != READ_STATE_FAILED)
+        ok = false;
+
+    device.setAsyncBus(&notifyBus);
+    readsDone = readsFailed = 0;
+    notifyBus.failNextTransfer();
+    if (device.startRead() == false)
+        ok = false;
+    while (readsDone + readsFailed == 0)
+        wire.idle(POLL_STEP_US);
+    if (readsFailed != 1 || device.poll() != READ_STATE_FAILED)
+        ok = false;
+
+    device.setAsyncBus(nullptr);
+
+    // With the bus instrumentation built in, the rejected submit and the failed transfers are counted.
+    sfe_as7343_stats_t stats;
+    if (device.getStats(stats) && stats.op[STATS_OP_READ_DATA].failures < 3)
+        ok = false;
+
+    return ok;
+}
+
+static result_t runRoundRobin(sfDevAS7343 *devices, uint32_t periodUs)
+{
+    result_t result = {0, 0, 0, 0};
+    sfe_as7343_frame_t frame;
+
+    // Each sensor is read once per frame period, the reads spread across it.
+    wire.resetCounters();
+    for (int i = 0; i < NUM_FRAMES; i++)
+    {
+        uint8_t k = i % NUM_RR_SENSORS;
+
+        wire.idle(periodUs / NUM_RR_SENSORS);
+
+        if (wire.writeMux(1 << k) == false || devices[k].readFrame(frame) == false ||
+            devices[k].clearStatusReg(frame.status) == false)
+        {
+            result.failed++;
+            continue;
+        }
+
+        result.frames++;
+        if (frame.valid && sensors[k].getMeasurementCount() != rrLastCount[k])
+            result.fresh++;
+        rrLastCount[k] = sensors[k].getMeasurementCount();
+    }
+
+    return result;
+}
+
+int main(void)
+{
+    printf("AS7343 Host Benchmark - simulated sensor and I2C bus\n");
+
+    // A scene that stays below the full scale at 256x and 2.78ms.
+    float scene[kSimNumChannels];
+    for (uint8_t ch = 0; ch < kSimNumChannels; ch++)
+        scene[ch] = 0.2f + 0.05f * ch;
+
+    for (uint8_t k = 0; k < NUM_RR_SENSORS; k++)
+        sensors[k].setScene(scene);
+
+    // One sensor straight on the bus for the single sensor modes.
+    wire.attach(&sensors[0]);
+
+    SimI2CBus singleBus(wire);
+    sfDevAS7343 single;
+
+    if (setupSensor(single, singleBus) == false)
+    {
+        printf("Sensor failed to begin.\n");
+        return 1;
+    }
+
+    // Background reads: one bus polled, one that calls back when the read is done.
+    SimAsyncI2CBus pollBus(wire, false);
+    SimAsyncI2CBus notifyBus(wire, true);
+    single.setReadCallback(onReadDone);
+
+    // One measurement, with the SMUX overhead, fits in a frame period.
+    uint32_t periodUs = single.getFramePeriodUs() + 2000;
+
+    // The first measurement waits for the auto zero.
+    wire.idle(kSimAutoZeroNs / 1000 + periodUs);
+
+    printf("Frame period %luus, Wire buffer 32 bytes\n\n", (unsigned long)periodUs);
+    printf("%-12s %8s %8s %8s %10s %10s %8s %6s %6s %6s\n", "Mode", "Clock", "Trans", "Bytes", "Bus us", "Max fps",
+           "Free us", "Frames", "Fresh", "Failed");
+
+    for (int c = 0; c < 3; c++)
+    {
+        wire.setClock(clocks[c]);
+
+        printResult("Single", clocks[c], runSingle(single, sensors[0], periodUs));
+        printResult("Frame", clocks[c], runFrame(single, sensors[0], periodUs));
+        printResult("FIFO", clocks[c], runFifo(single, sensors[0], periodUs));
+
+        single.setAsyncBus(&pollBus);
+        printResult("Async poll", clocks[c], runAsyncPoll(single, sensors[0], periodUs));
+
+        single.setAsyncBus(&notifyBus);
+        printResult("Async FIFO", clocks[c], runAsyncFifo(single, sensors[0], periodUs));
+
+        single.setAsyncBus(nullptr);
+    }
+
+    bool asyncOk = checkAsyncFailures(single, pollBus, notifyBus);
+
+    // Round-robin: every sensor behind the mux, reset to the power-on state.
+    wire.detachAll();
+    for (uint8_t k = 0; k < NUM_RR_SENSORS; k++)
+    {
+        sensors[k].reset();
+        wire.attach(&sensors[k], k);
+    }
+
+    SimI2CBus rrBus[NUM_RR_SENSORS] = {SimI2CBus(wire), SimI2CBus(wire), SimI2CBus(wire), SimI2CBus(wire)};
+    sfDevAS7343 rrDevices[NUM_RR_SENSORS];
+
+    for (uint8_t k = 0; k < NUM_RR_SENSORS; k++)
+    {
+        if (wire.writeMux(1 << k) == false || setupSensor(rrDevices[k], rrBus[k]) == false)
+        {
+            printf("Sensor %u behind the mux failed to begin.\n", k);
+            return 1;
+        }
+
+        rrLastCount[k] = sensors[k].getMeasurementCount();
+    }
+
+    wire.idle(kSimAutoZeroNs / 1000 + periodUs);
+
+    for (int c = 0; c < 3; c++)
+    {
+        wire.setClock(clocks[c]);
+
+        printResult("Round-robin", clocks[c], runRoundRobin(rrDevices, periodUs));
+    }
+
+    uint32_t bankErrors = 0;
+    for (uint8_t k = 0; k < NUM_RR_SENSORS; k++)
+        bankErrors += sensors[k].getBankErrors();
+
+    printf("\nTrans and Bytes per frame, Bus us per frame at the clock, Max fps if the bus did nothing else.\n");
+    printf("Free us per frame: CPU time free while a background read was on the bus.\n");
+    printf("Fresh frames held a new measurement. Register bank errors: %lu\n", (unsigned long)bankErrors);
+    printf("Rejected submit and failed transfers: %s\n", asyncOk ? "reported as failed" : "NOT reported as failed");
+
+    return bankErrors == 0 && asyncOk ? 0 : 1;
+}
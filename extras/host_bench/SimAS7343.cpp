@@ -0,0 +1,719 @@
+/**
+ * @file SimAS7343.cpp
+ * @brief Implementation file for the simulated AS7343 and I2C bus.
+ *
+ * @details
+ * Implements the register file, the measurement engine and the FIFO of
+ * SimAS7343, and the transaction timing of SimI2CWire.
+ *
+ * @author SparkFun Electronics
+ * @date 2026
+ * @copyright Copyright (c) 2026, SparkFun Electronics Inc. This project is released under the MIT License.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * @section Repository Repository
+ * https://github.com/sparkfun/SparkFun_AS7343_Arduino_Library
+ */
+
+#include "SimAS7343.h"
+
+#include <string.h>
+
+// Registers the model acts on, see sfDevAS7343.h for the field layouts.
+const uint8_t kRegId = 0x5A;
+const uint8_t kRegEnable = 0x80;
+const uint8_t kRegATime = 0x81;
+const uint8_t kRegWTime = 0x83;
+const uint8_t kRegStatus2 = 0x90;
+const uint8_t kRegStatus = 0x93;
+const uint8_t kRegAStatus = 0x94;
+const uint8_t kRegData0 = 0x95;
+const uint8_t kRegDataEnd = 0xB8;
+const uint8_t kRegStatus4 = 0xBC;
+const uint8_t kRegCfg0 = 0xBF;
+const uint8_t kRegCfg1 = 0xC6;
+const uint8_t kRegCfg8 = 0xC9;
+const uint8_t kRegAStepL = 0xD4;
+const uint8_t kRegAStepH = 0xD5;
+const uint8_t kRegCfg20 = 0xD6;
+const uint8_t kRegAzConfig = 0xDE;
+const uint8_t kRegFdTime1 = 0xE0;
+const uint8_t kRegFdTime2 = 0xE2;
+const uint8_t kRegFdStatus = 0xE3;
+const uint8_t kRegControl = 0xFA;
+const uint8_t kRegFifoMap = 0xFC;
+const uint8_t kRegFifoLvl = 0xFD;
+const uint8_t kRegFData = 0xFE;
+
+const uint8_t kEnablePon = 0x01;
+const uint8_t kEnableSpEn = 0x02;
+const uint8_t kEnableWen = 0x08;
+const uint8_t kEnableSmuxEn = 0x10;
+const uint8_t kCfg0Wlong = 0x04;
+const uint8_t kCfg0RegBank = 0x10;
+const uint8_t kStatusFint = 0x04;
+const uint8_t kStatusAint = 0x08;
+const uint8_t kStatusAsat = 0x80;
+const uint8_t kStatus2AsatDig = 0x10;
+const uint8_t kStatus2AValid = 0x40;
+const uint8_t kStatus4FifoOv = 0x80;
+const uint8_t kControlFifoClr = 0x02;
+const uint8_t kControlSwReset = 0x08;
+
+///////////////////////////////////////////////////////////////////////////////
+// SimAS7343
+///////////////////////////////////////////////////////////////////////////////
+
+SimAS7343::SimAS7343() : _nowNs{0}, _cycleOverheadNs{kSimDefaultCycleOverheadNs}, _measurements{0}, _bankErrors{0}
+{
+    for (uint8_t ch = 0; ch < kSimNumChannels; ch++)
+        _scene[ch] = 100.0f;
+
+    reset();
+}
+
+void SimAS7343::reset(void)
+{
+    memset(_regs, 0, sizeof(_regs));
+    memset(_results, 0, sizeof(_results));
+    memset(_latched, 0, sizeof(_latched));
+
+    // Power-on values from the datasheet, the rest are 0.
+    _regs[kRegId] = 0x81;
+    _regs[kRegAStepL] = 999 & 0xFF;
+    _regs[kRegAStepH] = 999 >> 8;
+    _regs[kRegCfg1] = 9;                // AGAIN 256x
+    _regs[kRegCfg8] = 2 << 6;           // FIFO_TH 8 entries
+    _regs[kRegAzConfig] = 255;          // Auto zero before the first measurement only
+    _regs[kRegFdTime1] = 359 & 0xFF;    // FD_TIME 359
+    _regs[kRegFdTime2] = (9 << 3) | (359 >> 8);
+
+    _latchedStatus = 0;
+    _resultGain = 9;
+    _resultSaturated = false;
+    _fifoHead = 0;
+    _fifoCount = 0;
+    _fifoHalf = 0;
+    _running = false;
+    _autoZeroDone = false;
+    _cycle = 0;
+    _measureStartNs = 0;
+    _cycleEndNs = 0;
+}
+
+void SimAS7343::setScene(const float countsPerMs[kSimNumChannels])
+{
+    memcpy(_scene, countsPerMs, sizeof(_scene));
+}
+
+void SimAS7343::setCycleOverheadNs(uint32_t overheadNs)
+{
+    _cycleOverheadNs = overheadNs;
+}
+
+void SimAS7343::advanceTo(uint64_t nowNs)
+{
+    // A background read can leave the device ahead of the caller's time.
+    if (nowNs < _nowNs)
+        return;
+
+    while (_running && _cycleEndNs <= nowNs)
+    {
+        _nowNs = _cycleEndNs;
+        finishCycle();
+    }
+
+    _nowNs = nowNs;
+}
+
+void SimAS7343::write(uint8_t reg, const uint8_t *data, size_t length)
+{
+    for (size_t i = 0; i < length; i++, reg++)
+    {
+        if (!bankOk(reg))
+            continue;
+
+        uint8_t value = data[i];
+
+        if (reg == kRegStatus || reg == kRegFdStatus)
+        {
+            // Write 1 to clear.
+            _regs[reg] &= ~value;
+        }
+        else if (reg == kRegControl)
+        {
+            if (value & kControlSwReset)
+            {
+                reset();
+                return;
+            }
+
+            if (value & kControlFifoClr)
+            {
+                _fifoHead = _fifoCount = _fifoHalf = 0;
+                _regs[kRegStatus] &= ~kStatusFint;
+                _regs[kRegStatus4] &= ~kStatus4FifoOv;
+            }
+        }
+        else if (reg == kRegEnable)
+        {
+            // SMUXEN clears itself, the SMUX command runs instantly here.
+            _regs[reg] = value & ~kEnableSmuxEn;
+
+            bool run = (value & kEnablePon) && (value & kEnableSpEn);
+
+            if (run && !_running)
+            {
+                _running = true;
+                _cycle = 0;
+                _measureStartNs = _nowNs;
+                _cycleEndNs = _nowNs + getIntegrationNs() + _cycleOverheadNs;
+
+                if (_regs[kRegAzConfig] != 0 && !_autoZeroDone)
+                {
+                    _cycleEndNs += kSimAutoZeroNs;
+                    _autoZeroDone = true;
+                }
+            }
+            else if (!run && _running)
+            {
+                _running = false;
+                _regs[kRegStatus2] &= ~kStatus2AValid;
+            }
+        }
+        else if ((reg >= kRegStatus2 && reg <= kRegDataEnd) || reg == kRegStatus4 || reg >= kRegFifoLvl)
+        {
+            // Read only.
+        }
+        else
+        {
+            _regs[reg] = value;
+        }
+    }
+}
+
+void SimAS7343::read(uint8_t reg, uint8_t *data, size_t length)
+{
+    // A burst that doesn't go through ASTATUS reads the newest data.
+    const uint16_t *counts = _results;
+
+    for (size_t i = 0; i < length; i++)
+    {
+        if (reg >= kRegFData)
+        {
+            // FDATA_L then FDATA_H of the oldest entry, the pair pops it.
+            uint16_t entry = _fifoCount ? _fifo[_fifoHead] : 0;
+            data[i] = _fifoHalf ? entry >> 8 : entry & 0xFF;
+
+            if (_fifoHalf && _fifoCount)
+            {
+                _fifoHead = (_fifoHead + 1) % kSimFifoEntries;
+                _fifoCount--;
+            }
+
+            _fifoHalf ^= 1;
+            reg = kRegFData + _fifoHalf;
+            continue;
+        }
+
+        if (!bankOk(reg))
+        {
+            data[i] = 0;
+            reg++;
+            continue;
+        }
+
+        if (reg == kRegAStatus)
+        {
+            memcpy(_latched, _results, sizeof(_latched));
+            _latchedStatus = (_resultGain & 0x0F) | (_resultSaturated ? 0x80 : 0);
+            counts = _latched;
+            data[i] = _latchedStatus;
+        }
+        else if (reg >= kRegData0 && reg <= kRegDataEnd)
+        {
+            uint16_t word = counts[(reg - kRegData0) / 2];
+            data[i] = (reg - kRegData0) & 1 ? word >> 8 : word & 0xFF;
+        }
+        else if (reg == kRegFifoLvl)
+        {
+            data[i] = (uint8_t)_fifoCount;
+        }
+        else if (reg == kRegControl)
+        {
+            data[i] = 0;
+        }
+        else
+        {
+            data[i] = _regs[reg];
+        }
+
+        reg++;
+    }
+}
+
+uint32_t SimAS7343::getMeasurementCount(void)
+{
+    return _measurements;
+}
+
+uint32_t SimAS7343::getBankErrors(void)
+{
+    return _bankErrors;
+}
+
+bool SimAS7343::bankOk(uint8_t reg)
+{
+    if (reg == kRegCfg0)
+        return true;
+
+    bool bank1 = _regs[kRegCfg0] & kCfg0RegBank;
+    bool ok = reg < 0x80 ? bank1 : !bank1;
+
+    if (!ok)
+        _bankErrors++;
+
+    return ok;
+}
+
+uint8_t SimAS7343::getNumCycles(void)
+{
+    // auto_smux: 0 is 6 channels, 2 is 12, 3 is 18 (1 is reserved, runs as 6).
+    uint8_t autoSmux = (_regs[kRegCfg20] >> 5) & 0x03;
+
+    return autoSmux < 2 ? 1 : autoSmux;
+}
+
+uint64_t SimAS7343::getIntegrationNs(void)
+{
+    uint32_t astep = _regs[kRegAStepL] | ((uint32_t)_regs[kRegAStepH] << 8);
+
+    return (uint64_t)(_regs[kRegATime] + 1) * (astep + 1) * kSimStepNs;
+}
+
+void SimAS7343::finishCycle(void)
+{
+    uint32_t astep = _regs[kRegAStepL] | ((uint32_t)_regs[kRegAStepH] << 8);
+    uint32_t fullScale = (uint32_t)(_regs[kRegATime] + 1) * (astep + 1);
+    uint8_t again = _regs[kRegCfg1] & 0x1F;
+
+    if (fullScale > 0xFFFF)
+        fullScale = 0xFFFF;
+    if (again > 12)
+        again = 12;
+
+    // AGAIN 0 is 0.5x, every step doubles.
+    float gain = (float)(1UL << again) / 2;
+    float integrationMs = (float)getIntegrationNs() / 1000000;
+
+    if (_cycle == 0)
+    {
+        _resultSaturated = false;
+        _resultGain = again;
+    }
+
+    uint8_t fifoMap = _regs[kRegFifoMap];
+
+    if (fifoMap & 0x01)
+        pushFifo((_resultGain & 0x0F) | (_resultSaturated ? 0x80 : 0));
+
+    for (uint8_t i = 0; i < 6; i++)
+    {
+        uint8_t ch = _cycle * 6 + i;
+        float counts = _scene[ch] * gain * integrationMs;
+
+        if (counts >= fullScale)
+        {
+            counts = (float)fullScale;
+            _resultSaturated = true;
+        }
+
+        _results[ch] = (uint16_t)counts;
+
+        if (fifoMap & (0x02 << i))
+            pushFifo(_results[ch]);
+    }
+
+    uint8_t fifoThreshold = 1 << ((_regs[kRegCfg8] >> 6) * 2);
+
+    if (_fifoCount >= fifoThreshold)
+        _regs[kRegStatus] |= kStatusFint;
+
+    if (++_cycle < getNumCycles())
+    {
+        _cycleEndNs = _nowNs + getIntegrationNs() + _cycleOverheadNs;
+        return;
+    }
+
+    // The measurement is complete.
+    _measurements++;
+    _cycle = 0;
+
+    _regs[kRegStatus2] = (_regs[kRegStatus2] & ~kStatus2AsatDig) | kStatus2AValid |
+                         (_resultSaturated ? kStatus2AsatDig : 0);
+    _regs[kRegStatus] |= kStatusAint | (_resultSaturated ? kStatusAsat : 0);
+
+    // The wait time pads the measurement to the period, if it is longer.
+    uint64_t startNs = _nowNs;
+
+    if (_regs[kRegEnable] & kEnableWen)
+    {
+        uint64_t waitNs = (uint64_t)(_regs[kRegWTime] + 1) * kSimWaitStepNs;
+
+        if (_regs[kRegCfg0] & kCfg0Wlong)
+            waitNs *= 16;
+
+        if (_measureStartNs + waitNs > startNs)
+            startNs = _measureStartNs + waitNs;
+    }
+
+    _measureStartNs = startNs;
+    _cycleEndNs = startNs + getIntegrationNs() + _cycleOverheadNs;
+}
+
+void SimAS7343::pushFifo(uint16_t entry)
+{
+    if (_fifoCount == kSimFifoEntries)
+    {
+        _regs[kRegStatus4] |= kStatus4FifoOv;
+        return;
+    }
+
+    _fifo[(_fifoHead + _fifoCount) % kSimFifoEntries] = entry;
+    _fifoCount++;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// SimI2CWire
+///////////////////////////////////////////////////////////////////////////////
+
+SimI2CWire::SimI2CWire()
+    : _direct{nullptr}, _behindMux{}, _muxMask{0}, _clockHz{100000}, _bufferBytes{32}, _nowNs{0}, _transactions{0},
+      _bytes{0}, _busNs{0}, _busyUntilNs{0}, _bgPending{false}, _bgDone{nullptr}, _bgContext{nullptr}
+{
+}
+
+bool SimI2CWire::attach(SimAS7343 *device, int8_t muxChannel)
+{
+    if (!device || muxChannel >= kSimMuxChannels)
+        return false;
+
+    SimAS7343 *&slot = muxChannel < 0 ? _direct : _behindMux[muxChannel];
+
+    if (slot)
+        return false;
+
+    slot = device;
+    device->advanceTo(_nowNs);
+
+    return true;
+}
+
+void SimI2CWire::detachAll(void)
+{
+    _direct = nullptr;
+    memset(_behindMux, 0, sizeof(_behindMux));
+    _muxMask = 0;
+}
+
+void SimI2CWire::setClock(uint32_t clockHz)
+{
+    if (clockHz)
+        _clockHz = clockHz;
+}
+
+void SimI2CWire::setBufferSize(size_t bufferBytes)
+{
+    _bufferBytes = bufferBytes;
+}
+
+void SimI2CWire::idle(uint32_t us)
+{
+    uint64_t targetNs = _nowNs + (uint64_t)us * 1000;
+
+    if (_bgPending && _busyUntilNs <= targetNs)
+    {
+        if (_busyUntilNs > _nowNs)
+            _nowNs = _busyUntilNs;
+
+        finishBackground();
+    }
+
+    // The done function may have used the bus past the target.
+    if (targetNs > _nowNs)
+        _nowNs = targetNs;
+}
+
+uint64_t SimI2CWire::nowNs(void)
+{
+    return _nowNs;
+}
+
+bool SimI2CWire::writeRegister(uint8_t address, uint8_t reg, const uint8_t *data, size_t length)
+{
+    if (address != kSimAS7343Addr || !selected())
+        return false;
+
+    // Start, address, register, data, stop.
+    transaction(2 + length, 2);
+
+    // A write with more than one mux channel connected reaches all of them.
+    if (_direct)
+        _direct->write(reg, data, length);
+
+    for (uint8_t ch = 0; ch < kSimMuxChannels; ch++)
+    {
+        if ((_muxMask & (1 << ch)) && _behindMux[ch])
+            _behindMux[ch]->write(reg, data, length);
+    }
+
+    return true;
+}
+
+bool SimI2CWire::readRegister(uint8_t address, uint8_t reg, uint8_t *data, size_t length)
+{
+    SimAS7343 *device = selected();
+
+    if (address != kSimAS7343Addr || !device || length == 0)
+        return false;
+
+    // Start, address, register, restart, address, the first request, stop. Longer reads go on with
+    // more requests of start, address, data, stop, the device keeps incrementing the register.
+    size_t chunk = _bufferBytes && length > _bufferBytes ? _bufferBytes : length;
+    transaction(3 + chunk, 3);
+
+    device->read(reg, data, length);
+
+    for (size_t done = chunk; done < length; done += chunk)
+    {
+        chunk = _bufferBytes && length - done > _bufferBytes ? _bufferBytes : length - done;
+        transaction(1 + chunk, 2);
+    }
+
+    return true;
+}
+
+bool SimI2CWire::startBackgroundRead(uint8_t address, uint8_t reg, uint8_t *data, size_t length,
+                                     void (*done)(void *context), void *context)
+{
+    if (_bgPending)
+        return false;
+
+    // Run the read as usual, then give the caller its time back.
+    uint64_t callerNs = _nowNs;
+
+    if (readRegister(address, reg, data, length) == false)
+        return false;
+
+    _busyUntilNs = _nowNs;
+    _nowNs = callerNs;
+    _bgPending = true;
+    _bgDone = done;
+    _bgContext = context;
+
+    return true;
+}
+
+bool SimI2CWire::writeMux(uint8_t mask)
+{
+    // Start, address, control byte, stop.
+    transaction(2, 2);
+    _muxMask = mask;
+
+    return true;
+}
+
+bool SimI2CWire::ping(uint8_t address)
+{
+    transaction(1, 2);
+
+    return address == kSimMuxAddr || (address == kSimAS7343Addr && selected());
+}
+
+void SimI2CWire::resetCounters(void)
+{
+    _transactions = 0;
+    _bytes = 0;
+    _busNs = 0;
+}
+
+uint32_t SimI2CWire::getTransactions(void)
+{
+    return _transactions;
+}
+
+uint32_t SimI2CWire::getBytes(void)
+{
+    return _bytes;
+}
+
+uint64_t SimI2CWire::getBusNs(void)
+{
+    return _busNs;
+}
+
+void SimI2CWire::transaction(size_t numBytes, uint8_t numConditions)
+{
+    // Wait for a background transfer to free the bus, and report it done first.
+    if (_nowNs < _busyUntilNs)
+        _nowNs = _busyUntilNs;
+
+    if (_bgPending)
+        finishBackground();
+
+    // The devices see the bus at the start of the transaction.
+    if (_direct)
+        _direct->advanceTo(_nowNs);
+
+    for (uint8_t ch = 0; ch < kSimMuxChannels; ch++)
+    {
+        if (_behindMux[ch])
+            _behindMux[ch]->advanceTo(_nowNs);
+    }
+
+    // 9 clocks per byte (8 bits and the acknowledge), one per start, restart and stop.
+    uint64_t clocks = numBytes * 9 + numConditions;
+    uint64_t ns = clocks * 1000000000ULL / _clockHz;
+
+    _transactions++;
+    _bytes += numBytes;
+    _busNs += ns;
+    _nowNs += ns;
+}
+
+SimAS7343 *SimI2CWire::selected(void)
+{
+    if (_direct)
+        return _direct;
+
+    for (uint8_t ch = 0; ch < kSimMuxChannels; ch++)
+    {
+        if ((_muxMask & (1 << ch)) && _behindMux[ch])
+            return _behindMux[ch];
+    }
+
+    return nullptr;
+}
+
+void SimI2CWire::finishBackground(void)
+{
+    // Cleared first, the done function may start the next read.
+    _bgPending = false;
+
+    if (_bgDone)
+        _bgDone(_bgContext);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// SimI2CBus
+///////////////////////////////////////////////////////////////////////////////
+
+SimI2CBus::SimI2CBus(SimI2CWire &wire, uint8_t address) : _wire(wire)
+{
+    setAddress(address);
+}
+
+sfTkError_t SimI2CBus::ping()
+{
+    return _wire.ping(_address) ? ksfTkErrOk : ksfTkErrFail;
+}
+
+sfTkError_t SimI2CBus::writeRegister(uint8_t *devReg, size_t regLength, const uint8_t *data, size_t length)
+{
+    if (!devReg || regLength != 1 || (!data && length))
+        return ksfTkErrFail;
+
+    return _wire.writeRegister(_address, *devReg, data, length) ? ksfTkErrOk : ksfTkErrFail;
+}
+
+sfTkError_t SimI2CBus::readRegister(uint8_t *devReg, size_t regLength, uint8_t *data, size_t numBytes,
+                                    size_t &readBytes, uint32_t read_delay)
+{
+    (void)read_delay;
+
+    readBytes = 0;
+
+    if (!devReg || regLength != 1 || !data)
+        return ksfTkErrFail;
+
+    if (_wire.readRegister(_address, *devReg, data, numBytes) == false)
+        return ksfTkErrFail;
+
+    readBytes = numBytes;
+
+    return ksfTkErrOk;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// SimAsyncI2CBus
+///////////////////////////////////////////////////////////////////////////////
+
+SimAsyncI2CBus::SimAsyncI2CBus(SimI2CWire &wire, bool notify, uint8_t address)
+    : _wire(wire), _address{address}, _notify{notify}, _failSubmit{false}, _failTransfer{false},
+      _state{READ_STATE_IDLE}, _numBytes{0}, _callback{nullptr}, _context{nullptr}
+{
+}
+
+bool SimAsyncI2CBus::startReadRegister(uint8_t devReg, uint8_t *data, size_t numBytes)
+{
+    if (_failSubmit)
+    {
+        _failSubmit = false;
+        return false;
+    }
+
+    if (!data || _state == READ_STATE_BUSY)
+        return false;
+
+    // Busy before the submit, the wire may report it done from inside the next transaction.
+    _state = READ_STATE_BUSY;
+    _numBytes = numBytes;
+
+    if (_wire.startBackgroundRead(_address, devReg, data, numBytes, transferDone, this) == false)
+    {
+        _state = READ_STATE_FAILED;
+        return false;
+    }
+
+    return true;
+}
+
+sfe_as7343_read_state_t SimAsyncI2CBus::pollReadRegister(size_t &readBytes)
+{
+    readBytes = _state == READ_STATE_COMPLETE ? _numBytes : 0;
+
+    return _state;
+}
+
+bool SimAsyncI2CBus::setCompletionCallback(void (*callback)(void *context), void *context)
+{
+    if (!_notify)
+        return false;
+
+    _callback = callback;
+    _context = context;
+
+    return true;
+}
+
+void SimAsyncI2CBus::failNextSubmit(void)
+{
+    _failSubmit = true;
+}
+
+void SimAsyncI2CBus::failNextTransfer(void)
+{
+    _failTransfer = true;
+}
+
+void SimAsyncI2CBus::transferDone(void *context)
+{
+    SimAsyncI2CBus *bus = (SimAsyncI2CBus *)context;
+
+    bus->_state = bus->_failTransfer ? READ_STATE_FAILED : READ_STATE_COMPLETE;
+    bus->_failTransfer = false;
+
+    if (bus->_callback)
+        bus->_callback(bus->_context);
+}
@@ -0,0 +1,311 @@
+/**
+ * @file SimAS7343.h
+ * @brief Simulated AS7343 and I2C bus for benchmarking the driver on a host.
+ *
+ * @details
+ * SimAS7343 models the parts of the AS7343 that decide what the driver's
+ * reads cost and return:
+ *
+ * - Register banks: 0x58-0x7F only answer with REG_BANK (CFG0) set, 0x80 and
+ *   up only with it clear, CFG0 always. Accesses to the wrong bank are
+ *   counted (getBankErrors()) and read as 0.
+ * - The measurement engine: with PON and SP_EN set, each SMUX cycle (1, 2 or
+ *   3 for AUTOSMUX 6, 12 or 18 channels) integrates for (ATIME + 1) x
+ *   (ASTEP + 1) x 2.78us plus a fixed cycle overhead, after an auto zero
+ *   before the first one. WEN pads the measurement to (WTIME + 1) x 2.78ms
+ *   (x16 with WLONG). The counts come from a fixed scene, scaled with AGAIN
+ *   and the integration time, and clipped at the full scale.
+ * - Status: STATUS2 AVALID and the saturation flags, STATUS AINT and ASAT
+ *   (write 1 to clear), ASTATUS with the gain of the data. Reading ASTATUS
+ *   latches the data registers, a burst that starts past it reads the
+ *   newest data.
+ * - FIFO: every SMUX cycle writes the channels of FIFO_MAP (and ASTATUS on
+ *   request), 128 entries deep, FIFO_OV in STATUS4 when it overflows.
+ *   FIFO_LVL counts the entries, FDATA bursts pop them. CONTROL FIFO_CLR
+ *   and SW_RESET work.
+ *
+ * Flicker detection, the spectral thresholds and SAI are not modeled.
+ *
+ * SimI2CWire is the shared bus: it keeps the simulated time, charges every
+ * transaction its time at the bus clock (9 clocks per byte, start, restart
+ * and stop), splits reads like a Wire buffer of a given size, and counts the
+ * transactions and bytes. It can route through a TCA9548A mux, for more than
+ * one AS7343 at 0x39, and run one read in the background while the simulated
+ * CPU goes on. SimI2CBus is the sfTkII2C a driver instance talks through,
+ * like sfTkArdI2C on Arduino. SimAsyncI2CBus is an sfDevAS7343AsyncBus on the
+ * background read, polled or with a completion callback.
+ *
+ * @author SparkFun Electronics
+ * @date 2026
+ * @copyright Copyright (c) 2026, SparkFun Electronics Inc. This project is released under the MIT License.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * @section Repository Repository
+ * https://github.com/sparkfun/SparkFun_AS7343_Arduino_Library
+ */
+
+#pragma once
+
+#include <sfTk/sfDevAS7343.h>
+#include <sfTk/sfTkII2C.h>
+
+#include <stddef.h>
+#include <stdint.h>
+
+const uint8_t kSimAS7343Addr = 0x39;            // I2C address of the AS7343
+const uint8_t kSimMuxAddr = 0x70;               // I2C address of the TCA9548A
+const uint8_t kSimMuxChannels = 8;              // Channels of the TCA9548A
+const uint8_t kSimNumChannels = 18;             // Data registers of the AS7343
+const uint16_t kSimFifoEntries = 128;           // FIFO depth, 2 bytes per entry
+const uint32_t kSimStepNs = 2780;               // Integration step (ASTEP + 1 = 1)
+const uint32_t kSimWaitStepNs = 2780000;        // Wait time step (WTIME + 1 = 1)
+const uint32_t kSimAutoZeroNs = 15000000;       // Typical auto zero time (datasheet AZ_CONFIG)
+const uint32_t kSimDefaultCycleOverheadNs = 0;  // Extra time per SMUX cycle, see setCycleOverheadNs()
+
+/**
+ * @class SimAS7343
+ * @brief Register level model of one AS7343.
+ */
+class SimAS7343
+{
+  public:
+    SimAS7343();
+
+    /// @brief Go back to the power-on state.
+    void reset(void);
+
+    /// @brief Set the scene.
+    /// @param countsPerMs Counts per millisecond of integration at 1x gain, per data register.
+    void setScene(const float countsPerMs[kSimNumChannels]);
+
+    /// @brief Set the time between SMUX cycles that isn't integration.
+    /// @details The datasheet doesn't give it, 0 (the default) models an ideal engine.
+    /// @param overheadNs The time in nanoseconds.
+    void setCycleOverheadNs(uint32_t overheadNs);
+
+    /// @brief Run the measurement engine up to a time.
+    /// @param nowNs Simulated time in nanoseconds, never going back.
+    void advanceTo(uint64_t nowNs);
+
+    /// @brief Register write, starting at a register, auto-incrementing.
+    /// @param reg The first register.
+    /// @param data Pointer to the values.
+    /// @param length Number of bytes.
+    void write(uint8_t reg, const uint8_t *data, size_t length);
+
+    /// @brief Register read, starting at a register, auto-incrementing.
+    /// @details FDATA (0xFE, 0xFF) doesn't increment past 0xFF, every byte
+    /// pair pops the next FIFO entry.
+    /// @param reg The first register.
+    /// @param data Pointer to the buffer.
+    /// @param length Number of bytes.
+    void read(uint8_t reg, uint8_t *data, size_t length);
+
+    /// @brief Get the number of finished measurements (all SMUX cycles).
+    uint32_t getMeasurementCount(void);
+
+    /// @brief Get the number of accesses to a register of the other bank.
+    uint32_t getBankErrors(void);
+
+  private:
+    /// @brief Check that a register can be reached with the bank selected.
+    bool bankOk(uint8_t reg);
+
+    /// @brief Get the SMUX cycles of a measurement, from CFG20.
+    uint8_t getNumCycles(void);
+
+    /// @brief Get the integration time of one SMUX cycle.
+    uint64_t getIntegrationNs(void);
+
+    /// @brief Finish an SMUX cycle: counts, FIFO, and the status at the end of the measurement.
+    void finishCycle(void);
+
+    /// @brief Append an entry to the FIFO.
+    void pushFifo(uint16_t entry);
+
+    uint8_t _regs[256];                     // Register file, read back as written unless modeled.
+    uint16_t _results[kSimNumChannels];     // Newest counts, written at the end of each cycle.
+    uint16_t _latched[kSimNumChannels];     // Counts latched by the last ASTATUS read.
+    uint8_t _latchedStatus;                 // ASTATUS of the latched counts.
+    uint8_t _resultGain;                    // AGAIN the newest counts were measured with.
+    bool _resultSaturated;                  // True if a channel of the newest measurement clipped.
+    float _scene[kSimNumChannels];          // Counts per ms at 1x gain.
+    uint16_t _fifo[kSimFifoEntries];        // FIFO entries.
+    uint16_t _fifoHead;                     // Oldest FIFO entry.
+    uint16_t _fifoCount;                    // FIFO entries waiting.
+    uint8_t _fifoHalf;                      // FDATA byte of the entry being popped, 0 or 1.
+    bool _running;                          // True while PON and SP_EN are set.
+    bool _autoZeroDone;                     // True once the first auto zero ran.
+    uint8_t _cycle;                         // SMUX cycle being integrated.
+    uint64_t _nowNs;                        // Time the engine has run up to.
+    uint64_t _measureStartNs;               // Start of the measurement being integrated.
+    uint64_t _cycleEndNs;                   // End of the SMUX cycle being integrated.
+    uint32_t _cycleOverheadNs;              // See setCycleOverheadNs().
+    uint32_t _measurements;                 // Finished measurements.
+    uint32_t _bankErrors;                   // Accesses to the wrong bank.
+};
+
+/**
+ * @class SimI2CWire
+ * @brief Simulated I2C bus with the simulated time and traffic counters.
+ */
+class SimI2CWire
+{
+  public:
+    SimI2CWire();
+
+    /// @brief Connect a device.
+    /// @param device The device, at kSimAS7343Addr.
+    /// @param muxChannel Mux channel it sits behind, or -1 for straight on the bus.
+    /// @return True if successful, false if the channel is taken.
+    bool attach(SimAS7343 *device, int8_t muxChannel = -1);
+
+    /// @brief Disconnect every device and clear the mux channel mask, the time goes on.
+    void detachAll(void);
+
+    /// @brief Set the bus clock.
+    /// @param clockHz Clock in Hz.
+    void setClock(uint32_t clockHz);
+
+    /// @brief Set the largest read of one bus request, like the Wire buffer.
+    /// @param bufferBytes Bytes per request, 0 for no limit. The default is 32 (AVR Wire).
+    void setBufferSize(size_t bufferBytes);
+
+    /// @brief Let time pass without bus traffic.
+    /// @param us Microseconds.
+    void idle(uint32_t us);
+
+    /// @brief Get the simulated time.
+    /// @return Nanoseconds since the start.
+    uint64_t nowNs(void);
+
+    /// @brief Write registers of the device at an address.
+    bool writeRegister(uint8_t address, uint8_t reg, const uint8_t *data, size_t length);
+
+    /// @brief Read registers of the device at an address, split into buffer sized requests.
+    bool readRegister(uint8_t address, uint8_t reg, uint8_t *data, size_t length);
+
+    /// @brief Start a read of registers in the background.
+    /// @details The transfer takes the bus from now, for as long as
+    /// readRegister() would, but the simulated time doesn't move: the caller
+    /// goes on while it runs. Transactions started before it ends wait for it.
+    /// Once the time (idle() or a later transaction) reaches its end, done is
+    /// called. The device sees the burst when it starts.
+    /// @param address The device address.
+    /// @param reg The first register.
+    /// @param data Pointer to the buffer, filled when the read starts.
+    /// @param length Number of bytes.
+    /// @param done Function to call when the transfer ends.
+    /// @param context Value to pass to done.
+    /// @return True if the read was started, false if one is in flight or no device answers.
+    bool startBackgroundRead(uint8_t address, uint8_t reg, uint8_t *data, size_t length, void (*done)(void *context),
+                             void *context);
+
+    /// @brief Write the TCA9548A channel mask.
+    bool writeMux(uint8_t mask);
+
+    /// @brief Check that something acknowledges an address.
+    bool ping(uint8_t address);
+
+    /// @brief Reset the traffic counters.
+    void resetCounters(void);
+
+    uint32_t getTransactions(void); // Bus transactions (start to stop) since resetCounters().
+    uint32_t getBytes(void);        // Address, register and data bytes since resetCounters().
+    uint64_t getBusNs(void);        // Bus time since resetCounters().
+
+  private:
+    /// @brief Charge a transaction and advance the devices.
+    void transaction(size_t numBytes, uint8_t numConditions);
+
+    /// @brief Get the device an access to the AS7343 address reaches.
+    SimAS7343 *selected(void);
+
+    /// @brief End the background read and call its done function.
+    void finishBackground(void);
+
+    SimAS7343 *_direct;                     // Device straight on the bus.
+    SimAS7343 *_behindMux[kSimMuxChannels]; // Devices behind the mux.
+    uint8_t _muxMask;                       // Mux channels connected.
+    uint32_t _clockHz;                      // Bus clock.
+    size_t _bufferBytes;                    // Largest read request, 0 for no limit.
+    uint64_t _nowNs;                        // Simulated time.
+    uint32_t _transactions;                 // Transactions counted.
+    uint32_t _bytes;                        // Bytes counted.
+    uint64_t _busNs;                        // Bus time counted.
+    uint64_t _busyUntilNs;                  // End of the last background transfer.
+    bool _bgPending;                        // True until the background read's done function ran.
+    void (*_bgDone)(void *context);         // Done function of the background read.
+    void *_bgContext;                       // Value passed to _bgDone.
+};
+
+/**
+ * @class SimI2CBus
+ * @brief The sfTkII2C of one driver instance, on a SimI2CWire.
+ */
+class SimI2CBus : public sfTkII2C
+{
+  public:
+    /// @param wire The bus.
+    /// @param address I2C address of the device.
+    SimI2CBus(SimI2CWire &wire, uint8_t address = kSimAS7343Addr);
+
+    sfTkError_t ping() override;
+
+    sfTkError_t writeRegister(uint8_t *devReg, size_t regLength, const uint8_t *data, size_t length) override;
+
+    sfTkError_t readRegister(uint8_t *devReg, size_t regLength, uint8_t *data, size_t numBytes, size_t &readBytes,
+                             uint32_t read_delay = 0) override;
+
+    using sfTkIBus::readRegister;
+    using sfTkIBus::writeRegister;
+
+  private:
+    SimI2CWire &_wire; // The bus.
+};
+
+/**
+ * @class SimAsyncI2CBus
+ * @brief sfDevAS7343AsyncBus on the background read of a SimI2CWire.
+ *
+ * @details
+ * Reports finished reads with the completion callback, or only through
+ * pollReadRegister() when built with notify false. failNextSubmit() and
+ * failNextTransfer() make the next read fail when it is submitted, or when
+ * it finishes.
+ */
+class SimAsyncI2CBus : public sfDevAS7343AsyncBus
+{
+  public:
+    /// @param wire The bus.
+    /// @param notify True to call the completion callback, false to be polled.
+    /// @param address I2C address of the device.
+    SimAsyncI2CBus(SimI2CWire &wire, bool notify, uint8_t address = kSimAS7343Addr);
+
+    bool startReadRegister(uint8_t devReg, uint8_t *data, size_t numBytes) override;
+
+    sfe_as7343_read_state_t pollReadRegister(size_t &readBytes) override;
+
+    bool setCompletionCallback(void (*callback)(void *context), void *context) override;
+
+    /// @brief Reject the next startReadRegister().
+    void failNextSubmit(void);
+
+    /// @brief End the next read with READ_STATE_FAILED.
+    void failNextTransfer(void);
+
+  private:
+    /// @brief Done function of the background read.
+    static void transferDone(void *context);
+
+    SimI2CWire &_wire;                // The bus.
+    uint8_t _address;                 // I2C address of the device.
+    bool _notify;                     // True if the completion callback is offered.
+    bool _failSubmit;                 // See failNextSubmit().
+    bool _failTransfer;               // See failNextTransfer().
+    sfe_as7343_read_state_t _state;   // State of the last read.
+    size_t _numBytes;                 // Length of the last read.
+    void (*_callback)(void *context); // Completion callback, nullptr if none.
+    void *_context;                   // Value passed to the completion callback.
+};
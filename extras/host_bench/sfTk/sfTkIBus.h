@@ -0,0 +1,68 @@
+/**
+ * @file sfTkIBus.h
+ * @brief Host stand-in for the SparkFun Toolkit bus interface.
+ *
+ * @details
+ * Only the register access the AS7343 driver uses, see sfToolkit.h.
+ *
+ * @author SparkFun Electronics
+ * @date 2026
+ * @copyright Copyright (c) 2026, SparkFun Electronics Inc. This project is released under the MIT License.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * @section Repository Repository
+ * https://github.com/sparkfun/SparkFun_AS7343_Arduino_Library
+ */
+
+#pragma once
+
+#include "sfToolkit.h"
+
+class sfTkIBus
+{
+  public:
+    virtual ~sfTkIBus()
+    {
+    }
+
+    /// @brief Write consecutive registers.
+    /// @param devReg Pointer to the register address.
+    /// @param regLength Number of address bytes.
+    /// @param data Pointer to the register values.
+    /// @param length Number of bytes to write.
+    /// @return ksfTkErrOk on success.
+    virtual sfTkError_t writeRegister(uint8_t *devReg, size_t regLength, const uint8_t *data, size_t length) = 0;
+
+    sfTkError_t writeRegister(uint8_t devReg, const uint8_t *data, size_t length)
+    {
+        return writeRegister(&devReg, 1, data, length);
+    }
+
+    sfTkError_t writeRegister(uint8_t devReg, uint8_t data)
+    {
+        return writeRegister(&devReg, 1, &data, 1);
+    }
+
+    /// @brief Read consecutive registers.
+    /// @param devReg Pointer to the register address.
+    /// @param regLength Number of address bytes.
+    /// @param data Pointer to the buffer to read into.
+    /// @param numBytes Number of bytes to read.
+    /// @param readBytes Set to the number of bytes read.
+    /// @param read_delay Delay between the address write and the read, unused here.
+    /// @return ksfTkErrOk on success.
+    virtual sfTkError_t readRegister(uint8_t *devReg, size_t regLength, uint8_t *data, size_t numBytes,
+                                     size_t &readBytes, uint32_t read_delay = 0) = 0;
+
+    sfTkError_t readRegister(uint8_t devReg, uint8_t *data, size_t numBytes, size_t &readBytes)
+    {
+        return readRegister(&devReg, 1, data, numBytes, readBytes);
+    }
+
+    sfTkError_t readRegister(uint8_t devReg, uint8_t &data)
+    {
+        size_t readBytes = 0;
+        return readRegister(&devReg, 1, &data, 1, readBytes);
+    }
+};
@@ -0,0 +1,45 @@
+/**
+ * @file sfTkII2C.h
+ * @brief Host stand-in for the SparkFun Toolkit I2C bus interface.
+ *
+ * @details
+ * Only the part the AS7343 driver uses, see sfToolkit.h.
+ *
+ * @author SparkFun Electronics
+ * @date 2026
+ * @copyright Copyright (c) 2026, SparkFun Electronics Inc. This project is released under the MIT License.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * @section Repository Repository
+ * https://github.com/sparkfun/SparkFun_AS7343_Arduino_Library
+ */
+
+#pragma once
+
+#include "sfTkIBus.h"
+
+class sfTkII2C : public sfTkIBus
+{
+  public:
+    sfTkII2C() : _address{0}
+    {
+    }
+
+    /// @brief Check that the device acknowledges its address.
+    /// @return ksfTkErrOk if it does.
+    virtual sfTkError_t ping() = 0;
+
+    void setAddress(uint8_t address)
+    {
+        _address = address;
+    }
+
+    uint8_t address(void)
+    {
+        return _address;
+    }
+
+  protected:
+    uint8_t _address; // I2C address of the device.
+};
@@ -0,0 +1,29 @@
+/**
+ * @file sfToolkit.h
+ * @brief Host stand-in for the SparkFun Toolkit core header.
+ *
+ * @details
+ * The host benchmark builds the AS7343 driver without the Arduino core or
+ * the SparkFun Toolkit library. These headers declare just the part of the
+ * Toolkit the driver uses (the error type and the bus interfaces), with the
+ * same names and signatures, so the driver sources compile unchanged.
+ *
+ * @author SparkFun Electronics
+ * @date 2026
+ * @copyright Copyright (c) 2026, SparkFun Electronics Inc. This project is released under the MIT License.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * @section Repository Repository
+ * https://github.com/sparkfun/SparkFun_AS7343_Arduino_Library
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+typedef int32_t sfTkError_t;
+
+const sfTkError_t ksfTkErrOk = 0x00;  // Success
+const sfTkError_t ksfTkErrFail = -1;  // General failure
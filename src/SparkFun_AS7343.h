@@ -13,7 +13,7 @@
  * - Toolkit integration
  *
  * @section Class SfeAS7343ArdI2C Class
- * - begin(): Initializes I2C communication
+ * - begin(): Initializes I2C communication, optionally negotiates the I2C clock
  * - isConnected(): Verifies sensor connection
  *
  * @section Dependencies Dependencies
@@ -39,9 +39,25 @@
  // clang-format off
  #include <SparkFun_Toolkit.h>
  #include "sfTk/sfDevAS7343.h"
+ #include "sfTk/sfDevAS7343Acquisition.h"
+ #include "sfTk/sfDevAS7343T.h"
+ #include "sfTk/sfDevAS7343Colorimetry.h"
+ #include "sfTk/sfDevAS7343Flicker.h"
+ #include "sfTk/sfDevAS7343DarkOffsets.h"
+ #include "sfTk/sfDevAS7343Accumulator.h"
+ #include "sfTk/sfDevAS7343Record.h"
+ #include "sfTk/sfDevAS7343Events.h"
+ #include "sfTk/sfDevAS7343Scheduler.h"
  #include <Arduino.h>
  // clang-format on
  
+// I2C clocks begin() can negotiate, see SfeAS7343ArdI2C::begin().
+const uint32_t kAS7343BusClockStandard = 100000;  // Standard mode, what Wire.begin() sets on most cores
+const uint32_t kAS7343BusClockFast = 400000;      // Fast mode
+const uint32_t kAS7343BusClockFastPlus = 1000000; // Fast mode plus, the fastest the AS7343 supports
+
+const uint8_t kAS7343BusClockProbeReads = 8; // ID reads that must all pass for a clock to count as stable
+
 /**
  * @class SfeAS7343ArdI2C
  * @brief Arduino I2C implementation for the AS7343 sensor.
@@ -68,7 +84,7 @@
 class SfeAS7343ArdI2C : public sfDevAS7343
 {
   public:
-    SfeAS7343ArdI2C()
+    SfeAS7343ArdI2C() : _wirePort{nullptr}, _busClockHz{0}, _previousBusClockHz{0}
     {
     }
 
@@ -82,9 +98,20 @@ class SfeAS7343ArdI2C : public sfDevAS7343
      * 3. Sets up communication bus
      * 4. Verifies device connection
      * 5. Calls base class initialization
+     * 6. With maxClockHz set, negotiates the I2C clock (see below)
+     *
+     * The bus clock is left as it is unless maxClockHz is given. Then the
+     * clocks from maxClockHz down (maxClockHz, then kAS7343BusClockFastPlus,
+     * kAS7343BusClockFast and kAS7343BusClockStandard below it) are tried,
+     * and the first one where kAS7343BusClockProbeReads ID reads in a row
+     * all succeed is kept. The bus stays at that clock, getBusClock() has it.
+     * Arduino can't read the clock back, so pass the clock the bus runs at
+     * now for restoreBusClock().
      *
      * @param address I2C address of the device (default: kDefaultAS7343Addr)
      * @param wirePort TwoWire instance to use for I2C communication (default: Wire)
+     * @param maxClockHz Fastest I2C clock to try, 0 to leave the clock alone (default: 0)
+     * @param currentClockHz Clock the bus runs at now (default: kAS7343BusClockStandard)
      *
      * @return true If initialization successful
      * @return false If any initialization step fails
@@ -92,24 +119,88 @@ class SfeAS7343ArdI2C : public sfDevAS7343
      * Example:
      * @code
      * SfeAS7343ArdI2C sensor;
-     * if (!sensor.begin()) {
+     * if (!sensor.begin(kAS7343Addr, Wire, kAS7343BusClockFastPlus)) {
      *     Serial.println("Sensor initialization failed!");
      *     while (1); // halt
      * }
+     * Serial.println(sensor.getBusClock());
      * @endcode
      */
-    bool begin(const uint8_t &address = kAS7343Addr, TwoWire &wirePort = Wire)
+    bool begin(const uint8_t &address = kAS7343Addr, TwoWire &wirePort = Wire, uint32_t maxClockHz = 0,
+               uint32_t currentClockHz = kAS7343BusClockStandard)
     {
         if (_theI2CBus.init(wirePort, address) != ksfTkErrOk)
             return false;
 
+        _wirePort = &wirePort;
+        _busClockHz = 0;
+        _previousBusClockHz = currentClockHz;
+
         setCommunicationBus(&_theI2CBus);
+        setTimestampSource(timestampMicros);
 
         if (!isConnected())
             return false;
+
+        // Base class initialization (fills the shadow register file)
+        if (sfDevAS7343::begin() == false)
+            return false;
+
+        if (maxClockHz)
+            negotiateBusClock(maxClockHz);
+
         return true;
     }
 
+    /**
+     * @brief Initializes, configures, powers on and starts the AS7343 in one pass.
+     *
+     * @details
+     * The fast start sequence, see sfDevAS7343::beginFast(). Right after
+     * power-up the device NAKs while it initializes (about
+     * ksfAS7343InitTimeUs), so the device is pinged until it answers, for up
+     * to twice that time. The ID check then replaces isConnected().
+     *
+     * @param config The configuration to apply, e.g. from getDefaultConfig()
+     * @param firstDataUs Set to the time until the first spectral data is ready, in microseconds
+     * @param address I2C address of the device (default: kDefaultAS7343Addr)
+     * @param wirePort TwoWire instance to use for I2C communication (default: Wire)
+     *
+     * @return true If initialization successful
+     * @return false If any initialization step fails
+     *
+     * Example:
+     * @code
+     * sfe_as7343_config_t config;
+     * SfeAS7343ArdI2C::getDefaultConfig(config);
+     * config.spectralMeasurement = true;
+     *
+     * uint32_t firstDataUs;
+     * if (sensor.beginFast(config, firstDataUs)) {
+     *     delayMicroseconds(firstDataUs); // or sleep, then read
+     * }
+     * @endcode
+     */
+    bool beginFast(const sfe_as7343_config_t &config, uint32_t &firstDataUs, const uint8_t &address = kAS7343Addr,
+                   TwoWire &wirePort = Wire)
+    {
+        if (_theI2CBus.init(wirePort, address) != ksfTkErrOk)
+            return false;
+
+        setCommunicationBus(&_theI2CBus);
+        setTimestampSource(timestampMicros);
+
+        uint32_t startUs = micros();
+
+        while (_theI2CBus.ping() != ksfTkErrOk)
+        {
+            if (micros() - startUs > 2 * (uint32_t)ksfAS7343InitTimeUs)
+                return false;
+        }
+
+        return sfDevAS7343::beginFast(nullptr, config, firstDataUs);
+    }
+
     /**
      * @brief Checks if the AS7343 sensor is connected and responding.
      *
@@ -160,7 +251,81 @@ class SfeAS7343ArdI2C : public sfDevAS7343
         return _theI2CBus.address();
     }
 
+    /**
+     * @brief Gets the I2C clock begin() negotiated for this sensor.
+     *
+     * @return uint32_t The clock in Hz, 0 if begin() didn't negotiate one
+     */
+    uint32_t getBusClock(void)
+    {
+        return _busClockHz;
+    }
+
+    /**
+     * @brief Sets the bus to the clock negotiated for this sensor.
+     *
+     * @details
+     * When devices with different clocks share the bus, call this before
+     * talking to the sensor, and restoreBusClock() after. Does nothing if
+     * begin() didn't negotiate a clock.
+     */
+    void useBusClock(void)
+    {
+        if (_wirePort && _busClockHz)
+            _wirePort->setClock(_busClockHz);
+    }
+
+    /**
+     * @brief Sets the bus back to the clock it ran at before begin().
+     *
+     * @details
+     * The clock passed to begin() as currentClockHz. Does nothing if begin()
+     * didn't negotiate a clock.
+     */
+    void restoreBusClock(void)
+    {
+        if (_wirePort && _busClockHz)
+            _wirePort->setClock(_previousBusClockHz);
+    }
+
   private:
+    /// @brief Find the fastest stable clock up to maxClockHz, and leave the bus at it.
+    /// @param maxClockHz Fastest clock to try, in Hz.
+    void negotiateBusClock(uint32_t maxClockHz)
+    {
+        const uint32_t candidates[] = {maxClockHz, kAS7343BusClockFastPlus, kAS7343BusClockFast,
+                                       kAS7343BusClockStandard};
+
+        for (uint8_t i = 0; i < sizeof(candidates) / sizeof(candidates[0]); i++)
+        {
+            // Only the standard clocks below the maximum, and each one once.
+            if (candidates[i] > maxClockHz || (i > 0 && candidates[i] == maxClockHz))
+                continue;
+
+            _wirePort->setClock(candidates[i]);
+
+            uint8_t goodReads = 0;
+            while (goodReads < kAS7343BusClockProbeReads && getDeviceID() == kDefaultAS7343DeviceID)
+                goodReads++;
+
+            if (goodReads == kAS7343BusClockProbeReads)
+            {
+                _busClockHz = candidates[i];
+                return;
+            }
+        }
+
+        // Nothing was stable, not even the standard clock, so go back to the clock that worked for begin().
+        _wirePort->setClock(_previousBusClockHz);
+        _busClockHz = _previousBusClockHz;
+    }
+
+    /// @brief Timestamp source for the driver, micros() as uint32_t on every core.
+    static uint32_t timestampMicros(void)
+    {
+        return (uint32_t)micros();
+    }
+
     /**
      * @brief Arduino I2C bus interface instance for the AS7343 sensor.
      *
@@ -173,4 +338,23 @@ class SfeAS7343ArdI2C : public sfDevAS7343
      * @see begin()
      */
     sfTkArdI2C _theI2CBus;
-};
\ No newline at end of file
+
+    TwoWire *_wirePort;           // Wire port of the sensor, for the clock changes.
+    uint32_t _busClockHz;         // Clock negotiated by begin(), 0 for none.
+    uint32_t _previousBusClockHz; // Clock the bus ran at before begin().
+};
+
+/**
+ * @brief SfeAS7343ArdI2C with the AutoSmux mode fixed at compile time.
+ *
+ * @details
+ * See sfDevAS7343T. Example usage:
+ * @code
+ * SfeAS7343ArdI2CT<AUTOSMUX_6_CHANNELS> sensor;
+ * if (sensor.begin() && sensor.readSpectraDataFromSensor()) {
+ *     uint16_t nir = sensor.get<CH_NIR_855NM>();
+ * }
+ * @endcode
+ */
+template <sfe_as7343_auto_smux_channel_t SmuxMode>
+using SfeAS7343ArdI2CT = sfDevAS7343T<SmuxMode, SfeAS7343ArdI2C>;
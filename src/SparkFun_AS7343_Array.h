@@ -0,0 +1,467 @@
+/**
+ * @file SparkFun_AS7343_Array.h
+ * @brief Arduino manager for many AS7343 sensors behind TCA9548A I2C muxes.
+ *
+ * @details
+ * Every AS7343 answers at the same I2C address (0x39), so more than one per
+ * bus needs a mux. SfeAS7343ArdI2CArray owns one SfeAS7343ArdI2C per sensor,
+ * switches the mux channel whenever a different sensor is addressed, starts
+ * the sensors' measurements staggered across one frame period, and then
+ * reads them round-robin as each one finishes. While one sensor is read the
+ * others integrate, so the bus stays busy and readouts don't pile up.
+ *
+ * For frame by frame comparisons the array can instead start all sensors
+ * on the same edge: arm(), trigger(), then readCapture().
+ *
+ * @author SparkFun Electronics
+ * @date 2026
+ * @copyright Copyright (c) 2026, SparkFun Electronics Inc. This project is released under the MIT License.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * @section Repository Repository
+ * https://github.com/sparkfun/SparkFun_AS7343_Arduino_Library
+ */
+
+#pragma once
+
+#include "SparkFun_AS7343.h"
+
+const uint8_t kTCA9548AAddr = 0x70;        // Default I2C address of a TCA9548A mux (0x70-0x77)
+const uint8_t kTCA9548ANumChannels = 8;    // Channels per TCA9548A
+const uint8_t ksfAS7343NoMux = 0x00;       // Mux address of a sensor connected straight to the bus
+
+/**
+ * @class SfeAS7343ArdI2CArray
+ * @brief Manager for up to N AS7343 sensors on one I2C bus.
+ *
+ * @details
+ * Usage:
+ * @code
+ * SfeAS7343ArdI2CArray<8> myArray;
+ *
+ * // setup(): for (uint8_t ch = 0; ch < 8; ch++) myArray.addSensor(kTCA9548AAddr, ch);
+ * //          myArray.begin(); ...configure each getSensor(i)... myArray.start();
+ * // loop():  if (myArray.service(frame, index)) { ... }
+ * @endcode
+ *
+ * Always reach a sensor through getSensor(), which selects its mux channel
+ * first. A pointer kept from an earlier call talks to whichever sensor is
+ * selected at the time.
+ *
+ * @tparam N Maximum number of sensors.
+ */
+template <uint8_t N> class SfeAS7343ArdI2CArray
+{
+  public:
+    SfeAS7343ArdI2CArray()
+        : _wirePort{nullptr}, _numSensors{0}, _activeMux{ksfAS7343NoMux}, _activeChannel{0}, _muxValid{false},
+          _next{0}, _frameCount{0}, _triggerUs{0}, _captureValid{false}
+    {
+    }
+
+    /// @brief Add a sensor to the array.
+    /// @param muxAddress I2C address of the mux the sensor sits behind, or
+    /// ksfAS7343NoMux if it is connected straight to the bus.
+    /// @param muxChannel Mux channel of the sensor, 0-7.
+    /// @param address I2C address of the sensor.
+    /// @return True if successful, false if the array is full or the channel is invalid.
+    bool addSensor(uint8_t muxAddress = kTCA9548AAddr, uint8_t muxChannel = 0, uint8_t address = kAS7343Addr)
+    {
+        if (_numSensors >= N || muxChannel >= kTCA9548ANumChannels)
+            return false;
+
+        _entries[_numSensors].muxAddress = muxAddress;
+        _entries[_numSensors].muxChannel = muxChannel;
+        _entries[_numSensors].address = address;
+        _entries[_numSensors].periodUs = 0;
+        _entries[_numSensors].nextDueUs = 0;
+        _entries[_numSensors].captured = false;
+        _numSensors++;
+
+        return true;
+    }
+
+    /// @brief Initialize every sensor in the array.
+    /// @param wirePort TwoWire instance the sensors and muxes are on.
+    /// @return True if every sensor began, false if any failed.
+    bool begin(TwoWire &wirePort = Wire)
+    {
+        _wirePort = &wirePort;
+        _muxValid = false;
+
+        bool ok = _numSensors > 0;
+
+        for (uint8_t i = 0; i < _numSensors; i++)
+        {
+            if (select(i) == false || _entries[i].sensor.begin(_entries[i].address, wirePort) == false)
+                ok = false;
+        }
+
+        return ok;
+    }
+
+    /// @brief Get the number of sensors in the array.
+    /// @return The number of sensors added with addSensor().
+    uint8_t size(void) const
+    {
+        return _numSensors;
+    }
+
+    /// @brief Select a sensor's mux channel and get the sensor.
+    /// @param index Index of the sensor, in the order it was added.
+    /// @return Pointer to the sensor, nullptr if the index is invalid or the
+    /// mux could not be switched.
+    SfeAS7343ArdI2C *getSensor(uint8_t index)
+    {
+        if (select(index) == false)
+            return nullptr;
+
+        return &_entries[index].sensor;
+    }
+
+    /// @brief Power on every sensor and start their measurements staggered.
+    /// @details Each sensor's frame period comes from getFramePeriodUs(), so
+    /// configure the sensors (integration time, wait time, AutoSmux) first.
+    /// The starts are spread evenly across the longest period, so each
+    /// sensor finishes at a different time. This method blocks for up to
+    /// one frame period while it staggers the starts.
+    /// @return True if successful, false if it fails.
+    bool start(void)
+    {
+        uint32_t longestUs = 0;
+
+        // Power on and stop every sensor, and find the longest period.
+        for (uint8_t i = 0; i < _numSensors; i++)
+        {
+            SfeAS7343ArdI2C *sensor = getSensor(i);
+
+            if (!sensor || sensor->powerOn() == false || sensor->disableSpectralMeasurement() == false)
+                return false;
+
+            _entries[i].periodUs = sensor->getFramePeriodUs();
+            if (_entries[i].periodUs == 0)
+                return false;
+
+            if (_entries[i].periodUs > longestUs)
+                longestUs = _entries[i].periodUs;
+        }
+
+        uint32_t slotUs = _numSensors ? longestUs / _numSensors : 0;
+        uint32_t startUs = micros();
+
+        for (uint8_t i = 0; i < _numSensors; i++)
+        {
+            // Wait for this sensor's slot.
+            while ((uint32_t)(micros() - startUs) < i * slotUs)
+                ;
+
+            SfeAS7343ArdI2C *sensor = getSensor(i);
+
+            if (!sensor || sensor->enableSpectralMeasurement() == false)
+                return false;
+
+            _entries[i].nextDueUs = micros() + _entries[i].periodUs;
+        }
+
+        _next = 0;
+
+        return true;
+    }
+
+    /// @brief Stop the measurements of every sensor.
+    /// @return True if successful, false if it fails.
+    bool stop(void)
+    {
+        bool ok = true;
+
+        for (uint8_t i = 0; i < _numSensors; i++)
+        {
+            SfeAS7343ArdI2C *sensor = getSensor(i);
+
+            if (!sensor || sensor->disableSpectralMeasurement() == false)
+                ok = false;
+        }
+
+        return ok;
+    }
+
+    /// @brief Read the next sensor whose measurement is due.
+    /// @details Call this as often as possible from the loop. The sensors are
+    /// visited round-robin, starting after the one read last. The first one
+    /// whose frame period has passed is read with readFrame(). If its data is
+    /// not valid yet it is retried on the next call. Returns at once, without
+    /// bus traffic, when no sensor is due.
+    /// @param frame Reference to the frame to fill, the timestamp is the
+    /// micros() of the read.
+    /// @param index Reference to store the index of the sensor read.
+    /// @return True if a valid frame was read, false otherwise.
+    bool service(sfe_as7343_frame_t &frame, uint8_t &index)
+    {
+        uint32_t now = micros();
+
+        for (uint8_t k = 0; k < _numSensors; k++)
+        {
+            uint8_t i = (_next + k) % _numSensors;
+            entry_t &entry = _entries[i];
+
+            if ((int32_t)(now - entry.nextDueUs) < 0)
+                continue;
+
+            _next = (i + 1) % _numSensors;
+
+            SfeAS7343ArdI2C *sensor = getSensor(i);
+
+            if (!sensor || sensor->readFrame(frame) == false || !frame.valid)
+                return false;
+
+            frame.timestamp = now;
+            index = i;
+            _frameCount++;
+
+            // Stay on the original grid, unless a whole period was missed.
+            entry.nextDueUs += entry.periodUs;
+            if ((int32_t)(now - entry.nextDueUs) >= 0)
+                entry.nextDueUs = now + entry.periodUs;
+
+            return true;
+        }
+
+        return false;
+    }
+
+    /// @brief Arm every sensor for a synchronized capture.
+    /// @details Calls armSpectralMeasurement() on each sensor. Configure the
+    /// sensors first, they must all share one I2C address and the same
+    /// ENABLE setting (wait time, flicker detection), since trigger() starts
+    /// them with one write.
+    /// @return True if successful, false if it fails or the sensors differ.
+    bool arm(void)
+    {
+        _captureValid = false;
+
+        for (uint8_t i = 0; i < _numSensors; i++)
+        {
+            SfeAS7343ArdI2C *sensor = getSensor(i);
+
+            if (!sensor || sensor->armSpectralMeasurement() == false)
+                return false;
+
+            _entries[i].periodUs = sensor->getFramePeriodUs();
+
+            if (_entries[i].periodUs == 0 || _entries[i].address != _entries[0].address ||
+                sensor->getTriggerEnableValue() != _entries[0].sensor.getTriggerEnableValue())
+                return false;
+        }
+
+        return _numSensors > 0;
+    }
+
+    /// @brief Start the measurement of every armed sensor on the same edge.
+    /// @details Connects the mux channels of all sensors at once, then writes
+    /// the ENABLE register a single time. Every sensor receives that write
+    /// together and starts integrating at the same STOP condition, so there
+    /// is no skew between sensors from sequencing the starts. The mux
+    /// channels are narrowed again on the next sensor access.
+    /// @return True if successful, false if it fails or a sensor isn't armed.
+    bool trigger(void)
+    {
+        if (!_wirePort || _numSensors == 0)
+            return false;
+
+        for (uint8_t i = 0; i < _numSensors; i++)
+        {
+            if (_entries[i].sensor.isArmed() == false)
+                return false;
+        }
+
+        // The channels of all sensors, per mux, written once to each mux.
+        _muxValid = false;
+
+        for (uint8_t i = 0; i < _numSensors; i++)
+        {
+            uint8_t mux = _entries[i].muxAddress;
+
+            if (mux == ksfAS7343NoMux || !firstOnMux(i))
+                continue;
+
+            uint8_t mask = 0;
+
+            for (uint8_t j = i; j < _numSensors; j++)
+            {
+                if (_entries[j].muxAddress == mux)
+                    mask |= 1 << _entries[j].muxChannel;
+            }
+
+            if (writeMux(mux, mask) == false)
+                return false;
+        }
+
+        // One write reaches every sensor.
+        _wirePort->beginTransmission(_entries[0].address);
+        _wirePort->write(ksfAS7343RegEnable);
+        _wirePort->write(_entries[0].sensor.getTriggerEnableValue());
+
+        if (_wirePort->endTransmission() != 0)
+            return false;
+
+        _triggerUs = micros();
+
+        for (uint8_t i = 0; i < _numSensors; i++)
+        {
+            _entries[i].sensor.setTriggered();
+            _entries[i].nextDueUs = _triggerUs + _entries[i].periodUs;
+            _entries[i].captured = false;
+        }
+
+        _captureValid = true;
+
+        return true;
+    }
+
+    /// @brief Collect the frames of the last trigger().
+    /// @details Returns at once, without bus traffic, until the sensors'
+    /// frame period has passed. Then reads each sensor that hasn't been read
+    /// yet, one readFrame() burst per sensor. Call it again until it returns
+    /// true, a sensor whose data is not valid yet is retried on the next call.
+    /// @param frames Array of size() frames, indexed like the sensors. Every
+    /// timestamp is the micros() of the trigger.
+    /// @param count Number of frames in the array.
+    /// @return True once the frames of all sensors are read, false otherwise.
+    bool readCapture(sfe_as7343_frame_t *frames, uint8_t count)
+    {
+        if (!frames || count < _numSensors || !_captureValid)
+            return false;
+
+        uint32_t now = micros();
+        bool complete = true;
+
+        for (uint8_t i = 0; i < _numSensors; i++)
+        {
+            entry_t &entry = _entries[i];
+
+            if (entry.captured)
+                continue;
+
+            if ((int32_t)(now - entry.nextDueUs) < 0)
+            {
+                complete = false;
+                continue;
+            }
+
+            SfeAS7343ArdI2C *sensor = getSensor(i);
+
+            if (!sensor || sensor->readFrame(frames[i]) == false || !frames[i].valid)
+            {
+                complete = false;
+                continue;
+            }
+
+            frames[i].timestamp = _triggerUs;
+            entry.captured = true;
+            _frameCount++;
+        }
+
+        if (complete)
+            _captureValid = false;
+
+        return complete;
+    }
+
+    /// @brief Get the number of frames read by service() and readCapture().
+    /// @return The number of frames, across all sensors, since begin().
+    uint32_t getFrameCount(void) const
+    {
+        return _frameCount;
+    }
+
+  private:
+    /// @brief Switch the muxes so that only the given sensor is connected.
+    bool select(uint8_t index)
+    {
+        if (index >= _numSensors || !_wirePort)
+            return false;
+
+        const entry_t &entry = _entries[index];
+
+        // Already selected, no bus traffic is needed.
+        if (_muxValid && _activeMux == entry.muxAddress &&
+            (entry.muxAddress == ksfAS7343NoMux || _activeChannel == entry.muxChannel))
+            return true;
+
+        // Disconnect the channel of another mux first, its sensor shares the address. If the
+        // mux state is unknown (at begin(), after trigger()) disconnect every other mux.
+        if (_muxValid && _activeMux != entry.muxAddress && _activeMux != ksfAS7343NoMux)
+        {
+            if (writeMux(_activeMux, 0) == false)
+                return false;
+        }
+        else if (!_muxValid)
+        {
+            for (uint8_t i = 0; i < _numSensors; i++)
+            {
+                uint8_t mux = _entries[i].muxAddress;
+
+                if (mux == ksfAS7343NoMux || mux == entry.muxAddress || !firstOnMux(i))
+                    continue;
+
+                if (writeMux(mux, 0) == false)
+                    return false;
+            }
+        }
+
+        _muxValid = false;
+
+        if (entry.muxAddress != ksfAS7343NoMux && writeMux(entry.muxAddress, 1 << entry.muxChannel) == false)
+            return false;
+
+        _activeMux = entry.muxAddress;
+        _activeChannel = entry.muxChannel;
+        _muxValid = true;
+
+        return true;
+    }
+
+    /// @brief Check if a sensor is the first one added behind its mux.
+    bool firstOnMux(uint8_t index) const
+    {
+        for (uint8_t i = 0; i < index; i++)
+        {
+            if (_entries[i].muxAddress == _entries[index].muxAddress)
+                return false;
+        }
+
+        return true;
+    }
+
+    /// @brief Write the channel mask of a TCA9548A.
+    bool writeMux(uint8_t muxAddress, uint8_t channelMask)
+    {
+        _wirePort->beginTransmission(muxAddress);
+        _wirePort->write(channelMask);
+
+        return _wirePort->endTransmission() == 0;
+    }
+
+    typedef struct
+    {
+        SfeAS7343ArdI2C sensor; // Driver of this sensor.
+        uint8_t muxAddress;     // Mux address, or ksfAS7343NoMux.
+        uint8_t muxChannel;     // Mux channel.
+        uint8_t address;        // Sensor I2C address.
+        uint32_t periodUs;      // Frame period, from getFramePeriodUs().
+        uint32_t nextDueUs;     // micros() when the next frame is due.
+        bool captured;          // True once the frame of the last trigger() is read.
+    } entry_t;
+
+    TwoWire *_wirePort;   // Bus of the sensors and muxes.
+    entry_t _entries[N];  // The sensors.
+    uint8_t _numSensors;  // Number of sensors added.
+    uint8_t _activeMux;   // Mux of the selected sensor.
+    uint8_t _activeChannel; // Mux channel of the selected sensor.
+    bool _muxValid;       // True when _activeMux / _activeChannel match the hardware.
+    uint8_t _next;        // Sensor to look at first in service().
+    uint32_t _frameCount; // Frames read by service() and readCapture().
+    uint32_t _triggerUs;  // micros() of the last trigger().
+    bool _captureValid;   // True from trigger() until readCapture() has every frame.
+};
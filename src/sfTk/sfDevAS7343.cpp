@@ -25,11 +25,67 @@
  * @see https://github.com/sparkfun/SparkFun_AS7343_Arduino_Library
  */
 #include "sfDevAS7343.h"
+#include "sfDevAS7343DarkOffsets.h"
+
+#include <string.h>
+
+#ifdef SFE_AS7343_STATS
+// Count an API call for the bus instrumentation, until the end of the enclosing scope.
+#define SFE_AS7343_STATS_SCOPE(op) StatsScope statsScope(this, op)
+#else
+#define SFE_AS7343_STATS_SCOPE(op)
+#endif
 
 const uint8_t ksfLEDMaxCurrentDrive = 127; // Maximum LED drive current
 
 const uint8_t ksfRegisterBank0Limit = 0x80; // start of the bank 0 registers
 
+// Register address of each entry in the shadow register file, indexed by sfe_as7343_shadow_reg_t.
+static const uint8_t ksfShadowRegAddr[] = {
+    ksfAS7343RegCfg10,       ksfAS7343RegCfg12,          ksfAS7343RegGpio,           ksfAS7343RegEnable,
+    ksfAS7343RegATime,       ksfAS7343RegWTime,          ksfAS7343RegSpThL,          ksfAS7343RegSpThL + 1,
+    ksfAS7343RegSpThH,       ksfAS7343RegSpThH + 1,      ksfAS7343RegCfg1,           ksfAS7343RegCfg3,
+    ksfAS7343RegCfg8,        ksfAS7343RegCfg9,           ksfAS7343RegLed,            ksfAS7343RegPers,
+    ksfAS7343RegAStep,       ksfAS7343RegAStep + 1,      ksfAS7343RegCfg20,          ksfAS7343RegAgcGainMax,
+    ksfAS7343RegAzConfig,    ksfAS7343RegFdTimeCfg0,     ksfAS7343RegFdTime1,        ksfAS7343RegFdTime2,
+    ksfAS7343RegIntEnab,     ksfAS7343RegFifoMap};
+
+// Reciprocal of each AGAIN step (0.5x to 2048x), indexed by sfe_as7343_again_t.
+static constexpr float ksfGainReciprocal[] = {2.0f,          1.0f,          1.0f / 2,    1.0f / 4,   1.0f / 8,
+                                              1.0f / 16,     1.0f / 32,     1.0f / 64,   1.0f / 128, 1.0f / 256,
+                                              1.0f / 512,    1.0f / 1024,   1.0f / 2048};
+
+static_assert(sizeof(ksfGainReciprocal) / sizeof(ksfGainReciprocal[0]) == AGAIN_2048 + 1,
+              "Gain reciprocal table out of sync");
+
+// Auto-ranging drops the gain this many steps (x1/16) after a saturated frame.
+const uint8_t ksfAutoGainSaturationSteps = 4;
+
+// Sequence number of a data buffer that is being written.
+const uint32_t ksfDataSequenceBusy = 0xFFFFFFFF;
+
+// Order the data buffer writes and reads against the sequence numbers, also across cores.
+static inline void sfDataBarrier(void)
+{
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+}
+
+// STATUS2, STATUS3, (0x92), STATUS and ASTATUS come right before the data registers.
+const uint8_t ksfFrameHeaderBytes = ksfAS7343RegData0 - ksfAS7343RegStatus2;
+
+// While batching writes, unchanged registers between two changed ones are rewritten (with their
+// current value) rather than starting a new transaction, up to this many in a row.
+const uint8_t ksfConfigMaxCleanRun = 2;
+
+static_assert(sizeof(ksfShadowRegAddr) == SHADOW_NUM_REGS, "Shadow register address table out of sync");
+
+// When filling the shadow, neighbouring registers are read in one burst as long as the gap of
+// unused addresses between them is at most this many bytes...
+const uint8_t ksfShadowMaxBurstGap = 8;
+
+// ... and the burst stays within the smallest common I2C buffer (32 bytes on AVR).
+const uint8_t ksfShadowMaxBurstLen = 32;
+
 bool sfDevAS7343::begin(sfTkIBus *theBus)
 {
     // Nullptr check.
@@ -40,7 +96,63 @@ bool sfDevAS7343::begin(sfTkIBus *theBus)
     if (theBus != nullptr)
         setCommunicationBus(theBus);
 
-    return true; // Return true to indicate success
+    // Fill the shadow register file, so setters don't need to read before they write.
+    return syncShadowRegisters();
+}
+
+bool sfDevAS7343::beginFast(sfTkIBus *theBus, const sfe_as7343_config_t &config, uint32_t &firstDataUs)
+{
+    firstDataUs = 0;
+
+    // Nullptr check.
+    if (!_theBus && !theBus)
+        return false;
+
+    if (theBus != nullptr)
+        setCommunicationBus(theBus);
+
+    // The ID read leaves bank 1 selected, which is where the shadow fill starts.
+    if (getDeviceID() != kDefaultAS7343DeviceID)
+        return false;
+
+    if (syncShadowRegisters() == false)
+        return false;
+
+    // Configuration and power on in one batch, ENABLE last. If it errors, then return false.
+    if (writeConfig(config, true) == false)
+        return false;
+
+    if (!config.spectralMeasurement)
+        return true;
+
+    // One measurement, plus the auto zero unless it is switched off (AZ_CONFIG 0).
+    uint32_t integrationUs = getIntegrationTimeUs();
+    uint8_t numChannels = getAutoSmuxChannelCount();
+
+    firstDataUs = (integrationUs + _cycleOverheadUs) * (numChannels / 6);
+
+    if (_shadow[SHADOW_AZ_CONFIG] != 0)
+        firstDataUs += ksfAS7343AutoZeroTimeUs;
+
+    return true;
+}
+
+void sfDevAS7343::getDefaultConfig(sfe_as7343_config_t &config)
+{
+    config.again = AGAIN_256;
+    config.atime = 0;
+    config.astep = 999;
+    config.wtime = 0;
+    config.autoSmux = AUTOSMUX_6_CHANNELS;
+    config.ledDrive = 4;
+    config.ledOn = false;
+    config.spThL = 0;
+    config.spThH = 0;
+    config.apers = 0;
+    config.spThCh = SPECTRAL_THRESHOLD_CHANNEL_0;
+    config.spectralMeasurement = false;
+    config.waitTime = false;
+    config.flickerDetection = false;
 }
 
 uint8_t sfDevAS7343::getDeviceID(void)
@@ -57,43 +169,93 @@ uint8_t sfDevAS7343::getDeviceID(void)
 void sfDevAS7343::setCommunicationBus(sfTkIBus *theBus)
 {
     _theBus = theBus;
+
+    // The new bus may talk to a device in any state, so the shadows can no longer be trusted.
+    _cfg0Valid = false;
+    _shadowValid = false;
 }
 
-bool sfDevAS7343::setRegisterBank(sfe_as7343_reg_bank_t regBank)
+bool sfDevAS7343::setCommunicationBus(sfTkIBus *theBus, sfDevAS7343AsyncBus *asyncBus)
 {
+    // The read in flight belongs to the old buses.
+    if (poll() == READ_STATE_BUSY)
+        return false;
 
-    sfe_as7343_reg_cfg0_t cfg0; // Create a register structure for CFG0
+    setCommunicationBus(theBus);
+
+    return setAsyncBus(asyncBus);
+}
+
+bool sfDevAS7343::setRegisterBank(sfe_as7343_reg_bank_t regBank)
+{
+    // Nullptr check.
+    if (!_theBus)
+        return false;
 
-    // Read the cfg0 register (to retain other bits), if it errors then return 0.
-    if (ksfTkErrOk != _theBus->readRegister(ksfAS7343RegCfg0, cfg0.byte))
+    // Load the CFG0 shadow (to retain other bits) the first time through, if it errors then return false.
+    if (loadCfg0() == false)
         return false;
 
+    uint8_t bank = (regBank == REG_BANK_1) ? 1 : 0;
+
+    // The device is already on the requested bank, so no bus traffic is needed.
+    if (_cfg0.reg_bank == bank)
+        return true;
+
+    sfe_as7343_reg_cfg0_t cfg0 = _cfg0; // Start from the shadow copy of CFG0
+
     // set the reg_bank bit as set by the incoming argument
-    if (regBank == REG_BANK_1)
-        cfg0.reg_bank = 1;
-    else
-        cfg0.reg_bank = 0;
+    cfg0.reg_bank = bank;
 
-    // Write the cfg0 register to the device. If it errors, then return 0.
-    if (ksfTkErrOk != _theBus->writeRegister(ksfAS7343RegCfg0, cfg0.byte))
+    // Write the cfg0 register to the device. If it errors, drop the shadow (the device state
+    // is unknown now) and return false.
+    if (ksfTkErrOk != busWriteRegister(ksfAS7343RegCfg0, cfg0.byte))
+    {
+        _cfg0Valid = false;
         return false;
+    }
+
+    _cfg0 = cfg0;
+
+#ifdef SFE_AS7343_STATS
+    _stats.op[_statsOp].bankSwitches++;
+#endif
 
     return true; // Return true to indicate success
 }
 
+bool sfDevAS7343::loadCfg0(void)
+{
+    // Nullptr check.
+    if (!_theBus)
+        return false;
+
+    // Already loaded, no bus traffic is needed.
+    if (_cfg0Valid)
+        return true;
+
+    // CFG0 is reachable from both banks, so no bank switch is needed.
+    if (ksfTkErrOk != busReadRegister(ksfAS7343RegCfg0, _cfg0.byte))
+        return false;
+
+    _cfg0Valid = true;
+
+    return true;
+}
+
 bool sfDevAS7343::powerOn(bool power)
 {
     sfe_as7343_reg_enable_t enableReg; // Create a register structure for the Enable register
 
-    // Read the enable register, if it errors then return false.
-    if (readRegisterBank(ksfAS7343RegID, enableReg.byte) == false)
+    // Load the enable register from the shadow (to retain other bit settings), if it errors then return false.
+    if (readShadowRegister(SHADOW_ENABLE, enableReg.byte) == false)
         return false;
 
     // Set the PON bit according to the incoming argument
     enableReg.pon = power ? 1 : 0;
 
     // Write the Enable register to the device. If it errors, then return false.
-    if (ksfTkErrOk != _theBus->writeRegister(ksfAS7343RegEnable, enableReg.byte))
+    if (writeShadowRegister(SHADOW_ENABLE, enableReg.byte) == false)
         return false;
 
     return true;
@@ -108,15 +270,15 @@ bool sfDevAS7343::enableSpectralMeasurement(bool enable)
 {
     sfe_as7343_reg_enable_t enableReg; // Create a register structure for the Enable register
 
-    // Read the enable register (to retain other bit settings), if it errors then return false.
-    if (readRegisterBank(ksfAS7343RegEnable, enableReg.byte) == false)
+    // Load the enable register from the shadow (to retain other bit settings), if it errors then return false.
+    if (readShadowRegister(SHADOW_ENABLE, enableReg.byte) == false)
         return false;
 
     // Set the SP_EN bit according to the incoming argument
     enableReg.sp_en = enable ? 1 : 0;
 
     // Write the Enable register to the device. If it errors, then return false.
-    if (ksfTkErrOk != _theBus->writeRegister(ksfAS7343RegEnable, enableReg.byte))
+    if (writeShadowRegister(SHADOW_ENABLE, enableReg.byte) == false)
         return false;
 
     return true;
@@ -127,525 +289,2481 @@ bool sfDevAS7343::disableSpectralMeasurement(void)
     return enableSpectralMeasurement(false);
 }
 
-bool sfDevAS7343::readSpectraDataFromSensor(void)
+bool sfDevAS7343::armSpectralMeasurement(void)
 {
-    // Nullptr check.
-    if (!_theBus)
+    _armed = false;
+
+    // Power on with the measurement stopped, if it errors then return false.
+    if (powerOn() == false || disableSpectralMeasurement() == false)
         return false;
 
-    // Set the register bank to 0 to access the data registers.
+    // ENABLE is in bank 0, select it now so the trigger is a single write.
     if (setRegisterBank(REG_BANK_0) == false)
         return false;
 
-    // Calculate the number of data bytes to read.
-    uint8_t numOfDataBytes = ksfAS7343NumChannels * sizeof(sfe_as7343_reg_data_t);
-
-    size_t nRead = 0; // Create a variable to hold the number of bytes read.
+    uint8_t status;
 
-    if (ksfTkErrOk != _theBus->readRegister(ksfAS7343RegData0, (uint8_t *)_data, numOfDataBytes, nRead))
+    // Clear the flags of earlier measurements, so the next ones belong to the trigger.
+    if (readStatusReg(status) == false || clearStatusReg(status) == false)
         return false;
 
-    // Check if the number of bytes read is correct.
-    if (nRead != numOfDataBytes)
-        return false;
+    _armed = true;
 
     return true;
 }
 
-uint16_t sfDevAS7343::getChannelData(sfe_as7343_channel_t channel)
+bool sfDevAS7343::isArmed(void)
 {
-    // Check if the channel is valid (0-17).
-    if (channel >= ksfAS7343NumChannels)
-        return 0;
+    if (!_armed || !_cfg0Valid || _cfg0.reg_bank != 0)
+        return false;
 
-    // Return the data for the specified channel.
-    return _data[channel].word;
+    sfe_as7343_reg_enable_t enableReg;
+    enableReg.byte = _shadow[SHADOW_ENABLE];
+
+    // Anything that stopped the device, or started it, ends the armed state.
+    return _shadowValid && enableReg.pon && !enableReg.sp_en;
 }
 
-uint8_t sfDevAS7343::getData(uint16_t *data, size_t size)
+uint8_t sfDevAS7343::getTriggerEnableValue(void)
 {
-    // Check if the data pointer is valid and the size is valid
-    if (!data || size > ksfAS7343NumChannels)
+    if (!isArmed())
         return 0;
 
-    uint8_t nWritten = 0; // keep track of how many data bytes were written
-
-    // Copy the data from the internal buffer to the provided array.
-    for (size_t i = 0; i < size; i++)
-        data[i] = _data[i].word;
-
-    nWritten = size;
+    sfe_as7343_reg_enable_t enableReg;
+    enableReg.byte = _shadow[SHADOW_ENABLE];
+    enableReg.sp_en = 1;
 
-    return nWritten;
+    return enableReg.byte;
 }
 
-bool sfDevAS7343::setAutoSmux(sfe_as7343_auto_smux_channel_t auto_smux)
+bool sfDevAS7343::triggerSpectralMeasurement(void)
 {
-    sfe_as7343_reg_cfg20_t cfg20; // Create a register structure for the CFG20 register
+    if (!isArmed())
+        return false;
 
-    // Read the CFG20 register (to retain other bit settings), if it errors then return false.
-    if (readRegisterBank(ksfAS7343RegCfg20, cfg20.byte) == false)
+    // Bank 0 is already selected, so this is the only bus transaction, if it errors then return false.
+    if (ksfTkErrOk != busWriteRegister(ksfAS7343RegEnable, getTriggerEnableValue()))
         return false;
 
-    // Set the auto_smux bits according to the incoming argument
-    cfg20.auto_smux = auto_smux;
+    return setTriggered();
+}
 
-    // Write the CFG20 register to the device. If it errors, then return false.
-    if (ksfTkErrOk != _theBus->writeRegister(ksfAS7343RegCfg20, cfg20.byte))
+bool sfDevAS7343::setTriggered(void)
+{
+    if (!isArmed())
         return false;
 
+    _shadow[SHADOW_ENABLE] = getTriggerEnableValue();
+    _armed = false;
+
     return true;
 }
 
-bool sfDevAS7343::ledOn(bool ledOn)
+bool sfDevAS7343::readSpectraDataFromSensor(void)
 {
-    sfe_as7343_reg_led_t ledReg; // Create a register structure for the LED register
+    SFE_AS7343_STATS_SCOPE(STATS_OP_READ_DATA);
 
-    // Read the LED register (to retain other bit settings), if it errors then return 0.
-    if (readRegisterBank(ksfAS7343RegLed, ledReg.byte) == false)
+    // Nullptr check.
+    if (!_theBus)
         return false;
 
-    // Set the LED_ACT bit according to the incoming argument
-    ledReg.led_act = ledOn ? 1 : 0;
+    // Get the channels to read (from the AutoSmux setting and the channel mask).
+    uint8_t first, count;
+    if (getReadWindow(first, count) == false)
+        return false;
 
-    // Write the LED register to the device. If it errors, then return false.
-    if (ksfTkErrOk != _theBus->writeRegister(ksfAS7343RegLed, ledReg.byte))
+    // Set the register bank to 0 to access the data registers.
+    if (setRegisterBank(REG_BANK_0) == false)
+        return false;
+
+    // Calculate the number of data bytes to read.
+    uint8_t numOfDataBytes = count * sizeof(sfe_as7343_reg_data_t);
+
+    size_t nRead = 0; // Create a variable to hold the number of bytes read.
+
+    // Read into the back buffer in place, the front stays intact if the read fails. Mark it as
+    // being written first, for readers still copying it.
+    _dataSequence[_front ^ 1] = ksfDataSequenceBusy;
+    sfDataBarrier();
+
+    uint8_t *raw = (uint8_t *)&_data[_front ^ 1][first];
+
+    if (ksfTkErrOk != busReadRegister(ksfAS7343RegData0 + first * sizeof(sfe_as7343_reg_data_t), raw, numOfDataBytes,
+                                      nRead))
+        return false;
+
+    // Check if the number of bytes read is correct.
+    if (nRead != numOfDataBytes)
         return false;
 
+    unpackSpectraData(raw, first, count);
+
     return true;
 }
 
-bool sfDevAS7343::ledOff(void)
+bool sfDevAS7343::readSpectraDataFromSensor(uint16_t *data, size_t size)
 {
-    return ledOn(false);
-}
+    SFE_AS7343_STATS_SCOPE(STATS_OP_READ_DATA);
 
-bool sfDevAS7343::setLedDrive(uint8_t drive)
-{
-    // Check if the drive current is within the valid range (0-ksfMaxCurrentDrive(127)).
-    if (drive > ksfLEDMaxCurrentDrive)
+    // Nullptr check.
+    if (!_theBus || !data)
         return false;
 
-    sfe_as7343_reg_led_t ledReg; // Create a register structure for the LED register
+    // Get the channels to read (from the AutoSmux setting and the channel mask).
+    uint8_t first, count;
+    if (getReadWindow(first, count) == false || (size_t)first + count > size)
+        return false;
 
-    // Read the LED register (to retain other bit settings), if it errors then return 0.
-    if (readRegisterBank(ksfAS7343RegLed, ledReg.byte) == false)
+    // Set the register bank to 0 to access the data registers.
+    if (setRegisterBank(REG_BANK_0) == false)
         return false;
 
-    // Set the LED drive current according to the incoming argument
-    ledReg.led_drive = drive;
+    uint8_t numOfDataBytes = count * sizeof(uint16_t);
+    size_t nRead = 0;
 
-    // Write the LED register to the device. If it errors, then return false.
-    if (ksfTkErrOk != _theBus->writeRegister(ksfAS7343RegLed, ledReg.byte))
+    // The raw bytes land in the caller's buffer, right where their words go.
+    uint8_t *raw = (uint8_t *)&data[first];
+
+    if (ksfTkErrOk != busReadRegister(ksfAS7343RegData0 + first * sizeof(uint16_t), raw, numOfDataBytes, nRead) ||
+        nRead != numOfDataBytes)
         return false;
 
+    // DATAx_L comes first. Each word only depends on its own two bytes, so convert in place.
+    for (uint8_t i = 0; i < count; i++)
+        data[first + i] = (uint16_t)raw[2 * i] | ((uint16_t)raw[2 * i + 1] << 8);
+
     return true;
 }
 
-uint16_t sfDevAS7343::getRed(void)
+bool sfDevAS7343::readFrame(sfe_as7343_frame_t &frame)
 {
-    // Return the data for the red channel (F7).
-    return getChannelData(CH_RED_F7_690NM);
-}
+    SFE_AS7343_STATS_SCOPE(STATS_OP_READ_FRAME);
 
-uint16_t sfDevAS7343::getGreen(void)
-{
-    // Return the data for the green channel (F5).
-    return getChannelData(CH_GREEN_F5_550NM);
-}
+    // Nullptr check.
+    if (!_theBus)
+        return false;
 
-uint16_t sfDevAS7343::getBlue(void)
-{
-    // Return the data for the blue channel (FZ).
-    return getChannelData(CH_BLUE_FZ_450NM);
-}
+    // Get the channels to read (from the AutoSmux setting and the channel mask).
+    uint8_t first, count;
+    if (getReadWindow(first, count) == false)
+        return false;
 
-uint16_t sfDevAS7343::getNIR(void)
-{
-    // Return the data for the NIR channel (NIR).
-    return getChannelData(CH_NIR_855NM);
-}
+    // Set the register bank to 0 to access the status and data registers.
+    if (setRegisterBank(REG_BANK_0) == false)
+        return false;
 
-bool sfDevAS7343::setSpectralIntThresholdHigh(uint16_t spThH)
-{
-    // Write both LSB and MSB in the same I2C write. If it errors, then return false.
-    if (ksfTkErrOk != _theBus->writeRegister(ksfAS7343RegSpThH, (uint8_t *)&spThH, 2))
+    // The burst always starts at STATUS2, so it runs up to the last channel in the window.
+    uint8_t raw[ksfFrameHeaderBytes + ksfAS7343NumChannels * sizeof(sfe_as7343_reg_data_t)];
+    size_t numBytes = ksfFrameHeaderBytes + (first + count) * sizeof(sfe_as7343_reg_data_t);
+    size_t nRead = 0;
+
+    // Read everything in one burst. If it errors, or comes up short, then return false.
+    if (ksfTkErrOk != busReadRegister(ksfAS7343RegStatus2, raw, numBytes, nRead) || nRead != numBytes)
         return false;
 
-    return true;
-}
+    sfe_as7343_reg_status2_t status2;
+    sfe_as7343_reg_astatus_t astatus;
 
-bool sfDevAS7343::setSpectralIntThresholdLow(uint16_t spThL)
-{
-    // Write both LSB and MSB in the same I2C write. If it errors, then return false.
-    if (ksfTkErrOk != _theBus->writeRegister(ksfAS7343RegSpThL, (uint8_t *)&spThL, 2))
+    status2.byte = raw[ksfAS7343RegStatus2 - ksfAS7343RegStatus2];
+    astatus.byte = raw[ksfAS7343RegAStatus - ksfAS7343RegStatus2];
+
+    frame.status = raw[ksfAS7343RegStatus - ksfAS7343RegStatus2];
+    frame.status2 = status2.byte;
+    frame.status3 = raw[ksfAS7343RegStatus3 - ksfAS7343RegStatus2];
+    frame.astatus = astatus.byte;
+    frame.gain = (sfe_as7343_again_t)astatus.again_status;
+    frame.valid = status2.avalid;
+    frame.saturatedAnalog = status2.asat_ana;
+    frame.saturatedDigital = status2.asat_dig;
+    frame.darkCorrected = false;
+
+    unpackSpectraData(raw + ksfFrameHeaderBytes + first * sizeof(sfe_as7343_reg_data_t), first, count);
+    getData(frame.data, ksfAS7343NumChannels);
+    frame.timestamp = _dataTimestamp[_front];
+
+    // Pick the gain for the next measurement, from the raw counts.
+    if (_autoGain && updateAutoGain(frame) == false)
         return false;
 
+    // Subtract the dark offsets, the integration time comes from the shadow.
+    uint8_t atime;
+    uint16_t astep;
+
+    if (_darkOffsets && getIntegrationTime(atime, astep))
+        _darkOffsets->apply(frame, atime, astep);
+
     return true;
 }
 
-bool sfDevAS7343::enableSpectralInterrupt(bool enable)
+bool sfDevAS7343::setAsyncBus(sfDevAS7343AsyncBus *asyncBus)
 {
-    sfe_as7343_reg_intenab_t intEnabReg; // Create a register structure for the INT_ENAB register
-
-    // Read the INT_ENAB register (to retain other bit settings), if it errors then return 0.
-    if (readRegisterBank(ksfAS7343RegIntEnab, intEnabReg.byte) == false)
+    // The buffer of a read in flight belongs to the old bus.
+    if (poll() == READ_STATE_BUSY)
         return false;
 
-    // Set the SP_IEN bit according to the incoming argument
-    intEnabReg.sp_ien = enable ? 1 : 0;
+    // The old bus must not call back into this device anymore.
+    if (_asyncBus)
+        _asyncBus->setCompletionCallback(nullptr, nullptr);
 
-    // Write the INT_ENAB register to the device. If it errors, then return false.
-    if (ksfTkErrOk != _theBus->writeRegister(ksfAS7343RegIntEnab, intEnabReg.byte))
-        return false;
+    _asyncBus = asyncBus;
+
+    // Let the bus finish reads itself if it can, otherwise poll() asks it.
+    _asyncNotifies = _asyncBus && _asyncBus->setCompletionCallback(asyncReadComplete, this);
 
     return true;
 }
 
-bool sfDevAS7343::disableSpectralInterrupt()
+bool sfDevAS7343::startRead(void)
 {
-    return enableSpectralInterrupt(false);
-}
+    SFE_AS7343_STATS_SCOPE(STATS_OP_READ_DATA);
 
-bool sfDevAS7343::setSpectralThresholdChannel(sfe_as7343_spectral_threshold_channel_t spThCh)
-{
-    sfe_as7343_reg_cfg12_t cfg12; // Create a register structure for the CFG12 register
+    // Nullptr check.
+    if (!_theBus)
+        return false;
 
-    // Read the CFG12 register (to retain other bit settings), if it errors then return 0.
-    if (readRegisterBank(ksfAS7343RegCfg12, cfg12.byte) == false)
+    // Only one read can be in flight.
+    if (poll() == READ_STATE_BUSY)
         return false;
 
-    // Set the SP_TH_CH bits according to the incoming argument
-    cfg12.sp_th_ch = spThCh;
+    _readState = READ_STATE_FAILED;
 
-    // Write the CFG12 register to the device. If it errors, then return false.
-    if (ksfTkErrOk != _theBus->writeRegister(ksfAS7343RegCfg12, cfg12.byte))
+    // Get the channels to read (from the AutoSmux setting and the channel mask).
+    if (getReadWindow(_readFirst, _readCount) == false)
         return false;
 
-    return true;
-}
+    // Set the register bank to 0 to access the data registers (the bank is cached, so normally
+    // this does not touch the bus).
+    if (setRegisterBank(REG_BANK_0) == false)
+        return false;
 
-bool sfDevAS7343::getSystemInterruptStatus(void)
-{
-    sfe_as7343_reg_status_t statusReg; // Create a register structure for the STATUS register
+    uint8_t firstReg = ksfAS7343RegData0 + _readFirst * sizeof(sfe_as7343_reg_data_t);
+    size_t numOfDataBytes = _readCount * sizeof(sfe_as7343_reg_data_t);
 
-    // Read the STATUS register, if it errors then return 0.
-    if (readRegisterBank(ksfAS7343RegStatus, statusReg.byte) == false)
-        return false;
+    _fifoReadData = nullptr;
 
-    // Return the SINT bit from the STATUS register
-    return statusReg.sint;
-}
+    // Submit the burst to the asynchronous bus, poll() (or the bus' completion callback) picks up the result.
+    if (_asyncBus)
+    {
+        // Busy before the submit, a bus that reports finished reads may finish it right away.
+        _readState = READ_STATE_BUSY;
 
-bool sfDevAS7343::getSpectralChannelInterruptStatus(void)
-{
-    sfe_as7343_reg_status_t statusReg; // Create a register structure for the STATUS register
+        if (_asyncBus->startReadRegister(firstReg, _readBuffer, numOfDataBytes) == false)
+        {
+#ifdef SFE_AS7343_STATS
+            countBusTransaction(false, 0, ksfTkErrFail);
+#endif
+            _readState = READ_STATE_FAILED;
+            return false;
+        }
 
-    // Read the STATUS register, if it errors then return 0.
-    if (readRegisterBank(ksfAS7343RegStatus, statusReg.byte) == false)
+        return true;
+    }
+
+    // No asynchronous bus, fall back to a blocking read.
+    size_t nRead = 0;
+
+    if (ksfTkErrOk != busReadRegister(firstReg, _readBuffer, numOfDataBytes, nRead))
         return false;
 
-    // Return the AINT bit from the STATUS register
-    return statusReg.aint;
+    endRead(true, nRead);
+
+    return _readState == READ_STATE_COMPLETE;
 }
 
-bool sfDevAS7343::getSpectralInterruptHighStatus(void)
+sfe_as7343_read_state_t sfDevAS7343::poll(void)
 {
-    sfe_as7343_reg_status3_t statusReg; // Create a register structure for the STATUS3 register
+    // Nothing in flight, the state is already final. A bus that reports finished reads finishes
+    // them itself, see asyncReadComplete().
+    if (_readState != READ_STATE_BUSY || !_asyncBus || _asyncNotifies)
+        return _readState;
 
-    // Read the STATUS3 register, if it errors then return 0.
-    if (readRegisterBank(ksfAS7343RegStatus3, statusReg.byte) == false)
-        return false;
+    finishRead();
 
-    // Return the INT_SP_H bit from the STATUS3 register
-    return statusReg.int_sp_h;
+    return _readState;
 }
 
-bool sfDevAS7343::getSpectralTriggerErrorStatus(void)
+void sfDevAS7343::asyncReadComplete(void *context)
 {
-    sfe_as7343_reg_status4_t statusReg; // Create a register structure for the STATUS4 register
+    sfDevAS7343 *device = (sfDevAS7343 *)context;
 
-    // Read the STATUS4 register, if it errors then return 0.
-    if (readRegisterBank(ksfAS7343RegStatus4, statusReg.byte) == false)
-        return false;
+    // Nullptr check, and only a read in flight can finish.
+    if (!device || device->_readState != READ_STATE_BUSY || !device->_asyncBus)
+        return;
 
-    // Return the SP_TRIG bit from the STATUS4 register
-    return statusReg.sp_trig;
+    device->finishRead();
 }
 
-bool sfDevAS7343::setWaitTime(uint8_t waitTime)
+void sfDevAS7343::finishRead(void)
 {
-    // Write the wait time to the WTIME register. If it errors, then return false.
-    if (ksfTkErrOk != _theBus->writeRegister(ksfAS7343RegWTime, waitTime))
-        return false;
+    size_t nRead = 0;
+    sfe_as7343_read_state_t state = _asyncBus->pollReadRegister(nRead);
 
-    return true;
+    if (state == READ_STATE_BUSY)
+        return;
+
+#ifdef SFE_AS7343_STATS
+    // Counted once the byte count is known, against the call that started the read.
+    uint8_t outerOp = _statsOp;
+    _statsOp = _fifoReadData ? STATS_OP_READ_FIFO : STATS_OP_READ_DATA;
+    countBusTransaction(false, nRead, state == READ_STATE_COMPLETE ? ksfTkErrOk : ksfTkErrFail);
+    _statsOp = outerOp;
+#endif
+
+    endRead(state == READ_STATE_COMPLETE, nRead);
 }
 
-uint8_t sfDevAS7343::getWaitTime()
+void sfDevAS7343::endRead(bool success, size_t nRead)
 {
-    uint8_t waitTime; // Create a variable to hold the wait time.
+    if (_fifoReadData)
+    {
+        // A FIFO read, only the whole burst counts.
+        success = success && nRead == _fifoReadEntries * sizeof(sfe_as7343_reg_fifo_data_t);
+        _fifoReadCount = success ? _fifoReadEntries : 0;
+
+        // FDATA_L comes first, assemble the words in place without depending on host byte order.
+        uint8_t *raw = (uint8_t *)_fifoReadData;
+
+        for (size_t i = 0; i < _fifoReadCount; i++)
+            _fifoReadData[i] = (uint16_t)raw[2 * i] | ((uint16_t)raw[2 * i + 1] << 8);
+    }
+    else
+    {
+        // Only move the data over if the whole burst arrived.
+        success = success && nRead == _readCount * sizeof(sfe_as7343_reg_data_t);
 
-    // Read the WTIME register, if it errors then return 0.
-    if (readRegisterBank(ksfAS7343RegWTime, waitTime) == false)
-        return 0;
+        if (success)
+            unpackSpectraData(_readBuffer, _readFirst, _readCount);
+    }
 
-    return waitTime;
+    _readState = success ? READ_STATE_COMPLETE : READ_STATE_FAILED;
+
+    if (_readCallback)
+        _readCallback(this, _readState);
 }
 
-bool sfDevAS7343::enableWaitTime(bool enable)
+bool sfDevAS7343::isReadComplete(void)
+{
+    return poll() == READ_STATE_COMPLETE;
+}
+
+bool sfDevAS7343::startFifoRead(uint16_t *data, size_t maxEntries)
+{
+    SFE_AS7343_STATS_SCOPE(STATS_OP_READ_FIFO);
+
+    // Nullptr check, and check if there is room for at least one entry.
+    if (!_theBus || !data || maxEntries == 0)
+        return false;
+
+    // Only one read can be in flight.
+    if (poll() == READ_STATE_BUSY)
+        return false;
+
+    _readState = READ_STATE_FAILED;
+    _fifoReadData = data;
+    _fifoReadCount = 0;
+
+    if (maxEntries > ksfAS7343FifoMaxEntries)
+        maxEntries = ksfAS7343FifoMaxEntries;
+
+    // Find out how many entries are waiting (this also selects bank 0), only this byte is read blocking. A
+    // failed read is not an empty FIFO, the read fails.
+    uint8_t fifoLvl;
+
+    if (readRegisterBank(ksfAS7343RegFifoLvl, fifoLvl) == false)
+        return false;
+
+    _fifoReadEntries = fifoLvl;
+
+    if (_fifoReadEntries > maxEntries)
+        _fifoReadEntries = maxEntries;
+
+    size_t numBytes = _fifoReadEntries * sizeof(sfe_as7343_reg_fifo_data_t);
+
+    // An empty FIFO is done right away.
+    if (numBytes == 0)
+    {
+        endRead(true, 0);
+        return true;
+    }
+
+    // Submit the burst straight into the caller's buffer, the words are assembled in place at the end.
+    if (_asyncBus)
+    {
+        // Busy before the submit, a bus that reports finished reads may finish it right away.
+        _readState = READ_STATE_BUSY;
+
+        if (_asyncBus->startReadRegister(ksfAS7343RegFData, (uint8_t *)data, numBytes) == false)
+        {
+#ifdef SFE_AS7343_STATS
+            countBusTransaction(false, 0, ksfTkErrFail);
+#endif
+            _readState = READ_STATE_FAILED;
+            return false;
+        }
+
+        return true;
+    }
+
+    // No asynchronous bus, fall back to a blocking read.
+    size_t nRead = 0;
+
+    if (ksfTkErrOk != busReadRegister(ksfAS7343RegFData, (uint8_t *)data, numBytes, nRead))
+        return false;
+
+    endRead(true, nRead);
+
+    return _readState == READ_STATE_COMPLETE;
+}
+
+size_t sfDevAS7343::getFifoReadCount(void)
+{
+    return _fifoReadCount;
+}
+
+void sfDevAS7343::setReadCallback(void (*callback)(sfDevAS7343 *device, sfe_as7343_read_state_t state))
+{
+    _readCallback = callback;
+}
+
+bool sfDevAS7343::getReadWindow(uint8_t &first, uint8_t &count)
+{
+    // Only the channels the AutoSmux setting fills carry fresh data.
+    uint8_t numChannels = getAutoSmuxChannelCount();
+    if (numChannels == 0)
+        return false;
+
+    uint32_t mask = _channelMask & ((1UL << numChannels) - 1);
+    if (mask == 0)
+        return false;
+
+    // The data registers are consecutive, so read from the first to the last selected channel.
+    first = 0;
+    while (!(mask & (1UL << first)))
+        first++;
+
+    uint8_t last = numChannels - 1;
+    while (!(mask & (1UL << last)))
+        last--;
+
+    count = last - first + 1;
+
+    return true;
+}
+
+void sfDevAS7343::unpackSpectraData(const uint8_t *raw, uint8_t first, uint8_t count)
+{
+    uint8_t front = _front;
+    uint8_t back = front ^ 1;
+
+    // Mark the back buffer as being written, readers that are copying it will retry.
+    _dataSequence[back] = ksfDataSequenceBusy;
+    sfDataBarrier();
+
+    // Channels outside the read window carry over from the last frame.
+    for (uint8_t i = 0; i < ksfAS7343NumChannels; i++)
+    {
+        if (i < first || i >= first + count)
+            _data[back][i].word = _data[front][i].word;
+    }
+
+    // DATAx_L comes first, assemble the words without depending on host byte order. Each word only
+    // depends on its own two bytes, so this also works in place.
+    for (uint8_t i = 0; i < count; i++)
+        _data[back][first + i].word = (uint16_t)raw[2 * i] | ((uint16_t)raw[2 * i + 1] << 8);
+
+    _dataTimestamp[back] = _timestampSource ? _timestampSource() : 0;
+
+    // Publish: the new sequence number, then the swap.
+    uint32_t sequence = _dataSequence[front] + 1;
+
+    sfDataBarrier();
+    _dataSequence[back] = sequence == ksfDataSequenceBusy ? 1 : sequence;
+    sfDataBarrier();
+    _front = back;
+}
+
+uint32_t sfDevAS7343::getFrameSequence(void)
+{
+    return _dataSequence[_front];
+}
+
+uint32_t sfDevAS7343::getFrameTimestamp(void)
+{
+    uint8_t front;
+    uint32_t sequence, timestamp;
+
+    // Retry if the buffer was rewritten while reading.
+    do
+    {
+        front = _front;
+        sequence = _dataSequence[front];
+        sfDataBarrier();
+        timestamp = _dataTimestamp[front];
+        sfDataBarrier();
+    } while (sequence == ksfDataSequenceBusy || sequence != _dataSequence[front]);
+
+    return timestamp;
+}
+
+void sfDevAS7343::setTimestampSource(uint32_t (*source)(void))
+{
+    _timestampSource = source;
+}
+
+uint16_t sfDevAS7343::getChannelData(sfe_as7343_channel_t channel)
+{
+    // Check if the channel is valid (0-17).
+    if (channel >= ksfAS7343NumChannels)
+        return 0;
+
+    // Return the data for the specified channel.
+    return _data[_front][channel].word;
+}
+
+const uint16_t *sfDevAS7343::getDataView(void) const
+{
+    return &_data[_front][0].word;
+}
+
+uint8_t sfDevAS7343::getData(uint16_t *data, size_t size)
+{
+    // Check if the data pointer is valid and the size is valid
+    if (!data || size > ksfAS7343NumChannels)
+        return 0;
+
+    uint8_t nWritten = 0; // keep track of how many data bytes were written
+
+    // Copy the data from the front buffer to the provided array.
+    const sfe_as7343_reg_data_t *front = _data[_front];
+
+    for (size_t i = 0; i < size; i++)
+        data[i] = front[i].word;
+
+    nWritten = size;
+
+    return nWritten;
+}
+
+uint8_t sfDevAS7343::getData(uint16_t *data, size_t size, uint32_t &sequence, uint32_t &timestamp)
+{
+    // Check if the data pointer is valid and the size is valid
+    if (!data || size > ksfAS7343NumChannels)
+        return 0;
+
+    uint8_t front;
+
+    // Copy the front buffer, and retry if it was rewritten meanwhile (two reads finished).
+    do
+    {
+        front = _front;
+        sequence = _dataSequence[front];
+        sfDataBarrier();
+
+        for (size_t i = 0; i < size; i++)
+            data[i] = _data[front][i].word;
+
+        timestamp = _dataTimestamp[front];
+        sfDataBarrier();
+    } while (sequence == ksfDataSequenceBusy || sequence != _dataSequence[front]);
+
+    return size;
+}
+
+bool sfDevAS7343::updateScale(sfe_as7343_again_t gain)
+{
+    uint8_t atime;
+    uint16_t astep;
+
+    if (gain > AGAIN_2048 || getIntegrationTime(atime, astep) == false)
+        return false;
+
+    // Still valid, nothing to compute.
+    uint32_t key = ((uint32_t)atime << 24) | ((uint32_t)astep << 8) | gain;
+    if (key == _scaleKey)
+        return true;
+
+    uint32_t integrationUs = getIntegrationTimeUs();
+    if (integrationUs == 0)
+        return false;
+
+    // basic counts = counts / (gain x integration time in ms)
+    _scale = ksfGainReciprocal[gain] * (1000.0f / integrationUs);
+
+    // The same in 16.16 fixed point. gain = 2^(again - 1), so with a 2^40 numerator:
+    // counts x 2^16 x 1000 / (2^(again - 1) x us) = (counts x (1000 x 2^40 / us)) >> (40 - 17 + again).
+    uint64_t mant = ((uint64_t)1000 << 40) / integrationUs;
+    uint8_t shift = 40 - 17 + gain;
+
+    // Keep the mantissa within 32 bits, so each channel is one 32 x 32 bit multiply.
+    while (mant > 0xFFFFFFFF)
+    {
+        mant >>= 1;
+        shift--;
+    }
+
+    _scaleMant = (uint32_t)mant;
+    _scaleShift = shift;
+    _scaleKey = key;
+
+    return true;
+}
+
+uint8_t sfDevAS7343::getBasicCounts(float *basicCounts, size_t size)
+{
+    // Check if the data pointer is valid and the size is valid
+    if (!basicCounts || size > ksfAS7343NumChannels || updateScale(getAgain()) == false)
+        return 0;
+
+    for (size_t i = 0; i < size; i++)
+        basicCounts[i] = _data[_front][i].word * _scale;
+
+    return size;
+}
+
+uint8_t sfDevAS7343::getBasicCounts(const sfe_as7343_frame_t &frame, float *basicCounts, size_t size)
+{
+    // Check if the data pointer is valid and the size is valid
+    if (!basicCounts || size > ksfAS7343NumChannels || updateScale(frame.gain) == false)
+        return 0;
+
+    for (size_t i = 0; i < size; i++)
+        basicCounts[i] = frame.data[i] * _scale;
+
+    return size;
+}
+
+bool sfDevAS7343::getBasicCountsScale(sfe_as7343_again_t gain, float &scale)
+{
+    if (updateScale(gain) == false)
+        return false;
+
+    scale = _scale;
+
+    return true;
+}
+
+// Scale one count to 16.16 fixed point basic counts, saturating.
+static inline uint32_t sfScaleCount(uint16_t count, uint32_t mant, uint8_t shift)
+{
+    uint64_t value = ((uint64_t)count * mant) >> shift;
+
+    return value > 0xFFFFFFFF ? 0xFFFFFFFF : (uint32_t)value;
+}
+
+uint8_t sfDevAS7343::getNormalizedData(uint32_t *normalized, size_t size)
+{
+    // Check if the data pointer is valid and the size is valid
+    if (!normalized || size > ksfAS7343NumChannels || updateScale(getAgain()) == false)
+        return 0;
+
+    for (size_t i = 0; i < size; i++)
+        normalized[i] = sfScaleCount(_data[_front][i].word, _scaleMant, _scaleShift);
+
+    return size;
+}
+
+uint8_t sfDevAS7343::getNormalizedData(const sfe_as7343_frame_t &frame, uint32_t *normalized, size_t size)
+{
+    // Check if the data pointer is valid and the size is valid
+    if (!normalized || size > ksfAS7343NumChannels || updateScale(frame.gain) == false)
+        return 0;
+
+    for (size_t i = 0; i < size; i++)
+        normalized[i] = sfScaleCount(frame.data[i], _scaleMant, _scaleShift);
+
+    return size;
+}
+
+bool sfDevAS7343::setAutoSmux(sfe_as7343_auto_smux_channel_t auto_smux)
+{
+    sfe_as7343_reg_cfg20_t cfg20; // Create a register structure for the CFG20 register
+
+    // Load the CFG20 register from the shadow (to retain other bit settings), if it errors then return false.
+    if (readShadowRegister(SHADOW_CFG20, cfg20.byte) == false)
+        return false;
+
+    // Set the auto_smux bits according to the incoming argument
+    cfg20.auto_smux = auto_smux;
+
+    // Write the CFG20 register to the device. If it errors, then return false.
+    if (writeShadowRegister(SHADOW_CFG20, cfg20.byte) == false)
+        return false;
+
+    return true;
+}
+
+uint8_t sfDevAS7343::getAutoSmuxChannelCount(void)
+{
+    sfe_as7343_reg_cfg20_t cfg20; // Create a register structure for the CFG20 register
+
+    // Load the CFG20 register from the shadow, if it errors then return 0.
+    if (readShadowRegister(SHADOW_CFG20, cfg20.byte) == false)
+        return 0;
+
+    // auto_smux 1 is reserved, treat it as 6 channels.
+    if (cfg20.auto_smux == AUTOSMUX_18_CHANNELS)
+        return 18;
+    if (cfg20.auto_smux == AUTOSMUX_12_CHANNELS)
+        return 12;
+
+    return 6;
+}
+
+bool sfDevAS7343::setChannelMask(uint32_t channelMask)
+{
+    // Check if the mask selects at least one (existing) channel.
+    if (channelMask == 0 || (channelMask & ~ksfAS7343AllChannels))
+        return false;
+
+    _channelMask = channelMask;
+
+    return true;
+}
+
+uint32_t sfDevAS7343::getChannelMask(void)
+{
+    return _channelMask;
+}
+
+bool sfDevAS7343::ledOn(bool ledOn)
+{
+    sfe_as7343_reg_led_t ledReg; // Create a register structure for the LED register
+
+    // Load the LED register from the shadow (to retain other bit settings), if it errors then return false.
+    if (readShadowRegister(SHADOW_LED, ledReg.byte) == false)
+        return false;
+
+    // Set the LED_ACT bit according to the incoming argument
+    ledReg.led_act = ledOn ? 1 : 0;
+
+    // Write the LED register to the device. If it errors, then return false.
+    if (writeShadowRegister(SHADOW_LED, ledReg.byte) == false)
+        return false;
+
+    return true;
+}
+
+bool sfDevAS7343::ledOff(void)
+{
+    return ledOn(false);
+}
+
+bool sfDevAS7343::setLedDrive(uint8_t drive)
+{
+    // Check if the drive current is within the valid range (0-ksfMaxCurrentDrive(127)).
+    if (drive > ksfLEDMaxCurrentDrive)
+        return false;
+
+    sfe_as7343_reg_led_t ledReg; // Create a register structure for the LED register
+
+    // Load the LED register from the shadow (to retain other bit settings), if it errors then return false.
+    if (readShadowRegister(SHADOW_LED, ledReg.byte) == false)
+        return false;
+
+    // Set the LED drive current according to the incoming argument
+    ledReg.led_drive = drive;
+
+    // Write the LED register to the device. If it errors, then return false.
+    if (writeShadowRegister(SHADOW_LED, ledReg.byte) == false)
+        return false;
+
+    return true;
+}
+
+uint16_t sfDevAS7343::getRed(void)
+{
+    // Return the data for the red channel (F7).
+    return getChannelData(CH_RED_F7_690NM);
+}
+
+uint16_t sfDevAS7343::getGreen(void)
+{
+    // Return the data for the green channel (F5).
+    return getChannelData(CH_GREEN_F5_550NM);
+}
+
+uint16_t sfDevAS7343::getBlue(void)
+{
+    // Return the data for the blue channel (FZ).
+    return getChannelData(CH_BLUE_FZ_450NM);
+}
+
+uint16_t sfDevAS7343::getNIR(void)
+{
+    // Return the data for the NIR channel (NIR).
+    return getChannelData(CH_NIR_855NM);
+}
+
+bool sfDevAS7343::setSpectralIntThresholdHigh(uint16_t spThH)
+{
+    // Split the threshold into LSB and MSB, in register order.
+    uint8_t spTh[2] = {(uint8_t)(spThH & 0xFF), (uint8_t)(spThH >> 8)};
+
+    // Write both LSB and MSB in the same I2C write. If it errors, then return false.
+    if (writeShadowRegisters(SHADOW_SP_TH_H_LSB, spTh, 2) == false)
+        return false;
+
+    return true;
+}
+
+bool sfDevAS7343::setSpectralIntThresholdLow(uint16_t spThL)
+{
+    // Split the threshold into LSB and MSB, in register order.
+    uint8_t spTh[2] = {(uint8_t)(spThL & 0xFF), (uint8_t)(spThL >> 8)};
+
+    // Write both LSB and MSB in the same I2C write. If it errors, then return false.
+    if (writeShadowRegisters(SHADOW_SP_TH_L_LSB, spTh, 2) == false)
+        return false;
+
+    return true;
+}
+
+bool sfDevAS7343::setSpectralIntThresholds(uint16_t spThL, uint16_t spThH)
+{
+    // Split the thresholds into LSB and MSB, in register order (SP_TH_L, then SP_TH_H).
+    uint8_t spTh[4] = {(uint8_t)(spThL & 0xFF), (uint8_t)(spThL >> 8), (uint8_t)(spThH & 0xFF),
+                       (uint8_t)(spThH >> 8)};
+
+    // Write all four registers in the same I2C write. If it errors, then return false.
+    if (writeShadowRegisters(SHADOW_SP_TH_L_LSB, spTh, 4) == false)
+        return false;
+
+    return true;
+}
+
+bool sfDevAS7343::enableSpectralInterrupt(bool enable)
+{
+    sfe_as7343_reg_intenab_t intEnabReg; // Create a register structure for the INT_ENAB register
+
+    // Load the INT_ENAB register from the shadow (to retain other bit settings), if it errors then return false.
+    if (readShadowRegister(SHADOW_INTENAB, intEnabReg.byte) == false)
+        return false;
+
+    // Set the SP_IEN bit according to the incoming argument
+    intEnabReg.sp_ien = enable ? 1 : 0;
+
+    // Write the INT_ENAB register to the device. If it errors, then return false.
+    if (writeShadowRegister(SHADOW_INTENAB, intEnabReg.byte) == false)
+        return false;
+
+    return true;
+}
+
+bool sfDevAS7343::disableSpectralInterrupt()
+{
+    return enableSpectralInterrupt(false);
+}
+
+bool sfDevAS7343::setSpectralThresholdChannel(sfe_as7343_spectral_threshold_channel_t spThCh)
+{
+    sfe_as7343_reg_cfg12_t cfg12; // Create a register structure for the CFG12 register
+
+    // Load the CFG12 register from the shadow (to retain other bit settings), if it errors then return false.
+    if (readShadowRegister(SHADOW_CFG12, cfg12.byte) == false)
+        return false;
+
+    // Set the SP_TH_CH bits according to the incoming argument
+    cfg12.sp_th_ch = spThCh;
+
+    // Write the CFG12 register to the device. If it errors, then return false.
+    if (writeShadowRegister(SHADOW_CFG12, cfg12.byte) == false)
+        return false;
+
+    return true;
+}
+
+bool sfDevAS7343::getSystemInterruptStatus(void)
+{
+    sfe_as7343_reg_status_t statusReg; // Create a register structure for the STATUS register
+
+    // Read the STATUS register, if it errors then return 0.
+    if (readRegisterBank(ksfAS7343RegStatus, statusReg.byte) == false)
+        return false;
+
+    // Return the SINT bit from the STATUS register
+    return statusReg.sint;
+}
+
+bool sfDevAS7343::getSpectralChannelInterruptStatus(void)
+{
+    sfe_as7343_reg_status_t statusReg; // Create a register structure for the STATUS register
+
+    // Read the STATUS register, if it errors then return 0.
+    if (readRegisterBank(ksfAS7343RegStatus, statusReg.byte) == false)
+        return false;
+
+    // Return the AINT bit from the STATUS register
+    return statusReg.aint;
+}
+
+bool sfDevAS7343::getSpectralInterruptHighStatus(void)
+{
+    sfe_as7343_reg_status3_t statusReg; // Create a register structure for the STATUS3 register
+
+    // Read the STATUS3 register, if it errors then return 0.
+    if (readRegisterBank(ksfAS7343RegStatus3, statusReg.byte) == false)
+        return false;
+
+    // Return the INT_SP_H bit from the STATUS3 register
+    return statusReg.int_sp_h;
+}
+
+bool sfDevAS7343::getSpectralTriggerErrorStatus(void)
+{
+    sfe_as7343_reg_status4_t statusReg; // Create a register structure for the STATUS4 register
+
+    // Read the STATUS4 register, if it errors then return 0.
+    if (readRegisterBank(ksfAS7343RegStatus4, statusReg.byte) == false)
+        return false;
+
+    // Return the SP_TRIG bit from the STATUS4 register
+    return statusReg.sp_trig;
+}
+
+bool sfDevAS7343::setWaitTime(uint8_t waitTime)
+{
+    // Write the wait time to the WTIME register. If it errors, then return false.
+    if (writeShadowRegister(SHADOW_WTIME, waitTime) == false)
+        return false;
+
+    return true;
+}
+
+uint8_t sfDevAS7343::getWaitTime()
+{
+    uint8_t waitTime; // Create a variable to hold the wait time.
+
+    // Get the WTIME register from the shadow, if it errors then return 0.
+    if (readShadowRegister(SHADOW_WTIME, waitTime) == false)
+        return 0;
+
+    return waitTime;
+}
+
+bool sfDevAS7343::enableWaitTime(bool enable)
+{
+    sfe_as7343_reg_enable_t enableReg; // Create a register structure for the Enable register
+
+    // Load the Enable register from the shadow (to retain other bit settings), if it errors then return false.
+    if (readShadowRegister(SHADOW_ENABLE, enableReg.byte) == false)
+        return false;
+
+    // Set the WEN bit according to the incoming argument
+    enableReg.wen = enable ? 1 : 0;
+
+    // Write the Enable register to the device. If it errors, then return false.
+    if (writeShadowRegister(SHADOW_ENABLE, enableReg.byte) == false)
+        return false;
+
+    return true;
+}
+
+bool sfDevAS7343::disableWaitTime(void)
+{
+    return enableWaitTime(false);
+}
+
+bool sfDevAS7343::writeCfg0(sfe_as7343_reg_cfg0_t cfg0)
+{
+    // Nothing changed, no bus traffic is needed.
+    if (_cfg0Valid && _cfg0.byte == cfg0.byte)
+        return true;
+
+    // CFG0 is reachable from both banks. If it errors, drop the shadow and return false.
+    if (ksfTkErrOk != busWriteRegister(ksfAS7343RegCfg0, cfg0.byte))
+    {
+        _cfg0Valid = false;
+        return false;
+    }
+
+    _cfg0 = cfg0;
+
+    return true;
+}
+
+bool sfDevAS7343::enableWaitLong(bool enable)
+{
+    // Load the CFG0 shadow (to retain other bit settings), if it errors then return false.
+    if (loadCfg0() == false)
+        return false;
+
+    sfe_as7343_reg_cfg0_t cfg0 = _cfg0;
+
+    // Set the WLONG bit according to the incoming argument
+    cfg0.wlong = enable ? 1 : 0;
+
+    return writeCfg0(cfg0);
+}
+
+bool sfDevAS7343::disableWaitLong(void)
+{
+    return enableWaitLong(false);
+}
+
+bool sfDevAS7343::setWaitTimeMs(uint32_t waitTimeMs)
+{
+    // Longer than the device can wait (and than the math below can hold).
+    if (waitTimeMs > 0xFFFFFFFF / 1000)
+        return false;
+
+    // Wait time in steps of 2.78ms, rounded to the nearest step.
+    uint32_t steps = (waitTimeMs * 1000 + ksfAS7343WaitStepUs / 2) / ksfAS7343WaitStepUs;
+    bool wlong = false;
+
+    // Too long for WTIME alone, count in steps of 16 x 2.78ms.
+    if (steps > 256)
+    {
+        steps = (steps + ksfAS7343WaitLongFactor / 2) / ksfAS7343WaitLongFactor;
+        wlong = true;
+    }
+
+    if (steps > 256)
+        return false;
+
+    if (steps == 0)
+        steps = 1;
+
+    // Write WTIME first, then WLONG. If either errors, then return false.
+    if (setWaitTime((uint8_t)(steps - 1)) == false)
+        return false;
+
+    return enableWaitLong(wlong);
+}
+
+bool sfDevAS7343::enableLowPower(bool enable)
+{
+    // Load the CFG0 shadow (to retain other bit settings), if it errors then return false.
+    if (loadCfg0() == false)
+        return false;
+
+    sfe_as7343_reg_cfg0_t cfg0 = _cfg0;
+
+    // Set the LOW_POWER bit according to the incoming argument
+    cfg0.low_power = enable ? 1 : 0;
+
+    return writeCfg0(cfg0);
+}
+
+bool sfDevAS7343::disableLowPower(void)
+{
+    return enableLowPower(false);
+}
+
+bool sfDevAS7343::enableSleepAfterInterrupt(bool enable)
+{
+    sfe_as7343_reg_cfg3_t cfg3Reg; // Create a register structure for the CFG3 register
+
+    // Load the CFG3 register from the shadow (to retain other bit settings), if it errors then return false.
+    if (readShadowRegister(SHADOW_CFG3, cfg3Reg.byte) == false)
+        return false;
+
+    // Set the SAI bit according to the incoming argument
+    cfg3Reg.sai = enable ? 1 : 0;
+
+    // Write the CFG3 register to the device. If it errors, then return false.
+    if (writeShadowRegister(SHADOW_CFG3, cfg3Reg.byte) == false)
+        return false;
+
+    return true;
+}
+
+bool sfDevAS7343::disableSleepAfterInterrupt(void)
+{
+    return enableSleepAfterInterrupt(false);
+}
+
+bool sfDevAS7343::isSleepAfterInterruptActive(void)
+{
+    sfe_as7343_reg_status4_t statusReg; // Create a register structure for the STATUS4 register
+
+    // Read the STATUS4 register, if it errors then return false.
+    if (readRegisterBank(ksfAS7343RegStatus4, statusReg.byte) == false)
+        return false;
+
+    // Return the SAI_ACT bit from the STATUS4 register
+    return statusReg.sai_act;
+}
+
+bool sfDevAS7343::resumeAfterInterrupt(void)
+{
+    uint8_t status;
+
+    // The interrupts must be cleared before SAI_ACTIVE, if it errors then return false.
+    if (readStatusReg(status) == false || clearStatusReg(status) == false)
+        return false;
+
+    // The CONTROL bits are one-shot commands, so only CLEAR_SAI_ACT is written (no read-modify-write).
+    sfe_as7343_reg_control_t controlReg;
+    controlReg.byte = 0;
+    controlReg.clear_sai_act = 1;
+
+    // readStatusReg() selected bank 0. Write the CONTROL register, if it errors then return false.
+    if (ksfTkErrOk != busWriteRegister(ksfAS7343RegControl, controlReg.byte))
+        return false;
+
+    return true;
+}
+
+bool sfDevAS7343::setDutyCycle(uint32_t waitTimeMs)
+{
+    // One interrupt per measurement, with the wait time after each resume.
+    if (setWaitTimeMs(waitTimeMs) == false || enableWaitTime() == false)
+        return false;
+
+    if (setSpectralIntPersistence(0) == false || enableSpectralInterrupt() == false)
+        return false;
+
+    // Sleep once INT is asserted, and idle in low power while waiting.
+    if (enableSleepAfterInterrupt() == false || enableLowPower() == false)
+        return false;
+
+    return true;
+}
+
+bool sfDevAS7343::getSpectralValidStatus(void)
+{
+    sfe_as7343_reg_status2_t statusReg; // Create a register structure for the STATUS2 register
+
+    // Read the STATUS2 register, if it errors then return 0.
+    if (readRegisterBank(ksfAS7343RegStatus2, statusReg.byte) == false)
+        return false;
+
+    // Return the AVALID bit from the STATUS2 register
+    return statusReg.avalid;
+}
+
+uint8_t sfDevAS7343::readIntEnableReg(void)
+{
+    uint8_t intEnabReg; // Create a variable to hold the INT_ENAB register value.
+
+    // Read the INT_ENAB register, if it errors then return 0.
+    if (readRegisterBank(ksfAS7343RegIntEnab, intEnabReg) == false)
+        return 0;
+
+    return intEnabReg;
+}
+
+bool sfDevAS7343::setGPIOMode(sfe_as7343_gpio_mode_t gpioMode)
+{
+    // Check if the GPIO mode is valid (input or output).
+    if (gpioMode != AS7343_GPIO_MODE_INPUT && gpioMode != AS7343_GPIO_MODE_OUTPUT)
+        return false;
+
+    sfe_as7343_reg_gpio_t gpioReg; // Create a register structure for the GPIO register
+
+    // Load the GPIO register from the shadow (to retain other bit settings), if it errors then return false.
+    if (readShadowRegister(SHADOW_GPIO, gpioReg.byte) == false)
+        return false;
+
+    // Set the GPIO_IN_EN bit according to the incoming argument
+    gpioReg.gpio_in_en = (uint8_t)gpioMode;
+
+    // Write the GPIO register to the device. If it errors, then return false.
+    if (writeShadowRegister(SHADOW_GPIO, gpioReg.byte) == false)
+        return false;
+
+    return true;
+}
+
+bool sfDevAS7343::getGPIOInputStatus(void)
+{
+    sfe_as7343_reg_gpio_t gpioReg; // Create a register structure for the GPIO register
+
+    // Read the GPIO register, if it errors then return 0.
+    if (readRegisterBank(ksfAS7343RegGpio, gpioReg.byte) == false)
+        return false;
+
+    // Return the GPIO_IN bit from the GPIO register
+    return gpioReg.gpio_in;
+}
+
+bool sfDevAS7343::setGPIOOutput(sfe_as7343_gpio_output_t gpioOut)
+{
+    sfe_as7343_reg_gpio_t gpioReg; // Create a register structure for the GPIO register
+
+    // Load the GPIO register from the shadow (to retain other bit settings), if it errors then return false.
+    if (readShadowRegister(SHADOW_GPIO, gpioReg.byte) == false)
+        return false;
+
+    // Set the GPIO_OUT bit according to the incoming argument
+    gpioReg.gpio_out = gpioOut;
+
+    // Write the GPIO register to the device. If it errors, then return false.
+    if (writeShadowRegister(SHADOW_GPIO, gpioReg.byte) == false)
+        return false;
+
+    return true;
+}
+
+bool sfDevAS7343::reset(void)
+{
+    sfe_as7343_reg_control_t controlReg; // Create a register structure for the CONTROL register
+
+    // Read the CONTROL register (to retain other bit settings), if it errors then return 0.
+    if (readRegisterBank(ksfAS7343RegControl, controlReg.byte) == false)
+        return false;
+
+    // Set the SW_RESET bit to 1 to reset the device
+    controlReg.sw_reset = 1;
+
+    // The reset returns all registers to their defaults, so the shadows are stale from here on.
+    _cfg0Valid = false;
+    _shadowValid = false;
+
+    // Write the CONTROL register to the device. If it errors, then return false.
+    if (ksfTkErrOk != busWriteRegister(ksfAS7343RegControl, controlReg.byte))
+        return false;
+
+    return true;
+}
+
+bool sfDevAS7343::setSpectralIntPersistence(uint8_t apers)
+{
+    sfe_as7343_reg_pers_t persReg; // Create a register structure for the PERS register
+
+    // Load the PERS register from the shadow (to retain other bit settings), if it errors then return false.
+    if (readShadowRegister(SHADOW_PERS, persReg.byte) == false)
+        return false;
+
+    // Set the PERS bits according to the incoming argument
+    persReg.apers = apers;
+
+    // Write the PERS register to the device. If it errors, then return false.
+    if (writeShadowRegister(SHADOW_PERS, persReg.byte) == false)
+        return false;
+
+    return true;
+}
+
+bool sfDevAS7343::clearSpectralChannelInterrupt(void)
+{
+    sfe_as7343_reg_status_t statusReg; // Create a register structure for the STATUS register
+
+    // Read the STATUS register, if it errors then return 0.
+    if (readRegisterBank(ksfAS7343RegStatus, statusReg.byte) == false)
+        return false;
+
+    // Clear the AINT bit by writing a 1 to it
+    statusReg.aint = 1;
+
+    // Write the STATUS register to the device. If it errors, then return false.
+    if (ksfTkErrOk != busWriteRegister(ksfAS7343RegStatus, statusReg.byte))
+        return false;
+
+    return true;
+}
+
+bool sfDevAS7343::readRegisterBank(uint8_t reg, uint8_t &data)
+{
+    SFE_AS7343_STATS_SCOPE(STATS_OP_READ_REGISTER);
+
+    // Nullptr check.
+    if (!_theBus)
+        return false;
+
+    // Set the register bank as needed to access the specified register.
+    // if the desired register is equal to or greater than ksfRegisterBank0Limit (0x80),
+    // set bank 0. Otherwise, set bank 1.
+    sfe_as7343_reg_bank_t regBank = reg >= ksfRegisterBank0Limit ? REG_BANK_0 : REG_BANK_1;
+
+    if (setRegisterBank(regBank) == false)
+        return false;
+
+    // Read the specified register. If it errors, then return false.
+    if (ksfTkErrOk != busReadRegister(reg, data))
+        return false;
+
+    return true;
+}
+
+bool sfDevAS7343::setAgain(sfe_as7343_again_t again)
+{
+    sfe_as7343_reg_cfg1_t cfg1; // Create a register structure for the CFG0 register
+
+    // Load the CFG0 register from the shadow (to retain other bit settings), if it errors then return false.
+    if (readShadowRegister(SHADOW_CFG1, cfg1.byte) == false)
+        return false;
+
+    // Set the AGC bits according to the incoming argument
+    cfg1.again = again;
+
+    // Write the CFG0 register to the device. If it errors, then return false.
+    if (writeShadowRegister(SHADOW_CFG1, cfg1.byte) == false)
+        return false;
+
+    return true;
+}
+
+sfe_as7343_again_t sfDevAS7343::getAgain(void)
+{
+    sfe_as7343_reg_cfg1_t cfg1; // Create a register structure for the CFG1 register
+
+    // Load the CFG1 register from the shadow, if it errors then return the lowest gain.
+    if (readShadowRegister(SHADOW_CFG1, cfg1.byte) == false)
+        return AGAIN_0_5;
+
+    return (sfe_as7343_again_t)cfg1.again;
+}
+
+bool sfDevAS7343::setFlickerGainMax(sfe_as7343_fd_gain_t gainMax)
+{
+    // Check if the gain is valid (0.5x to 2048x).
+    if (gainMax > FD_GAIN_2048)
+        return false;
+
+    sfe_as7343_reg_agc_gain_max_t agcGainMax; // Create a register structure for the AGC_GAIN_MAX register
+
+    // Load the AGC_GAIN_MAX register from the shadow (to retain other bit settings), if it errors then return false.
+    if (readShadowRegister(SHADOW_AGC_GAIN_MAX, agcGainMax.byte) == false)
+        return false;
+
+    // Set the agc_fd_gain_max bits according to the incoming argument
+    agcGainMax.agc_fd_gain_max = gainMax;
+
+    // Write the AGC_GAIN_MAX register to the device. If it errors, then return false.
+    return writeShadowRegister(SHADOW_AGC_GAIN_MAX, agcGainMax.byte);
+}
+
+void sfDevAS7343::enableAutoGain(bool enable)
+{
+    _autoGain = enable;
+}
+
+void sfDevAS7343::disableAutoGain(void)
+{
+    enableAutoGain(false);
+}
+
+bool sfDevAS7343::setAutoGainRange(sfe_as7343_again_t minGain, sfe_as7343_again_t maxGain, uint8_t lowPercent,
+                                   uint8_t highPercent)
+{
+    // Check that the gains and the window are in order.
+    if (maxGain > AGAIN_2048 || minGain > maxGain || lowPercent >= highPercent || highPercent > 100)
+        return false;
+
+    _autoGainMin = minGain;
+    _autoGainMax = maxGain;
+    _autoGainLow = lowPercent;
+    _autoGainHigh = highPercent;
+
+    return true;
+}
+
+uint16_t sfDevAS7343::getFullScale(void)
+{
+    uint8_t atime;
+    uint16_t astep;
+
+    if (getIntegrationTime(atime, astep) == false)
+        return 0;
+
+    uint32_t steps = ((uint32_t)atime + 1) * ((uint32_t)astep + 1);
+
+    return steps > 0xFFFF ? 0xFFFF : (uint16_t)steps;
+}
+
+bool sfDevAS7343::updateAutoGain(const sfe_as7343_frame_t &frame)
+{
+    sfe_as7343_again_t gain = getAgain();
+    uint16_t fullScale = getFullScale();
+
+    uint8_t first, count;
+    if (fullScale == 0 || getReadWindow(first, count) == false)
+        return false;
+
+    // This frame was measured before the last gain change took effect, wait for a fresh one.
+    if (frame.gain != gain)
+        return true;
+
+    // Highest count among the channels that were read.
+    uint32_t peak = 0;
+    for (uint8_t i = first; i < first + count; i++)
+    {
+        if (frame.data[i] > peak)
+            peak = frame.data[i];
+    }
+
+    int8_t steps = 0;
+
+    if (frame.saturatedAnalog || frame.saturatedDigital || peak >= fullScale)
+    {
+        // The count is clipped, so it doesn't say how much to drop.
+        steps = -(int8_t)ksfAutoGainSaturationSteps;
+    }
+    else
+    {
+        uint32_t low = (uint32_t)fullScale * _autoGainLow / 100;
+        uint32_t high = (uint32_t)fullScale * _autoGainHigh / 100;
+
+        // Inside the window, keep the gain.
+        if (peak >= low && peak <= high)
+            return true;
+
+        uint32_t target = (low + high) / 2;
+
+        // Every gain step doubles the count, find the highest gain that keeps the peak at or below the
+        // target. A dark frame (peak 0) goes straight to the highest gain.
+        if (peak == 0)
+            steps = AGAIN_2048;
+        while (peak > target)
+        {
+            peak >>= 1;
+            steps--;
+        }
+        while (peak != 0 && peak * 2 <= target && steps < AGAIN_2048)
+        {
+            peak <<= 1;
+            steps++;
+        }
+    }
+
+    int8_t next = (int8_t)gain + steps;
+
+    if (next < (int8_t)_autoGainMin)
+        next = _autoGainMin;
+    if (next > (int8_t)_autoGainMax)
+        next = _autoGainMax;
+
+    // Only write when the gain actually changes.
+    if (next == (int8_t)gain)
+        return true;
+
+    return setAgain((sfe_as7343_again_t)next);
+}
+
+bool sfDevAS7343::enableFlickerDetection(bool enable)
 {
     sfe_as7343_reg_enable_t enableReg; // Create a register structure for the Enable register
 
-    // Read the Enable register (to retain other bit settings), if it errors then return 0.
-    if (readRegisterBank(ksfAS7343RegEnable, enableReg.byte) == false)
+    // Load the Enable register from the shadow (to retain other bit settings), if it errors then return false.
+    if (readShadowRegister(SHADOW_ENABLE, enableReg.byte) == false)
         return false;
 
-    // Set the WEN bit according to the incoming argument
-    enableReg.wen = enable ? 1 : 0;
+    // Set the FLICKER_EN bit according to the incoming argument
+    enableReg.fden = enable ? 1 : 0;
+
+    // Write the Enable register to the device. If it errors, then return false.
+    if (writeShadowRegister(SHADOW_ENABLE, enableReg.byte) == false)
+        return false;
+
+    return true;
+}
+
+bool sfDevAS7343::disableFlickerDetection(void)
+{
+    return enableFlickerDetection(false);
+}
+
+bool sfDevAS7343::readFlickerStatus(sfe_as7343_flicker_status_t &status)
+{
+    sfe_as7343_reg_fd_status_t fdStatusReg; // Create a register structure for the FD_STATUS register
+
+    // Read the FD_STATUS register, if it errors then return false.
+    if (readRegisterBank(ksfAS7343RegFdStatus, fdStatusReg.byte) == false)
+        return false;
+
+    status.valid = fdStatusReg.fd_meas_valid;
+    status.saturated = fdStatusReg.fd_saturation;
+    status.detected100Hz = fdStatusReg.fd_100hz_det;
+    status.valid100Hz = fdStatusReg.fd_100hz_valid;
+    status.detected120Hz = fdStatusReg.fd_120hz_det;
+    status.valid120Hz = fdStatusReg.fd_120hz_valid;
+
+    // See which frequency bit is set (fd_100hz_det or fd_120hz_det) and check
+    // its corresponding valid bit (fd_100hz_valid or fd_120hz_valid) to determine the frequency
+    if (status.detected100Hz && status.valid100Hz)
+        status.frequency = 100;
+    else if (status.detected120Hz && status.valid120Hz)
+        status.frequency = 120;
+    else
+        status.frequency = 0; // No valid frequency detected
+
+    return true;
+}
+
+bool sfDevAS7343::isFlickerDetectionValid(void)
+{
+    sfe_as7343_flicker_status_t status;
+
+    // Read the FD_STATUS register, if it errors then return false.
+    if (readFlickerStatus(status) == false)
+        return false;
+
+    // Return the FD_VALID bit from the FD_STATUS register
+    return status.valid;
+}
+
+bool sfDevAS7343::isFlickerDetectionSaturated(void)
+{
+    sfe_as7343_flicker_status_t status;
+
+    // Read the FD_STATUS register, if it errors then return false.
+    if (readFlickerStatus(status) == false)
+        return false;
+
+    // Return the FD_SAT bit from the FD_STATUS register
+    return status.saturated;
+}
+
+uint8_t sfDevAS7343::getFlickerDetectionFrequency(void)
+{
+    sfe_as7343_flicker_status_t status;
+
+    // Read the FD_STATUS register, if it errors then return 0.
+    if (readFlickerStatus(status) == false)
+        return 0;
+
+    return status.frequency;
+}
+
+bool sfDevAS7343::setFlickerTime(uint16_t fdTime)
+{
+    // FD_TIME is 11 bits, and 0 leaves no integration time.
+    if (fdTime == 0 || fdTime > ksfAS7343FdTimeMax)
+        return false;
+
+    sfe_as7343_reg_fd_time_2_t fdTime2; // Create a register structure for the FD_TIME_2 register
+
+    // Load the FD_TIME_2 register from the shadow (to retain the gain), if it errors then return false.
+    if (readShadowRegister(SHADOW_FD_TIME_2, fdTime2.byte) == false)
+        return false;
+
+    // FD_TIME_1 holds the LSB, FD_TIME_2 the upper 3 bits.
+    fdTime2.fd_time_h = (uint8_t)(fdTime >> 8);
+
+    return writeFlickerTiming((uint8_t)(fdTime & 0xFF), fdTime2.byte);
+}
+
+uint16_t sfDevAS7343::getFlickerTime(void)
+{
+    uint8_t fdTime1;
+    sfe_as7343_reg_fd_time_2_t fdTime2;
+
+    // Get both halves from the shadow, if it errors then return 0.
+    if (readShadowRegister(SHADOW_FD_TIME_1, fdTime1) == false ||
+        readShadowRegister(SHADOW_FD_TIME_2, fdTime2.byte) == false)
+        return 0;
+
+    return (uint16_t)fdTime1 | ((uint16_t)fdTime2.fd_time_h << 8);
+}
+
+bool sfDevAS7343::setFlickerGain(sfe_as7343_fd_gain_t gain)
+{
+    // Check if the gain is valid (0.5x to 2048x).
+    if (gain > FD_GAIN_2048)
+        return false;
+
+    uint8_t fdTime1;
+    sfe_as7343_reg_fd_time_2_t fdTime2;
+
+    // Load both registers from the shadow (to retain FD_TIME), if it errors then return false.
+    if (readShadowRegister(SHADOW_FD_TIME_1, fdTime1) == false ||
+        readShadowRegister(SHADOW_FD_TIME_2, fdTime2.byte) == false)
+        return false;
+
+    // Set the fd_gain bits according to the incoming argument
+    fdTime2.fd_gain = gain;
+
+    return writeFlickerTiming(fdTime1, fdTime2.byte);
+}
+
+uint32_t sfDevAS7343::getFlickerSamplePeriodNs(void)
+{
+    return (uint32_t)getFlickerTime() * ksfAS7343FdTimeStepNs;
+}
+
+bool sfDevAS7343::enableFlickerStream(bool enable)
+{
+    // Fill the shadow if needed (to retain the other registers), if it errors then return false.
+    if (!_shadowValid && syncShadowRegisters() == false)
+        return false;
+
+    uint8_t target[SHADOW_NUM_REGS];
+    memcpy(target, _shadow, sizeof(target));
+
+    sfe_as7343_reg_cfg20_t cfg20;
+    sfe_as7343_reg_fd_cfg0_t fdCfg0;
+    sfe_as7343_reg_enable_t enableReg;
+
+    cfg20.byte = target[SHADOW_CFG20];
+    fdCfg0.byte = target[SHADOW_FD_CFG0];
+    enableReg.byte = target[SHADOW_ENABLE];
+
+    // Flicker detection stops while the FIFO is reconfigured, and only the flicker samples go into it.
+    cfg20.fd_fifo_8b = enable ? 1 : 0;
+    fdCfg0.fifo_write_fd = enable ? 1 : 0;
+    enableReg.fden = 0;
+
+    target[SHADOW_CFG20] = cfg20.byte;
+    target[SHADOW_FD_CFG0] = fdCfg0.byte;
+    target[SHADOW_ENABLE] = enableReg.byte;
+
+    if (enable)
+    {
+        target[SHADOW_FIFO_MAP] = 0;
+
+        // The 8-bit FIFO mode needs FD_TIME below 256, cut a longer one (it is written while FDEN is clear).
+        sfe_as7343_reg_fd_time_2_t fdTime2;
+        fdTime2.byte = target[SHADOW_FD_TIME_2];
+
+        if (fdTime2.fd_time_h != 0)
+        {
+            fdTime2.fd_time_h = 0;
+            target[SHADOW_FD_TIME_1] = (uint8_t)ksfAS7343FdTimeStream;
+            target[SHADOW_FD_TIME_2] = fdTime2.byte;
+        }
+    }
+
+    if (writeShadowDiff(target) == false)
+        return false;
+
+    // Drop whatever the FIFO held in the old format.
+    if (clearFifo() == false)
+        return false;
+
+    if (!enable)
+        return true;
+
+    // Start flicker detection, powering the device on if needed.
+    enableReg.fden = 1;
+    enableReg.pon = 1;
+
+    return writeShadowRegister(SHADOW_ENABLE, enableReg.byte);
+}
+
+bool sfDevAS7343::disableFlickerStream(void)
+{
+    return enableFlickerStream(false);
+}
+
+size_t sfDevAS7343::readFlickerSamples(uint8_t *samples, size_t maxSamples)
+{
+    // With 8-bit flicker data every FIFO entry holds two samples, so the raw FIFO bytes are the samples.
+    return readFifoBytes(samples, maxSamples);
+}
+
+bool sfDevAS7343::setAutoZeroInterval(uint8_t interval)
+{
+    // Write the AZ_CONFIG register to the device. If it errors, then return false.
+    return writeShadowRegister(SHADOW_AZ_CONFIG, interval);
+}
+
+uint8_t sfDevAS7343::getAutoZeroInterval(void)
+{
+    uint8_t azConfig;
+
+    // Get the AZ_CONFIG register from the shadow, if it errors then return the power-on default.
+    if (readShadowRegister(SHADOW_AZ_CONFIG, azConfig) == false)
+        return ksfAS7343AutoZeroFirstOnly;
+
+    return azConfig;
+}
+
+bool sfDevAS7343::startAutoZero(void)
+{
+    sfe_as7343_reg_enable_t enableReg; // Create a register structure for the Enable register
+
+    // Load the Enable register from the shadow, if it errors then return false.
+    if (readShadowRegister(SHADOW_ENABLE, enableReg.byte) == false)
+        return false;
+
+    // A manual auto zero only works with SP_EN = 0.
+    if (enableReg.sp_en)
+        return false;
+
+    // The CONTROL bits are one-shot commands, so only SP_MAN_AZ is written (no read-modify-write).
+    sfe_as7343_reg_control_t controlReg;
+    controlReg.byte = 0;
+    controlReg.sp_man_az = 1;
+
+    // Set the register bank to 0 to access the CONTROL register.
+    if (setRegisterBank(REG_BANK_0) == false)
+        return false;
+
+    // Write the CONTROL register to the device. If it errors, then return false.
+    if (ksfTkErrOk != busWriteRegister(ksfAS7343RegControl, controlReg.byte))
+        return false;
+
+    return true;
+}
+
+void sfDevAS7343::setDarkOffsets(const sfDevAS7343DarkOffsets *offsets)
+{
+    _darkOffsets = offsets;
+}
+
+const sfDevAS7343DarkOffsets *sfDevAS7343::getDarkOffsets(void)
+{
+    return _darkOffsets;
+}
+
+bool sfDevAS7343::writeFlickerTiming(uint8_t fdTime1, uint8_t fdTime2)
+{
+    sfe_as7343_reg_enable_t enableReg; // Create a register structure for the Enable register
+
+    // Load the Enable register from the shadow, if it errors then return false.
+    if (readShadowRegister(SHADOW_ENABLE, enableReg.byte) == false)
+        return false;
+
+    bool change1 = _shadow[SHADOW_FD_TIME_1] != fdTime1;
+    bool change2 = _shadow[SHADOW_FD_TIME_2] != fdTime2;
+
+    if (!change1 && !change2)
+        return true;
+
+    // FD_TIME must not change while FDEN and PON are set, so pause flicker detection for the write.
+    bool running = enableReg.fden && enableReg.pon;
+
+    if (running && enableFlickerDetection(false) == false)
+        return false;
+
+    // The registers are not adjacent, write the ones that change one by one.
+    if ((change1 && writeShadowRegister(SHADOW_FD_TIME_1, fdTime1) == false) ||
+        (change2 && writeShadowRegister(SHADOW_FD_TIME_2, fdTime2) == false))
+        return false;
+
+    // Restart flicker detection if it was running.
+    if (running && enableFlickerDetection(true) == false)
+        return false;
+
+    return true;
+}
+
+bool sfDevAS7343::setIntegrationTime(uint8_t atime, uint16_t astep)
+{
+    // ASTEP 65535 is reserved, and ATIME and ASTEP must not both be 0.
+    if (astep > ksfAS7343AStepMax || (atime == 0 && astep == 0))
+        return false;
+
+    // Fill the shadow if needed (to retain the other registers), if it errors then return false.
+    if (!_shadowValid && syncShadowRegisters() == false)
+        return false;
+
+    uint8_t target[SHADOW_NUM_REGS];
+    memcpy(target, _shadow, sizeof(target));
+
+    target[SHADOW_ATIME] = atime;
+    target[SHADOW_ASTEP_L] = astep & 0xFF;
+    target[SHADOW_ASTEP_H] = astep >> 8;
+
+    // Only the registers that change are written.
+    return writeShadowDiff(target);
+}
+
+bool sfDevAS7343::setIntegrationTime(uint32_t integrationTimeUs)
+{
+    // Longest time: 256 x 65535 steps (about 46.6s).
+    const uint32_t maxSteps = 256UL * ((uint32_t)ksfAS7343AStepMax + 1);
+
+    // Total number of 2.78us steps, rounded to the nearest: us / 2.78 = us x 50 / 139, which
+    // stays within 32 bits over the whole range.
+    uint32_t steps = maxSteps;
+    if (integrationTimeUs < maxSteps / 50 * 139)
+        steps = (integrationTimeUs * 50 + 139 / 2) / 139;
+
+    if (steps > maxSteps)
+        steps = maxSteps;
+
+    // Shortest time: ATIME = 0, ASTEP = 1.
+    if (steps < 2)
+        steps = 2;
+
+    // Use as few ATIME steps as possible, every split has the same full scale.
+    uint32_t numAtime = (steps + ksfAS7343AStepMax) / ((uint32_t)ksfAS7343AStepMax + 1);
+    uint32_t numAstep = (steps + numAtime / 2) / numAtime;
+
+    if (numAstep > (uint32_t)ksfAS7343AStepMax + 1)
+        numAstep = (uint32_t)ksfAS7343AStepMax + 1;
+
+    return setIntegrationTime((uint8_t)(numAtime - 1), (uint16_t)(numAstep - 1));
+}
 
-    // Write the Enable register to the device. If it errors, then return false.
-    if (ksfTkErrOk != _theBus->writeRegister(ksfAS7343RegEnable, enableReg.byte))
+bool sfDevAS7343::getIntegrationTime(uint8_t &atime, uint16_t &astep)
+{
+    uint8_t astepL, astepH;
+
+    // Get ATIME and ASTEP from the shadow, if it errors then return false.
+    if (readShadowRegister(SHADOW_ATIME, atime) == false || readShadowRegister(SHADOW_ASTEP_L, astepL) == false ||
+        readShadowRegister(SHADOW_ASTEP_H, astepH) == false)
         return false;
 
+    astep = (uint16_t)astepL | ((uint16_t)astepH << 8);
+
     return true;
 }
 
-bool sfDevAS7343::disableWaitTime(void)
+uint32_t sfDevAS7343::getIntegrationTimeUs(void)
 {
-    return enableWaitTime(false);
+    uint8_t atime;
+    uint16_t astep;
+
+    if (getIntegrationTime(atime, astep) == false)
+        return 0;
+
+    // steps x 2.78us, split as steps x 2us + steps x 0.78us so it fits in 32 bits.
+    uint32_t steps = ((uint32_t)atime + 1) * ((uint32_t)astep + 1);
+
+    return steps * 2 + (steps * ((ksfAS7343IntegrationStepNs - 2000) / 10) + 50) / 100;
 }
 
-bool sfDevAS7343::getSpectralValidStatus(void)
+void sfDevAS7343::setCycleOverheadUs(uint16_t overheadUs)
 {
-    sfe_as7343_reg_status2_t statusReg; // Create a register structure for the STATUS2 register
+    _cycleOverheadUs = overheadUs;
+}
 
-    // Read the STATUS2 register, if it errors then return 0.
-    if (readRegisterBank(ksfAS7343RegStatus2, statusReg.byte) == false)
+uint16_t sfDevAS7343::getCycleOverheadUs(void)
+{
+    return _cycleOverheadUs;
+}
+
+uint32_t sfDevAS7343::getFramePeriodUs(void)
+{
+    uint32_t integrationUs = getIntegrationTimeUs();
+    uint8_t numChannels = getAutoSmuxChannelCount();
+
+    if (integrationUs == 0 || numChannels == 0)
+        return 0;
+
+    // Every SMUX cycle measures 6 channels.
+    uint32_t measureUs = (integrationUs + _cycleOverheadUs) * (numChannels / 6);
+
+    sfe_as7343_reg_enable_t enableReg;
+    uint8_t wTime;
+
+    if (readShadowRegister(SHADOW_ENABLE, enableReg.byte) == false || readShadowRegister(SHADOW_WTIME, wTime) == false)
+        return 0;
+
+    // Without the wait time, the next measurement starts right away.
+    if (!enableReg.wen)
+        return measureUs;
+
+    // WLONG lives in CFG0, if it errors then return 0.
+    if (loadCfg0() == false)
+        return 0;
+
+    uint32_t waitUs = ((uint32_t)wTime + 1) * ksfAS7343WaitStepUs;
+    if (_cfg0.wlong)
+        waitUs *= ksfAS7343WaitLongFactor;
+
+    // The wait time sets the period, unless it is too short for the measurement (see SP_TRIG).
+    return waitUs > measureUs ? waitUs : measureUs;
+}
+
+bool sfDevAS7343::syncShadowRegisters(void)
+{
+    // Nullptr check.
+    if (!_theBus)
         return false;
 
-    // Return the AVALID bit from the STATUS2 register
-    return statusReg.avalid;
+    _shadowValid = false;
+
+    uint8_t burst[ksfShadowMaxBurstLen]; // Holds one burst read of neighbouring registers.
+
+    uint8_t first = 0;
+
+    while (first < SHADOW_NUM_REGS)
+    {
+        uint8_t start = ksfShadowRegAddr[first];
+        bool bank0 = start >= ksfRegisterBank0Limit;
+
+        // Grow the burst while the next register is in the same bank, close enough and fits.
+        uint8_t last = first;
+        while (last + 1 < SHADOW_NUM_REGS)
+        {
+            uint8_t next = ksfShadowRegAddr[last + 1];
+            if ((next >= ksfRegisterBank0Limit) != bank0 || next - ksfShadowRegAddr[last] > ksfShadowMaxBurstGap ||
+                next - start >= ksfShadowMaxBurstLen)
+                break;
+            last++;
+        }
+
+        if (setRegisterBank(bank0 ? REG_BANK_0 : REG_BANK_1) == false)
+            return false;
+
+        size_t numBytes = ksfShadowRegAddr[last] - start + 1;
+        size_t nRead = 0;
+
+        // Read the whole span, reserved addresses in between included. If it errors, then return false.
+        if (ksfTkErrOk != busReadRegister(start, burst, numBytes, nRead) || nRead != numBytes)
+            return false;
+
+        // Pick the shadowed registers out of the burst.
+        for (uint8_t i = first; i <= last; i++)
+            _shadow[i] = burst[ksfShadowRegAddr[i] - start];
+
+        first = last + 1;
+    }
+
+    _shadowValid = true;
+
+    return true;
 }
 
-uint8_t sfDevAS7343::readIntEnableReg(void)
+void sfDevAS7343::setShadowVerify(bool enable)
 {
-    uint8_t intEnabReg; // Create a variable to hold the INT_ENAB register value.
+    _shadowVerify = enable;
+}
 
-    // Read the INT_ENAB register, if it errors then return 0.
-    if (readRegisterBank(ksfAS7343RegIntEnab, intEnabReg) == false)
-        return 0;
+bool sfDevAS7343::getShadowVerify(void)
+{
+    return _shadowVerify;
+}
 
-    return intEnabReg;
+bool sfDevAS7343::readShadowRegister(sfe_as7343_shadow_reg_t reg, uint8_t &data)
+{
+    // Check if the index is valid.
+    if (reg >= SHADOW_NUM_REGS)
+        return false;
+
+    // Fill the shadow on first use (begin() normally does this), if it errors then return false.
+    if (!_shadowValid && syncShadowRegisters() == false)
+        return false;
+
+    data = _shadow[reg];
+
+    return true;
 }
 
-bool sfDevAS7343::setGPIOMode(sfe_as7343_gpio_mode_t gpioMode)
+bool sfDevAS7343::writeShadowRegister(sfe_as7343_shadow_reg_t reg, uint8_t data)
 {
-    sfe_as7343_reg_gpio_t gpioReg; // Create a register structure for the GPIO register
+    return writeShadowRegisters(reg, &data, 1);
+}
 
-    // Read the GPIO register (to retain other bit settings), if it errors then return 0.
-    if (readRegisterBank(ksfAS7343RegGpio, gpioReg.byte) == false)
+bool sfDevAS7343::writeShadowRegisters(sfe_as7343_shadow_reg_t first, const uint8_t *data, uint8_t count)
+{
+    SFE_AS7343_STATS_SCOPE(STATS_OP_WRITE_SETTING);
+
+    // Check the arguments, the entries must exist and be at consecutive register addresses.
+    if (!data || count == 0 || first + count > SHADOW_NUM_REGS ||
+        ksfShadowRegAddr[first + count - 1] - ksfShadowRegAddr[first] != count - 1)
         return false;
 
-    // Check if the GPIO mode is valid (input or output).
-    if (gpioMode != AS7343_GPIO_MODE_INPUT && gpioMode != AS7343_GPIO_MODE_OUTPUT)
+    uint8_t reg = ksfShadowRegAddr[first];
+
+    // Set the register bank as needed to access the specified register.
+    if (setRegisterBank(reg >= ksfRegisterBank0Limit ? REG_BANK_0 : REG_BANK_1) == false)
         return false;
 
-    // Set the GPIO_IN_EN bit according to the incoming argument
-    gpioReg.gpio_in_en = (uint8_t)gpioMode;
+    // Write the register(s) to the device. If it errors, then return false.
+    if (ksfTkErrOk != busWriteRegister(reg, data, count))
+        return false;
 
-    // Write the GPIO register to the device. If it errors, then return false.
-    if (ksfTkErrOk != _theBus->writeRegister(ksfAS7343RegGpio, gpioReg.byte))
+    // Only update the shadow once the device has accepted the write.
+    for (uint8_t i = 0; i < count; i++)
+        _shadow[first + i] = data[i];
+
+    if (!_shadowVerify)
+        return true;
+
+    // Verify mode: read the register(s) back and make sure the device holds what was written.
+    uint8_t readBack[sizeof(_shadow)];
+    size_t nRead = 0;
+
+    if (ksfTkErrOk != busReadRegister(reg, readBack, count, nRead) || nRead != count)
         return false;
 
+    for (uint8_t i = 0; i < count; i++)
+    {
+        // GPIO_IN reflects the pin state, not what was written, so leave it out of the compare.
+        uint8_t mask = (first + i == SHADOW_GPIO) ? (uint8_t)~0x01 : 0xFF;
+
+        if ((readBack[i] & mask) != (data[i] & mask))
+        {
+            // Keep the shadow honest, it should mirror the device.
+            _shadow[first + i] = readBack[i];
+            return false;
+        }
+    }
+
     return true;
 }
 
-bool sfDevAS7343::getGPIOInputStatus(void)
+bool sfDevAS7343::getConfig(sfe_as7343_config_t &config)
 {
-    sfe_as7343_reg_gpio_t gpioReg; // Create a register structure for the GPIO register
+    // Fill the shadow if needed, if it errors then return false.
+    if (!_shadowValid && syncShadowRegisters() == false)
+        return false;
 
-    // Read the GPIO register, if it errors then return 0.
-    if (readRegisterBank(ksfAS7343RegGpio, gpioReg.byte) == false)
+    sfe_as7343_reg_enable_t enableReg;
+    sfe_as7343_reg_cfg1_t cfg1;
+    sfe_as7343_reg_cfg20_t cfg20;
+    sfe_as7343_reg_led_t ledReg;
+    sfe_as7343_reg_pers_t persReg;
+    sfe_as7343_reg_cfg12_t cfg12;
+
+    enableReg.byte = _shadow[SHADOW_ENABLE];
+    cfg1.byte = _shadow[SHADOW_CFG1];
+    cfg20.byte = _shadow[SHADOW_CFG20];
+    ledReg.byte = _shadow[SHADOW_LED];
+    persReg.byte = _shadow[SHADOW_PERS];
+    cfg12.byte = _shadow[SHADOW_CFG12];
+
+    config.again = (sfe_as7343_again_t)cfg1.again;
+    config.atime = _shadow[SHADOW_ATIME];
+    config.astep = (uint16_t)_shadow[SHADOW_ASTEP_L] | ((uint16_t)_shadow[SHADOW_ASTEP_H] << 8);
+    config.wtime = _shadow[SHADOW_WTIME];
+    config.autoSmux = (sfe_as7343_auto_smux_channel_t)cfg20.auto_smux;
+    config.ledDrive = ledReg.led_drive;
+    config.ledOn = ledReg.led_act;
+    config.spThL = (uint16_t)_shadow[SHADOW_SP_TH_L_LSB] | ((uint16_t)_shadow[SHADOW_SP_TH_L_MSB] << 8);
+    config.spThH = (uint16_t)_shadow[SHADOW_SP_TH_H_LSB] | ((uint16_t)_shadow[SHADOW_SP_TH_H_MSB] << 8);
+    config.apers = persReg.apers;
+    config.spThCh = (sfe_as7343_spectral_threshold_channel_t)cfg12.sp_th_ch;
+    config.spectralMeasurement = enableReg.sp_en;
+    config.waitTime = enableReg.wen;
+    config.flickerDetection = enableReg.fden;
+
+    return true;
+}
+
+bool sfDevAS7343::applyConfig(const sfe_as7343_config_t &config)
+{
+    return writeConfig(config, false);
+}
+
+bool sfDevAS7343::writeConfig(const sfe_as7343_config_t &config, bool powerOn)
+{
+    // Check the settings against their valid ranges. ASTEP 65535 is reserved, ATIME and ASTEP
+    // must not both be 0, and auto_smux value 1 is reserved.
+    if (config.again > AGAIN_2048 || config.astep == 0xFFFF || (config.atime == 0 && config.astep == 0) ||
+        config.ledDrive > ksfLEDMaxCurrentDrive || config.apers > 0x0F ||
+        config.spThCh > SPECTRAL_THRESHOLD_CHANNEL_5 ||
+        (config.autoSmux != AUTOSMUX_6_CHANNELS && config.autoSmux != AUTOSMUX_12_CHANNELS &&
+         config.autoSmux != AUTOSMUX_18_CHANNELS))
         return false;
 
-    // Return the GPIO_IN bit from the GPIO register
-    return gpioReg.gpio_in;
+    // Fill the shadow if needed (to retain bits the config doesn't cover), if it errors then return false.
+    if (!_shadowValid && syncShadowRegisters() == false)
+        return false;
+
+    uint8_t target[SHADOW_NUM_REGS];
+    memcpy(target, _shadow, sizeof(target));
+
+    sfe_as7343_reg_enable_t enableReg;
+    sfe_as7343_reg_cfg1_t cfg1;
+    sfe_as7343_reg_cfg20_t cfg20;
+    sfe_as7343_reg_led_t ledReg;
+    sfe_as7343_reg_pers_t persReg;
+    sfe_as7343_reg_cfg12_t cfg12;
+
+    enableReg.byte = target[SHADOW_ENABLE];
+    cfg1.byte = target[SHADOW_CFG1];
+    cfg20.byte = target[SHADOW_CFG20];
+    ledReg.byte = target[SHADOW_LED];
+    persReg.byte = target[SHADOW_PERS];
+    cfg12.byte = target[SHADOW_CFG12];
+
+    enableReg.sp_en = config.spectralMeasurement ? 1 : 0;
+    enableReg.wen = config.waitTime ? 1 : 0;
+    enableReg.fden = config.flickerDetection ? 1 : 0;
+    if (powerOn)
+        enableReg.pon = 1;
+    cfg1.again = config.again;
+    cfg20.auto_smux = config.autoSmux;
+    ledReg.led_drive = config.ledDrive;
+    ledReg.led_act = config.ledOn ? 1 : 0;
+    persReg.apers = config.apers;
+    cfg12.sp_th_ch = config.spThCh;
+
+    target[SHADOW_ENABLE] = enableReg.byte;
+    target[SHADOW_CFG1] = cfg1.byte;
+    target[SHADOW_CFG20] = cfg20.byte;
+    target[SHADOW_LED] = ledReg.byte;
+    target[SHADOW_PERS] = persReg.byte;
+    target[SHADOW_CFG12] = cfg12.byte;
+    target[SHADOW_ATIME] = config.atime;
+    target[SHADOW_ASTEP_L] = (uint8_t)(config.astep & 0xFF);
+    target[SHADOW_ASTEP_H] = (uint8_t)(config.astep >> 8);
+    target[SHADOW_WTIME] = config.wtime;
+    target[SHADOW_SP_TH_L_LSB] = (uint8_t)(config.spThL & 0xFF);
+    target[SHADOW_SP_TH_L_MSB] = (uint8_t)(config.spThL >> 8);
+    target[SHADOW_SP_TH_H_LSB] = (uint8_t)(config.spThH & 0xFF);
+    target[SHADOW_SP_TH_H_MSB] = (uint8_t)(config.spThH >> 8);
+
+    return writeShadowDiff(target);
 }
 
-bool sfDevAS7343::setGPIOOutput(sfe_as7343_gpio_output_t gpioOut)
+bool sfDevAS7343::writeShadowDiff(const uint8_t target[SHADOW_NUM_REGS])
 {
-    sfe_as7343_reg_gpio_t gpioReg; // Create a register structure for the GPIO register
+    // Nullptr check.
+    if (!_theBus || !target)
+        return false;
 
-    // Read the GPIO register (to retain other bit settings), if it errors then return 0.
-    if (readRegisterBank(ksfAS7343RegGpio, gpioReg.byte) == false)
+    // Fill the shadow if needed, it is what the target is compared against.
+    if (!_shadowValid && syncShadowRegisters() == false)
         return false;
 
-    // Set the GPIO_OUT bit according to the incoming argument
-    gpioReg.gpio_out = gpioOut;
+    // Clear ENABLE bits first, so measurements stop before anything else changes.
+    uint8_t enableFirst = _shadow[SHADOW_ENABLE] & target[SHADOW_ENABLE];
 
-    // Write the GPIO register to the device. If it errors, then return false.
-    if (ksfTkErrOk != _theBus->writeRegister(ksfAS7343RegGpio, gpioReg.byte))
+    if (enableFirst != _shadow[SHADOW_ENABLE] && writeShadowRegister(SHADOW_ENABLE, enableFirst) == false)
+        return false;
+
+    // Bank 1 entries sit at the start of the table and bank 0 follows, so walking the table in
+    // order groups the writes by bank. ENABLE is left out here and written last.
+    uint8_t i = 0;
+
+    while (i < SHADOW_NUM_REGS)
+    {
+        if (i == SHADOW_ENABLE || _shadow[i] == target[i])
+        {
+            i++;
+            continue;
+        }
+
+        // Extend the burst over consecutive addresses, up to the last changed register that can
+        // be reached without rewriting more than ksfConfigMaxCleanRun unchanged ones in a row.
+        uint8_t last = i;
+        uint8_t clean = 0;
+
+        for (uint8_t j = i + 1; j < SHADOW_NUM_REGS && j != SHADOW_ENABLE; j++)
+        {
+            if (ksfShadowRegAddr[j] != ksfShadowRegAddr[j - 1] + 1)
+                break;
+
+            if (_shadow[j] == target[j])
+            {
+                if (++clean > ksfConfigMaxCleanRun)
+                    break;
+            }
+            else
+            {
+                last = j;
+                clean = 0;
+            }
+        }
+
+        if (writeShadowRegisters((sfe_as7343_shadow_reg_t)i, &target[i], last - i + 1) == false)
+            return false;
+
+        i = last + 1;
+    }
+
+    // Finally set any new ENABLE bits, with the rest of the configuration in place.
+    if (_shadow[SHADOW_ENABLE] != target[SHADOW_ENABLE] &&
+        writeShadowRegister(SHADOW_ENABLE, target[SHADOW_ENABLE]) == false)
         return false;
 
     return true;
 }
 
-bool sfDevAS7343::reset(void)
+bool sfDevAS7343::setFifoMap(uint8_t channelMask, bool writeAStatus)
 {
-    sfe_as7343_reg_control_t controlReg; // Create a register structure for the CONTROL register
-
-    // Read the CONTROL register (to retain other bit settings), if it errors then return 0.
-    if (readRegisterBank(ksfAS7343RegControl, controlReg.byte) == false)
+    // Check if the channel mask only covers ADC channels CH0-CH5.
+    if (channelMask > 0x3F)
         return false;
 
-    // Set the SW_RESET bit to 1 to reset the device
-    controlReg.sw_reset = 1;
+    sfe_as7343_reg_fifo_map_t fifoMapReg; // Create a register structure for the FIFO_MAP register
 
-    // Write the CONTROL register to the device. If it errors, then return false.
-    if (ksfTkErrOk != _theBus->writeRegister(ksfAS7343RegControl, controlReg.byte))
+    // CH0-CH5 sit right above the ASTATUS bit.
+    fifoMapReg.byte = (uint8_t)(channelMask << 1);
+    fifoMapReg.fifo_write_astatus = writeAStatus ? 1 : 0;
+
+    // Write the FIFO_MAP register to the device. If it errors, then return false.
+    if (writeShadowRegister(SHADOW_FIFO_MAP, fifoMapReg.byte) == false)
         return false;
 
     return true;
 }
 
-bool sfDevAS7343::setSpectralIntPersistence(uint8_t apers)
+bool sfDevAS7343::setFifoThreshold(sfe_as7343_fifo_threshold_t threshold)
 {
-    sfe_as7343_reg_pers_t persReg; // Create a register structure for the PERS register
+    sfe_as7343_reg_cfg8_t cfg8; // Create a register structure for the CFG8 register
 
-    // Read the PERS register (to retain other bit settings), if it errors then return 0.
-    if (readRegisterBank(ksfAS7343RegPers, persReg.byte) == false)
+    // Load the CFG8 register from the shadow (to retain other bit settings), if it errors then return false.
+    if (readShadowRegister(SHADOW_CFG8, cfg8.byte) == false)
         return false;
 
-    // Set the PERS bits according to the incoming argument
-    persReg.apers = apers;
+    // Set the FIFO_TH bits according to the incoming argument
+    cfg8.fifo_th = threshold;
 
-    // Write the PERS register to the device. If it errors, then return false.
-    if (ksfTkErrOk != _theBus->writeRegister(ksfAS7343RegPers, persReg.byte))
+    // Write the CFG8 register to the device. If it errors, then return false.
+    if (writeShadowRegister(SHADOW_CFG8, cfg8.byte) == false)
         return false;
 
     return true;
 }
 
-bool sfDevAS7343::clearSpectralChannelInterrupt(void)
+bool sfDevAS7343::enableFifoInterrupt(bool enable)
 {
-    sfe_as7343_reg_status_t statusReg; // Create a register structure for the STATUS register
+    sfe_as7343_reg_intenab_t intEnabReg; // Create a register structure for the INT_ENAB register
 
-    // Read the STATUS register, if it errors then return 0.
-    if (readRegisterBank(ksfAS7343RegStatus, statusReg.byte) == false)
+    // Load the INT_ENAB register from the shadow (to retain other bit settings), if it errors then return false.
+    if (readShadowRegister(SHADOW_INTENAB, intEnabReg.byte) == false)
         return false;
 
-    // Clear the AINT bit by writing a 1 to it
-    statusReg.aint = 1;
+    // Set the FIEN bit according to the incoming argument
+    intEnabReg.fien = enable ? 1 : 0;
 
-    // Write the STATUS register to the device. If it errors, then return false.
-    if (ksfTkErrOk != _theBus->writeRegister(ksfAS7343RegStatus, statusReg.byte))
+    // Write the INT_ENAB register to the device. If it errors, then return false.
+    if (writeShadowRegister(SHADOW_INTENAB, intEnabReg.byte) == false)
         return false;
 
     return true;
 }
 
-bool sfDevAS7343::readRegisterBank(uint8_t reg, uint8_t &data)
+bool sfDevAS7343::disableFifoInterrupt(void)
 {
-    // Nullptr check.
-    if (!_theBus)
-        return false;
+    return enableFifoInterrupt(false);
+}
 
-    // Set the register bank as needed to access the specified register.
-    // if the desired register is equal to or greater than ksfRegisterBank0Limit (0x80),
-    // set bank 0. Otherwise, set bank 1.
-    sfe_as7343_reg_bank_t regBank = reg >= ksfRegisterBank0Limit ? REG_BANK_0 : REG_BANK_1;
+bool sfDevAS7343::clearFifo(void)
+{
+    // The CONTROL bits are one-shot commands, so only FIFO_CLR is written (no read-modify-write).
+    sfe_as7343_reg_control_t controlReg;
+    controlReg.byte = 0;
+    controlReg.fifo_clr = 1;
 
-    if (setRegisterBank(regBank) == false)
+    // Set the register bank to 0 to access the CONTROL register.
+    if (setRegisterBank(REG_BANK_0) == false)
         return false;
 
-    // Read the specified register. If it errors, then return false.
-    if (ksfTkErrOk != _theBus->readRegister(reg, data))
+    // Write the CONTROL register to the device. If it errors, then return false.
+    if (ksfTkErrOk != busWriteRegister(ksfAS7343RegControl, controlReg.byte))
         return false;
 
     return true;
 }
 
-bool sfDevAS7343::setAgain(sfe_as7343_again_t again)
+uint8_t sfDevAS7343::getFifoLevel(void)
 {
-    sfe_as7343_reg_cfg1_t cfg1; // Create a register structure for the CFG0 register
+    uint8_t fifoLvl; // Create a variable to hold the FIFO level.
 
-    // Read the CFG0 register (to retain other bit settings), if it errors then return 0.
-    if (readRegisterBank(ksfAS7343RegCfg1, cfg1.byte) == false)
-        return false;
+    // Read the FIFO_LVL register, if it errors then return 0.
+    if (readRegisterBank(ksfAS7343RegFifoLvl, fifoLvl) == false)
+        return 0;
 
-    // Set the AGC bits according to the incoming argument
-    cfg1.again = again;
+    return fifoLvl;
+}
 
-    // Write the CFG0 register to the device. If it errors, then return false.
-    if (ksfTkErrOk != _theBus->writeRegister(ksfAS7343RegCfg1, cfg1.byte))
+bool sfDevAS7343::getFifoOverflowStatus(void)
+{
+    sfe_as7343_reg_status4_t statusReg; // Create a register structure for the STATUS4 register
+
+    // Read the STATUS4 register, if it errors then return 0.
+    if (readRegisterBank(ksfAS7343RegStatus4, statusReg.byte) == false)
         return false;
 
-    return true;
+    // Return the FIFO_OV bit from the STATUS4 register
+    return statusReg.fifo_ov;
 }
 
-bool sfDevAS7343::enableFlickerDetection(bool enable)
+size_t sfDevAS7343::readFifoBytes(uint8_t *data, size_t maxBytes)
 {
-    sfe_as7343_reg_enable_t enableReg; // Create a register structure for the Enable register
+    SFE_AS7343_STATS_SCOPE(STATS_OP_READ_FIFO);
+
+    // Check if the data pointer is valid and there is room for at least one entry.
+    if (!data || maxBytes < sizeof(sfe_as7343_reg_fifo_data_t))
+        return 0;
+
+    // Find out how many entries are waiting (this also selects bank 0). Read directly, getFifoLevel() reports
+    // a failed read as an empty FIFO.
+    uint8_t fifoLvl;
+
+    if (readRegisterBank(ksfAS7343RegFifoLvl, fifoLvl) == false || fifoLvl == 0)
+        return 0;
+
+    size_t numEntries = fifoLvl;
+
+    // Only read whole entries that fit in the buffer.
+    if (numEntries > maxBytes / sizeof(sfe_as7343_reg_fifo_data_t))
+        numEntries = maxBytes / sizeof(sfe_as7343_reg_fifo_data_t);
+
+    size_t numBytes = numEntries * sizeof(sfe_as7343_reg_fifo_data_t);
+    size_t nRead = 0;
+
+    // Drain the entries in one burst, the device wraps the address from FDATA_H back to FDATA_L.
+    if (ksfTkErrOk != busReadRegister(ksfAS7343RegFData, data, numBytes, nRead))
+        return 0;
+
+    return nRead;
+}
 
-    // Read the Enable register (to retain other bit settings), if it errors then return 0.
-    if (readRegisterBank(ksfAS7343RegEnable, enableReg.byte) == false)
+size_t sfDevAS7343::readFifo(uint16_t *data, size_t maxEntries)
+{
+    // Check if the data pointer is valid
+    if (!data || maxEntries == 0)
+        return 0;
+
+    if (maxEntries > ksfAS7343FifoMaxEntries)
+        maxEntries = ksfAS7343FifoMaxEntries;
+
+    // Read the raw bytes straight into the caller's buffer, then assemble each word in place. Word i
+    // occupies exactly the two bytes it is built from, so no scratch buffer is needed.
+    uint8_t *raw = (uint8_t *)data;
+
+    size_t nRead = readFifoBytes(raw, maxEntries * sizeof(sfe_as7343_reg_fifo_data_t));
+
+    size_t numEntries = nRead / sizeof(sfe_as7343_reg_fifo_data_t);
+
+    // FDATA_L comes first, assemble the words without depending on host byte order.
+    for (size_t i = 0; i < numEntries; i++)
+        data[i] = (uint16_t)raw[2 * i] | ((uint16_t)raw[2 * i + 1] << 8);
+
+    return numEntries;
+}
+
+bool sfDevAS7343::readFifoEntries(uint16_t *data, size_t numEntries)
+{
+    SFE_AS7343_STATS_SCOPE(STATS_OP_READ_FIFO);
+
+    // Check if the data pointer and the number of entries are valid
+    if (!data || numEntries == 0 || numEntries > ksfAS7343FifoMaxEntries)
         return false;
 
-    // Set the FLICKER_EN bit according to the incoming argument
-    enableReg.fden = enable ? 1 : 0;
+    // Set the register bank to 0 to access the FIFO registers.
+    if (setRegisterBank(REG_BANK_0) == false)
+        return false;
 
-    // Write the Enable register to the device. If it errors, then return false.
-    if (ksfTkErrOk != _theBus->writeRegister(ksfAS7343RegEnable, enableReg.byte))
+    uint8_t *raw = (uint8_t *)data;
+    size_t numBytes = numEntries * sizeof(sfe_as7343_reg_fifo_data_t);
+    size_t nRead = 0;
+
+    // Read the entries in one burst. If it errors, or comes up short, then return false.
+    if (ksfTkErrOk != busReadRegister(ksfAS7343RegFData, raw, numBytes, nRead) || nRead != numBytes)
         return false;
 
+    // FDATA_L comes first, assemble the words in place without depending on host byte order.
+    for (size_t i = 0; i < numEntries; i++)
+        data[i] = (uint16_t)raw[2 * i] | ((uint16_t)raw[2 * i + 1] << 8);
+
     return true;
 }
 
-bool sfDevAS7343::disableFlickerDetection(void)
+bool sfDevAS7343::readStatusReg(uint8_t &status)
 {
-    return enableFlickerDetection(false);
+    // Read the STATUS register, if it errors then return false.
+    return readRegisterBank(ksfAS7343RegStatus, status);
 }
 
-bool sfDevAS7343::isFlickerDetectionValid(void)
+bool sfDevAS7343::clearStatusReg(uint8_t status)
 {
-    sfe_as7343_reg_fd_status_t fdStatusReg; // Create a register structure for the FD_STATUS register
+    // Nothing to clear
+    if (status == 0)
+        return true;
 
-    // Read the FD_STATUS register, if it errors then return 0.
-    if (readRegisterBank(ksfAS7343RegFdStatus, fdStatusReg.byte) == false)
+    // Set the register bank to 0 to access the STATUS register.
+    if (setRegisterBank(REG_BANK_0) == false)
         return false;
 
-    // Return the FD_VALID bit from the FD_STATUS register
-    return fdStatusReg.fd_meas_valid;
+    // Write the flags back to the STATUS register. If it errors, then return false.
+    if (ksfTkErrOk != busWriteRegister(ksfAS7343RegStatus, status))
+        return false;
+
+    return true;
 }
 
-bool sfDevAS7343::isFlickerDetectionSaturated(void)
+sfTkError_t sfDevAS7343::busReadRegister(uint8_t reg, uint8_t &data)
 {
-    sfe_as7343_reg_fd_status_t fdStatusReg; // Create a register structure for the FD_STATUS register
+    sfTkError_t result = _theBus->readRegister(reg, data);
 
-    // Read the FD_STATUS register, if it errors then return 0.
-    if (readRegisterBank(ksfAS7343RegFdStatus, fdStatusReg.byte) == false)
-        return false;
+#ifdef SFE_AS7343_STATS
+    countBusTransaction(false, 1, result);
+#endif
 
-    // Return the FD_SAT bit from the FD_STATUS register
-    return fdStatusReg.fd_saturation;
+    return result;
 }
 
-uint8_t sfDevAS7343::getFlickerDetectionFrequency(void)
+sfTkError_t sfDevAS7343::busReadRegister(uint8_t reg, uint8_t *data, size_t length, size_t &nRead)
 {
-    sfe_as7343_reg_fd_status_t fdStatusReg; // Create a register structure for the FD_STATUS register
+    sfTkError_t result = _theBus->readRegister(reg, data, length, nRead);
 
-    // Read the FD_STATUS register, if it errors then return 0.
-    if (readRegisterBank(ksfAS7343RegFdStatus, fdStatusReg.byte) == false)
-        return 0;
+#ifdef SFE_AS7343_STATS
+    countBusTransaction(false, nRead, result);
+#endif
 
-    // See which frequency bit is set (fd_100hz_det or fd_120hz_det) and check
-    // its corresponding valid bit (fd_100hz_valid or fd_120hz_valid) to determine the frequency
-    // return the frequency value
-    if (fdStatusReg.fd_100hz_det && fdStatusReg.fd_100hz_valid)
-        return 100;
-    else if (fdStatusReg.fd_120hz_det && fdStatusReg.fd_120hz_valid)
-        return 120;
+    return result;
+}
+
+sfTkError_t sfDevAS7343::busWriteRegister(uint8_t reg, uint8_t data)
+{
+    sfTkError_t result = _theBus->writeRegister(reg, data);
+
+#ifdef SFE_AS7343_STATS
+    countBusTransaction(true, 1, result);
+#endif
+
+    return result;
+}
+
+sfTkError_t sfDevAS7343::busWriteRegister(uint8_t reg, const uint8_t *data, size_t length)
+{
+    sfTkError_t result = _theBus->writeRegister(reg, data, length);
+
+#ifdef SFE_AS7343_STATS
+    countBusTransaction(true, length, result);
+#endif
+
+    return result;
+}
+
+bool sfDevAS7343::getStats(sfe_as7343_stats_t &stats)
+{
+#ifdef SFE_AS7343_STATS
+    stats = _stats;
+
+    // The running minimum starts out at the largest time, and the average is only worked out here.
+    for (uint8_t op = 0; op < STATS_OP_NUM; op++)
+    {
+        sfe_as7343_op_stats_t &opStats = stats.op[op];
+
+        if (opStats.calls == 0)
+            opStats.minTime = 0;
+        else
+            opStats.avgTime = opStats.totalTime / opStats.calls;
+    }
+
+    return true;
+#else
+    memset(&stats, 0, sizeof(stats));
+
+    return false;
+#endif
+}
+
+void sfDevAS7343::resetStats(void)
+{
+    memset(&_stats, 0, sizeof(_stats));
+
+    for (uint8_t op = 0; op < STATS_OP_NUM; op++)
+        _stats.op[op].minTime = 0xFFFFFFFF;
+}
+
+void sfDevAS7343::countBusTransaction(bool write, size_t bytes, sfTkError_t result)
+{
+    sfe_as7343_op_stats_t &opStats = _stats.op[_statsOp];
+
+    if (write)
+        opStats.writes++;
     else
-        return 0; // No valid frequency detected
+        opStats.reads++;
+
+    opStats.bytes += bytes;
+
+    if (result != ksfTkErrOk)
+        opStats.failures++;
+}
+
+sfDevAS7343::StatsScope::StatsScope(sfDevAS7343 *device, sfe_as7343_stats_op_t op)
+    : _device{device}, _outerOp{device->_statsOp},
+      _start{device->_timestampSource ? device->_timestampSource() : 0}
+{
+    _device->_statsOp = op;
+}
+
+sfDevAS7343::StatsScope::~StatsScope()
+{
+    uint32_t elapsed = _device->_timestampSource ? _device->_timestampSource() - _start : 0;
+    sfe_as7343_op_stats_t &opStats = _device->_stats.op[_device->_statsOp];
+
+    opStats.calls++;
+    opStats.totalTime += elapsed;
+
+    if (elapsed < opStats.minTime)
+        opStats.minTime = elapsed;
+    if (elapsed > opStats.maxTime)
+        opStats.maxTime = elapsed;
+
+    // Traffic after this call belongs to the enclosing call again.
+    _device->_statsOp = _outerOp;
 }
@@ -45,6 +45,13 @@
 
 // Bus interfaces
 #include <sfTk/sfTkII2C.h>
+
+// Bus instrumentation, see getStats(). Off by default, it costs a few cycles
+// per bus access. The counting is done in sfDevAS7343.cpp, so the define has
+// to reach the library build: uncomment it below, or define it for the whole
+// build (e.g. -DSFE_AS7343_STATS in build_opt.h or the compiler flags). The
+// class layout is the same either way.
+// #define SFE_AS7343_STATS
 ///////////////////////////////////////////////////////////////////////////////
 // I2C Addressing
 ///////////////////////////////////////////////////////////////////////////////
@@ -97,6 +104,9 @@ typedef enum
 // to determine the size of the _data array in the class.
 const uint8_t ksfAS7343NumChannels = 18; // Number of channels in the AS7343 sensor
 
+// Channel mask with every channel set, bit n = sfe_as7343_channel_t n (see setChannelMask()).
+const uint32_t ksfAS7343AllChannels = (1UL << ksfAS7343NumChannels) - 1;
+
 // Sensor gain settings.
 typedef enum
 {
@@ -185,6 +195,15 @@ typedef enum
     AS7343_GPIO_OUTPUT_HIGH,       // GPIO set to high
 } sfe_as7343_gpio_output_t;
 
+// Non-blocking read states, see startRead() and poll()
+typedef enum
+{
+    READ_STATE_IDLE = 0x00, // No read started yet
+    READ_STATE_BUSY,        // Read submitted, waiting for the bus
+    READ_STATE_COMPLETE,    // Read finished, the data is available
+    READ_STATE_FAILED,      // Read failed, the data was not updated
+} sfe_as7343_read_state_t;
+
 ///////////////////////////////////////////////////////////////////////////////
 // Register Definitions
 ///////////////////////////////////////////////////////////////////////////////
@@ -319,6 +338,8 @@ const uint8_t ksfAS7343RegData15 = 0xB3; // Register Address
 const uint8_t ksfAS7343RegData16 = 0xB5; // Register Address
 const uint8_t ksfAS7343RegData17 = 0xB7; // Register Address
 
+// The driver always stores word in host byte order (assembled from DATAx_L and
+// DATAx_H), data_l and data_h only name its bytes on little-endian hosts.
 typedef union {
     struct
     {
@@ -328,6 +349,8 @@ typedef union {
     uint16_t word;
 } sfe_as7343_reg_data_t;
 
+static_assert(sizeof(sfe_as7343_reg_data_t) == sizeof(uint16_t), "Data register union must be one word");
+
 const uint8_t ksfAS7343RegStatus2 = 0x90; // Register Address
 
 typedef union {
@@ -526,6 +549,16 @@ typedef union {
     uint16_t word;
 } sfe_as7343_reg_astep_t;
 
+// Integration and wait time constants.
+const uint16_t ksfAS7343AStepMax = 0xFFFE;       // Largest usable ASTEP, 65535 is reserved
+const uint16_t ksfAS7343IntegrationStepNs = 2780; // Integration step, (ATIME + 1) x (ASTEP + 1) steps
+const uint16_t ksfAS7343WaitStepUs = 2780;        // Wait time step, (WTIME + 1) steps
+const uint8_t ksfAS7343WaitLongFactor = 16;       // WLONG multiplies the wait time by 16
+const uint16_t ksfAS7343AutoZeroTimeUs = 15000;   // Typical time of an auto zero of the spectral engines
+const uint8_t ksfAS7343AutoZeroNever = 0;         // AZ_CONFIG, never auto zero (see setAutoZeroInterval())
+const uint8_t ksfAS7343AutoZeroFirstOnly = 255;   // AZ_CONFIG, auto zero before the first measurement only
+const uint16_t ksfAS7343InitTimeUs = 300;         // Initialization after power-up, the device NAKs until done
+
 const uint8_t ksfAS7343RegCfg20 = 0xD6; // Register Address
 
 typedef union {
@@ -571,12 +604,17 @@ const uint8_t ksfAS7343RegFdTime2 = 0xE2; // Register Address
 typedef union {
     struct
     {
-        uint8_t fd_time_h : 3; // TODO: Unkown big order
+        uint8_t fd_time_h : 3; // FD_TIME[10:8]
         uint8_t fd_gain : 5;
     };
     uint8_t byte;
 } sfe_as7343_reg_fd_time_2_t;
 
+// Flicker detection time constants.
+const uint16_t ksfAS7343FdTimeMax = 0x7FF;   // FD_TIME is 11 bits
+const uint16_t ksfAS7343FdTimeStream = 0xFF; // Largest FD_TIME for 8-bit FIFO samples (FD_FIFO_8b needs FD_TIME < 256)
+const uint16_t ksfAS7343FdTimeStepNs = 2780; // Flicker detection integration step, FD_TIME steps
+
 const uint8_t ksfAS7343RegFdTimeCfg0 = 0xDF; // Register Address
 
 typedef union {
@@ -648,21 +686,239 @@ typedef union {
     uint16_t word;
 } sfe_as7343_reg_fifo_data_t;
 
+// FIFO size constant. The FIFO is 256 bytes, FIFO_LVL counts 2-byte entries.
+const uint8_t ksfAS7343FifoMaxEntries = 128; // Maximum number of entries in the FIFO
+
+// One complete spectral measurement, as returned by readFrame() and handed out by the
+// acquisition engine.
+typedef struct
+{
+    uint32_t timestamp;                  // Time the measurement completed (caller's clock, usually micros())
+    uint8_t status;                      // STATUS register (ksfAS7343RegStatus) at the time of the read
+    uint8_t status2;                     // STATUS2 register (ksfAS7343RegStatus2)
+    uint8_t status3;                     // STATUS3 register (ksfAS7343RegStatus3)
+    uint8_t astatus;                     // ASTATUS register (ksfAS7343RegAStatus), latched with the data
+    sfe_as7343_again_t gain;             // Gain the data was measured with (AGAIN_STATUS)
+    bool valid;                          // Spectral measurement complete (AVALID)
+    bool saturatedAnalog;                // Analog saturation (ASAT_ANA)
+    bool saturatedDigital;               // Digital saturation (ASAT_DIG)
+    bool darkCorrected;                  // Dark offsets subtracted (see sfDevAS7343::setDarkOffsets())
+    uint16_t data[ksfAS7343NumChannels]; // Channel data, indexed by sfe_as7343_channel_t
+} sfe_as7343_frame_t;
+
+// Decoded flicker detection status, as returned by readFlickerStatus().
+typedef struct
+{
+    bool valid;         // Flicker detection measurement complete (FD_MEASUREMENT_VALID)
+    bool saturated;     // Saturation during the last flicker measurement (FD_SATURATION_DETECTED)
+    bool detected100Hz; // Flicker detected at 100 Hz (FD_100HZ_FLICKER)
+    bool valid100Hz;    // 100 Hz calculation is valid (FD_100HZ_FLICKER_VALID)
+    bool detected120Hz; // Flicker detected at 120 Hz (FD_120HZ_FLICKER)
+    bool valid120Hz;    // 120 Hz calculation is valid (FD_120HZ_FLICKER_VALID)
+    uint8_t frequency;  // Valid detected frequency (100 or 120), or 0 if none
+} sfe_as7343_flicker_status_t;
+
+///////////////////////////////////////////////////////////////////////////////
+// Shadow Register File
 ///////////////////////////////////////////////////////////////////////////////
 
+// Writable configuration registers mirrored in RAM by the driver.
+// The entries are sorted by register address, so registers that are contiguous
+// on the device are also contiguous here and can be read (or written) in bursts.
+typedef enum
+{
+    SHADOW_CFG10 = 0x00, // 0x65 (bank 1)
+    SHADOW_CFG12,        // 0x66 (bank 1)
+    SHADOW_GPIO,         // 0x6B (bank 1)
+    SHADOW_ENABLE,       // 0x80
+    SHADOW_ATIME,        // 0x81
+    SHADOW_WTIME,        // 0x83
+    SHADOW_SP_TH_L_LSB,  // 0x84
+    SHADOW_SP_TH_L_MSB,  // 0x85
+    SHADOW_SP_TH_H_LSB,  // 0x86
+    SHADOW_SP_TH_H_MSB,  // 0x87
+    SHADOW_CFG1,         // 0xC6
+    SHADOW_CFG3,         // 0xC7
+    SHADOW_CFG8,         // 0xC9
+    SHADOW_CFG9,         // 0xCA
+    SHADOW_LED,          // 0xCD
+    SHADOW_PERS,         // 0xCF
+    SHADOW_ASTEP_L,      // 0xD4
+    SHADOW_ASTEP_H,      // 0xD5
+    SHADOW_CFG20,        // 0xD6
+    SHADOW_AGC_GAIN_MAX, // 0xD7
+    SHADOW_AZ_CONFIG,    // 0xDE
+    SHADOW_FD_CFG0,      // 0xDF
+    SHADOW_FD_TIME_1,    // 0xE0
+    SHADOW_FD_TIME_2,    // 0xE2
+    SHADOW_INTENAB,      // 0xF9
+    SHADOW_FIFO_MAP,     // 0xFC
+    SHADOW_NUM_REGS,     // Number of shadowed registers
+} sfe_as7343_shadow_reg_t;
+
+// Sensor configuration, applied as one batch by applyConfig().
+// Fill it from the current device state with getConfig(), change the fields of
+// interest, then hand it to applyConfig(). Only registers whose value actually
+// changes are written.
+typedef struct
+{
+    sfe_as7343_again_t again;                         // Spectral gain (CFG1)
+    uint8_t atime;                                    // Integration steps, ATIME + 1
+    uint16_t astep;                                   // Integration step size, (ASTEP + 1) x 2.78us
+    uint8_t wtime;                                    // Wait time, (WTIME + 1) x 2.78ms
+    sfe_as7343_auto_smux_channel_t autoSmux;          // Automatic channel read-out (CFG20)
+    uint8_t ledDrive;                                 // LED drive current, 0-127 (4-258mA)
+    bool ledOn;                                       // LED_ACT
+    uint16_t spThL;                                   // Spectral interrupt threshold low
+    uint16_t spThH;                                   // Spectral interrupt threshold high
+    uint8_t apers;                                    // Spectral interrupt persistence, 0-15
+    sfe_as7343_spectral_threshold_channel_t spThCh; // Spectral threshold channel (CFG12)
+    bool spectralMeasurement;                         // SP_EN
+    bool waitTime;                                    // WEN
+    bool flickerDetection;                            // FDEN
+} sfe_as7343_config_t;
+
+///////////////////////////////////////////////////////////////////////////////
+// Asynchronous Bus Interface
+///////////////////////////////////////////////////////////////////////////////
+
+// Optional interface for buses that can run a register read in the background (DMA, interrupt
+// driven I2C, a worker task, ...). Hand one to sfDevAS7343::setAsyncBus() and startRead() submits
+// the data burst through it, instead of blocking on the sfTkIBus. No board implementation ships
+// with the library, SimAsyncI2CBus in extras/host_bench is one on a simulated bus.
+class sfDevAS7343AsyncBus
+{
+  public:
+    virtual ~sfDevAS7343AsyncBus()
+    {
+    }
+
+    /// @brief Start reading registers in the background.
+    /// @details Must return without waiting for the transfer. The driver does
+    /// not touch the buffer until the read is finished.
+    /// @param devReg The first register to read.
+    /// @param data Pointer to the buffer to read into.
+    /// @param numBytes Number of bytes to read.
+    /// @return True if the read was submitted, false if it fails.
+    virtual bool startReadRegister(uint8_t devReg, uint8_t *data, size_t numBytes) = 0;
+
+    /// @brief Check on the read started by startReadRegister().
+    /// @param readBytes Set to the number of bytes read, once the read is finished.
+    /// @return READ_STATE_BUSY while the read is in flight, READ_STATE_COMPLETE
+    /// or READ_STATE_FAILED once it is finished.
+    virtual sfe_as7343_read_state_t pollReadRegister(size_t &readBytes) = 0;
+
+    /// @brief Have the bus tell the driver when a read is finished.
+    /// @details Optional, for buses that know when a transfer ends (a worker
+    /// task, a transfer complete interrupt, ...). Such a bus stores the
+    /// callback, and calls it once per read, after pollReadRegister() reports
+    /// the result. The driver then finishes the read in the callback, and
+    /// poll() doesn't ask the bus anymore.
+    /// @param callback Function to call, nullptr to stop calling.
+    /// @param context Value to pass to the callback.
+    /// @return True if the bus will call the callback, false if it can't (the
+    /// default), the driver then polls.
+    virtual bool setCompletionCallback(void (*callback)(void *context), void *context)
+    {
+        (void)callback;
+        (void)context;
+
+        return false;
+    }
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+///////////////////////////////////////////////////////////////////////////////
+// Bus instrumentation (SFE_AS7343_STATS)
+///////////////////////////////////////////////////////////////////////////////
+
+// API calls the bus traffic is counted for. Traffic of a call made inside
+// another one (e.g. the gain change of the auto-ranging in readFrame()) is
+// counted for the inner call, the time of the outer call includes it. The
+// burst of a background read (startRead(), startFifoRead()) is counted when it
+// finishes, its time is not in the call.
+typedef enum
+{
+    STATS_OP_READ_DATA = 0x00, // readSpectraDataFromSensor(), startRead()
+    STATS_OP_READ_FRAME,       // readFrame()
+    STATS_OP_READ_FIFO,        // readFifoBytes(), readFifoEntries(), startFifoRead()
+    STATS_OP_READ_REGISTER,    // readRegisterBank(), the status getters
+    STATS_OP_WRITE_SETTING,    // Configuration register writes, all setters
+    STATS_OP_OTHER,            // Everything else (begin(), control and status writes, ...)
+    STATS_OP_NUM,              // Number of operations
+} sfe_as7343_stats_op_t;
+
+// Bus statistics of one operation. Times are in the units of the timestamp
+// source (see setTimestampSource(), microseconds with the Arduino driver).
+typedef struct
+{
+    uint32_t calls;        // API calls, STATS_OP_OTHER counts none
+    uint32_t reads;        // Register read transactions
+    uint32_t writes;       // Register write transactions, bank switches included
+    uint32_t bytes;        // Register bytes read and written
+    uint32_t bankSwitches; // Register bank changes (CFG0 writes for the bank)
+    uint32_t failures;     // Transactions the bus reported an error for
+    uint32_t minTime;      // Shortest call, 0 without calls
+    uint32_t maxTime;      // Longest call
+    uint32_t avgTime;      // Average call
+    uint32_t totalTime;    // All calls together
+} sfe_as7343_op_stats_t;
+
+// Snapshot of the bus statistics, see getStats().
+typedef struct
+{
+    sfe_as7343_op_stats_t op[STATS_OP_NUM]; // Indexed by sfe_as7343_stats_op_t
+} sfe_as7343_stats_t;
+
+class sfDevAS7343DarkOffsets; // Dark offset table, see sfDevAS7343DarkOffsets.h
+
 class sfDevAS7343
 {
   public:
-    sfDevAS7343() : _data{0}, _theBus{nullptr}
+    sfDevAS7343()
+        : _data{}, _front{0}, _theBus{nullptr}, _cfg0{}, _cfg0Valid{false}, _shadow{0}, _shadowValid{false},
+          _shadowVerify{false}, _asyncBus{nullptr}, _asyncNotifies{false}, _readState{READ_STATE_IDLE},
+          _readBuffer{0}, _readFirst{0}, _readCount{0}, _fifoReadData{nullptr}, _fifoReadEntries{0},
+          _fifoReadCount{0}, _readCallback{nullptr}, _channelMask{ksfAS7343AllChannels},
+          _cycleOverheadUs{0}, _autoGain{false}, _autoGainMin{AGAIN_0_5}, _autoGainMax{AGAIN_2048},
+          _autoGainLow{10}, _autoGainHigh{80}, _scaleKey{0xFFFFFFFF}, _scale{0}, _scaleMant{0}, _scaleShift{0},
+          _armed{false}, _dataSequence{0, 0}, _dataTimestamp{0, 0}, _timestampSource{nullptr},
+          _darkOffsets{nullptr}
     {
+        _statsOp = STATS_OP_OTHER;
+        resetStats();
     }
 
     /// @brief This method is called to initialize the AS7343 device through the
     /// specified bus.
+    /// @details Also fills the shadow register file (see syncShadowRegisters()).
     /// @param theBus Pointer to the bus object.
     /// @return True if successful, false if it fails.
     bool begin(sfTkIBus *theBus = nullptr);
 
+    /// @brief Initialize, configure, power on and start the device in one pass.
+    /// @details The fast start sequence for nodes that wake, take one reading
+    /// and sleep: check the device ID, fill the shadow register file (bank 1
+    /// first, right after the ID read), then apply the configuration, PON
+    /// included, as one applyConfig() batch. No fixed delays are needed, the
+    /// first data is ready firstDataUs after this method returns.
+    /// @param theBus Pointer to the bus object, nullptr to keep the current bus.
+    /// @param config The configuration to apply, e.g. from getDefaultConfig().
+    /// Set config.spectralMeasurement to start measuring right away.
+    /// @param firstDataUs Set to the time until the first spectral data is
+    /// ready, in microseconds: all SMUX cycles of one measurement, plus the
+    /// auto zero (ksfAS7343AutoZeroTimeUs) when it runs before the first
+    /// measurement. 0 if the measurement wasn't started.
+    /// @return True if successful, false if it fails.
+    bool beginFast(sfTkIBus *theBus, const sfe_as7343_config_t &config, uint32_t &firstDataUs);
+
+    /// @brief Get the power-on default configuration.
+    /// @details Fills the configuration with the register defaults from the
+    /// datasheet, without any I2C traffic. A starting point for beginFast().
+    /// @param config Reference to the configuration to fill.
+    static void getDefaultConfig(sfe_as7343_config_t &config);
+
     /// @brief Requests the device ID from the sensor.
     /// @return The device ID of the sensor.
     uint8_t getDeviceID(void);
@@ -671,10 +927,22 @@ class sfDevAS7343
     /// @param theBus Bus to set as the communication device.
     void setCommunicationBus(sfTkIBus *theBus);
 
+    /// @brief Sets the communication bus, and the asynchronous bus that runs
+    /// the data and FIFO bursts in the background.
+    /// @details See setAsyncBus(). Both buses must talk to the same device.
+    /// @param theBus Bus to set as the communication device.
+    /// @param asyncBus Asynchronous bus for startRead() and startFifoRead(),
+    /// nullptr for none.
+    /// @return True if successful, false if a read is still in flight.
+    bool setCommunicationBus(sfTkIBus *theBus, sfDevAS7343AsyncBus *asyncBus);
+
     /// @brief Set the register bank.
     /// In order to access registers from 0x58 to 0x66, bit REG_BANK in register
     /// CFG0 (0xBF) needs to be set to “1”. For register access of registers
     /// 0x80 and above bit REG_BANK needs to be set to “0”
+    /// @details The driver keeps a shadow copy of CFG0, so CFG0 is only read
+    /// once and only written when the bank actually changes. The shadow is
+    /// dropped by reset() and setCommunicationBus().
     /// @param regBank The register bank to set.
     /// @details Options: REG_BANK_0 (default), REG_BANK_1.
     /// @return True if successful, false if it fails.
@@ -707,9 +975,46 @@ class sfDevAS7343
     /// @return True if successful, false if it fails.
     bool disableSpectralMeasurement(void);
 
+    /// @brief Arm a triggered spectral measurement.
+    /// @details Gets the device ready to start a measurement with a single
+    /// write: powered on, spectral measurement stopped, register bank 0
+    /// selected (so the trigger needs no bank switch) and the STATUS flags
+    /// of earlier measurements cleared. The measurement starts with
+    /// triggerSpectralMeasurement(), or with a write of
+    /// getTriggerEnableValue() to the ENABLE register that reaches several
+    /// devices at once (then call setTriggered()).
+    /// @return True if successful, false if it fails.
+    bool armSpectralMeasurement(void);
+
+    /// @brief Get the armed state.
+    /// @details The device stops being armed when it is triggered, or when a
+    /// setter switches the register bank or changes the ENABLE register.
+    /// @return True if the device is armed and waiting for a trigger, false if it is not.
+    bool isArmed(void);
+
+    /// @brief Get the ENABLE register value that starts the armed measurement.
+    /// @return The ENABLE register value, 0 if the device is not armed.
+    uint8_t getTriggerEnableValue(void);
+
+    /// @brief Start the armed measurement.
+    /// @details Writes getTriggerEnableValue() to the ENABLE register, a
+    /// single write with no bank switch.
+    /// @return True if successful, false if it fails or the device is not armed.
+    bool triggerSpectralMeasurement(void);
+
+    /// @brief Record that the armed measurement was started from outside the driver.
+    /// @details Call this after writing getTriggerEnableValue() to the ENABLE
+    /// register of several devices at once, so the shadow register file
+    /// matches the device again. No I2C traffic.
+    /// @return True if successful, false if the device was not armed.
+    bool setTriggered(void);
+
     /// @brief Read all Spectral Data Registers
     /// @details This method reads all the spectral data registers from the
     /// AS7343 device. The data is stored in this drivers private struct variables.
+    /// @details Only the data registers the AutoSmux setting fills (6, 12 or
+    /// 18 channels) and the channel mask selects (see setChannelMask()) are
+    /// read, in one burst.
     /// @details The data is stored in the _data array in the class. You can
     /// access the data using the getData() method, which returns the data from
     /// the specified channel. Another option is to use the getRed(), getGreen(),
@@ -717,6 +1022,95 @@ class sfDevAS7343
     /// @return True if successful, false if it fails.
     bool readSpectraDataFromSensor(void);
 
+    /// @brief Read the Spectral Data Registers straight into a caller buffer.
+    /// @details Reads the same channels as readSpectraDataFromSensor(), in one
+    /// burst, into data[first channel read] onwards, and converts them to host
+    /// byte order in place. Nothing is copied through the driver, so the
+    /// buffer can be a ring buffer slot or DMA queue entry. Channels outside
+    /// the read window are left untouched, and the driver's own data (see
+    /// getData()) is not changed.
+    /// @param data Buffer indexed by sfe_as7343_channel_t, e.g. frame.data.
+    /// @param size Number of words in the buffer, at least the last channel
+    /// read + 1 (ksfAS7343NumChannels always fits).
+    /// @return True if successful, false if it fails or the buffer is too small.
+    bool readSpectraDataFromSensor(uint16_t *data, size_t size);
+
+    /// @brief Read the status registers and the spectral data in one burst.
+    /// @details STATUS2 (0x90) through the data registers are consecutive, so
+    /// this method reads them with a single auto-increment read. ASTATUS comes
+    /// before the data in the burst, which latches the data to it, so the
+    /// status, gain and data all belong to the same measurement. The read is
+    /// sized like readSpectraDataFromSensor() (AutoSmux setting and channel
+    /// mask). The data is also stored in the driver, like
+    /// readSpectraDataFromSensor().
+    /// @details The STATUS flags are not cleared, pass frame.status to
+    /// clearStatusReg() for that. frame.timestamp is the time of the read,
+    /// from the timestamp source (see setTimestampSource()), 0 without one.
+    /// @param frame Reference to the frame to fill.
+    /// @return True if successful, false if it fails.
+    bool readFrame(sfe_as7343_frame_t &frame);
+
+    /// @brief Set the asynchronous bus used by startRead() and startFifoRead().
+    /// @details Without one, startRead() falls back to a blocking read on the
+    /// communication bus. If the bus reports when reads finish (see
+    /// sfDevAS7343AsyncBus::setCompletionCallback()), reads are finished, and
+    /// the read callback called, from the bus' context.
+    /// @param asyncBus Pointer to the asynchronous bus, or nullptr to remove it.
+    /// @return True if successful, false if a read is still in flight.
+    bool setAsyncBus(sfDevAS7343AsyncBus *asyncBus);
+
+    /// @brief Start reading all Spectral Data Registers without blocking.
+    /// @details The data registers (limited like readSpectraDataFromSensor()
+    /// by the AutoSmux setting and channel mask) are read in one burst through the
+    /// asynchronous bus (see setAsyncBus()) into a buffer inside the driver.
+    /// Call poll() or isReadComplete() until the read is finished, the data is
+    /// then available through getData() and getChannelData(). Until then, those
+    /// return the data of the previous read. With no asynchronous bus set, the
+    /// read is done right away and is already complete when this returns.
+    /// @details Do not use other methods of the driver while a read is in
+    /// flight, they would share the bus with it.
+    /// @return True if the read was started, false if it fails or a read is
+    /// already in flight.
+    bool startRead(void);
+
+    /// @brief Check on the read started by startRead().
+    /// @details This method never blocks.
+    /// @return The read state: READ_STATE_IDLE, READ_STATE_BUSY,
+    /// READ_STATE_COMPLETE or READ_STATE_FAILED.
+    sfe_as7343_read_state_t poll(void);
+
+    /// @brief Check if the read started by startRead() has finished.
+    /// @details This method calls poll() and never blocks.
+    /// @return True if the read is complete and the data is available, false
+    /// if it is still in flight (or it failed).
+    bool isReadComplete(void);
+
+    /// @brief Start draining the FIFO without blocking.
+    /// @details Reads FIFO_LVL (one blocking byte), then submits the entries as
+    /// one burst through the asynchronous bus, like startRead(). Check on it
+    /// with poll() or isReadComplete(), getFifoReadCount() then has the number
+    /// of entries in data. With no asynchronous bus set, the read is done
+    /// right away, like readFifo().
+    /// @param data Pointer to the buffer to store the entries, it must stay
+    /// valid until the read is finished.
+    /// @param maxEntries Size of the buffer, in entries.
+    /// @return True if the read was started, false if it fails (the FIFO_LVL
+    /// read included, poll() then returns READ_STATE_FAILED) or a read is
+    /// already in flight.
+    bool startFifoRead(uint16_t *data, size_t maxEntries);
+
+    /// @brief Get the number of entries the last startFifoRead() read.
+    /// @return The number of entries, 0 while the read is in flight or if it failed.
+    size_t getFifoReadCount(void);
+
+    /// @brief Set the function called when a read of startRead() or
+    /// startFifoRead() finishes.
+    /// @details Called from poll(), or from the asynchronous bus' context
+    /// (task, interrupt) if it reports when reads finish. Keep it short there.
+    /// @param callback Function to call with the device and the final state
+    /// (READ_STATE_COMPLETE or READ_STATE_FAILED), nullptr for none.
+    void setReadCallback(void (*callback)(sfDevAS7343 *device, sfe_as7343_read_state_t state));
+
     /// @brief Get data from the sensor using a pointer to an array and the desired data length
     /// @details You must call the readSpectraDataFromSensor() method before calling this
     /// method to get the most recent data from the specified channel.
@@ -727,6 +1121,91 @@ class sfDevAS7343
     /// @return The number of channel data bytes written to the desired array pointer
     uint8_t getData(uint16_t *data, size_t size);
 
+    /// @brief Get a read-only view of the data of the last read, without copying.
+    /// @details The view has ksfAS7343NumChannels words in host byte order,
+    /// indexed by sfe_as7343_channel_t. It shows the last complete read until
+    /// the second read after it starts filling that buffer again. Channels the
+    /// last read didn't cover hold older data.
+    /// @return Pointer to the channel data.
+    const uint16_t *getDataView(void) const;
+
+    /// @brief Get the data of the last complete read, with its sequence number and timestamp.
+    /// @details Reads fill a second buffer and only then switch over, so a
+    /// failed read never shows, and the data is always from one read. This
+    /// version is safe to call while another context (an ISR, a second core)
+    /// reads the device: if the buffer is rewritten while it is copied, the
+    /// copy is retried.
+    /// @param data Pointer to the array to store the data.
+    /// @param size Size of the array, up to ksfAS7343NumChannels.
+    /// @param sequence Set to the frame sequence number (see getFrameSequence()).
+    /// @param timestamp Set to the frame timestamp (see getFrameTimestamp()).
+    /// @return The number of channels written, 0 on error.
+    uint8_t getData(uint16_t *data, size_t size, uint32_t &sequence, uint32_t &timestamp);
+
+    /// @brief Get the sequence number of the last complete read.
+    /// @details Counts up by one with every read into the driver
+    /// (readSpectraDataFromSensor(), readFrame(), startRead()), starting at 1.
+    /// A jump of more than one since the last look means frames were missed.
+    /// @return The sequence number, 0 before the first read.
+    uint32_t getFrameSequence(void);
+
+    /// @brief Get the timestamp of the last complete read.
+    /// @return The timestamp source's time when the read finished, 0 without
+    /// a timestamp source.
+    uint32_t getFrameTimestamp(void);
+
+    /// @brief Set the clock used to timestamp reads.
+    /// @details The Arduino driver uses micros().
+    /// @param source Function returning the current time, nullptr for none.
+    void setTimestampSource(uint32_t (*source)(void));
+
+    /// @brief Get the data of the last read as basic counts.
+    /// @details Basic counts are the raw counts divided by the gain and by the
+    /// integration time in milliseconds, so they can be compared across gain
+    /// and ATIME/ASTEP settings. The scale factor is cached and only
+    /// recomputed when the gain or integration time changes, each channel
+    /// costs one multiply. This method uses the configured gain, the frame
+    /// version uses the gain the frame was measured with.
+    /// @param basicCounts Pointer to the array to store the basic counts.
+    /// @param size Size of the array, up to ksfAS7343NumChannels.
+    /// @return The number of channels written, 0 on error.
+    uint8_t getBasicCounts(float *basicCounts, size_t size);
+
+    /// @brief Get the data of a frame as basic counts.
+    /// @details See getBasicCounts(float *, size_t). The gain is taken from
+    /// the frame (ASTATUS), the integration time from the shadow registers.
+    /// @param frame Frame from readFrame().
+    /// @param basicCounts Pointer to the array to store the basic counts.
+    /// @param size Size of the array, up to ksfAS7343NumChannels.
+    /// @return The number of channels written, 0 on error.
+    uint8_t getBasicCounts(const sfe_as7343_frame_t &frame, float *basicCounts, size_t size);
+
+    /// @brief Get the data of the last read as fixed point basic counts.
+    /// @details Like getBasicCounts(), without floating point math, for MCUs
+    /// without an FPU. The values are unsigned 16.16 fixed point (divide by
+    /// 65536 for basic counts) and saturate at 0xFFFFFFFF.
+    /// @param normalized Pointer to the array to store the values.
+    /// @param size Size of the array, up to ksfAS7343NumChannels.
+    /// @return The number of channels written, 0 on error.
+    uint8_t getNormalizedData(uint32_t *normalized, size_t size);
+
+    /// @brief Get the data of a frame as fixed point basic counts.
+    /// @details See getNormalizedData(uint32_t *, size_t) and
+    /// getBasicCounts(const sfe_as7343_frame_t &, float *, size_t).
+    /// @param frame Frame from readFrame().
+    /// @param normalized Pointer to the array to store the values.
+    /// @param size Size of the array, up to ksfAS7343NumChannels.
+    /// @return The number of channels written, 0 on error.
+    uint8_t getNormalizedData(const sfe_as7343_frame_t &frame, uint32_t *normalized, size_t size);
+
+    /// @brief Get the basic counts per raw count.
+    /// @details The factor getBasicCounts() multiplies every channel with,
+    /// for stages that scale once after combining channels.
+    /// @param gain The gain the data was measured with.
+    /// @param scale Reference to store the factor.
+    /// @return True if successful, false if it fails.
+    bool getBasicCountsScale(sfe_as7343_again_t gain, float &scale);
+
     // version that just takes an array that is of size ksfAS7343NumChannels
     uint8_t getData(uint16_t data[ksfAS7343NumChannels])
     {
@@ -743,6 +1222,27 @@ class sfDevAS7343
     /// @return True if successful, false if it fails.
     bool setAutoSmux(sfe_as7343_auto_smux_channel_t auto_smux);
 
+    /// @brief Get the number of channels the automatic channel read-out fills.
+    /// @details This method decodes the auto_smux setting in the shadow copy of
+    /// the CFG20 register (ksfAS7343RegCfg20), no I2C traffic is needed.
+    /// @return 6, 12 or 18. Returns 0 on error.
+    uint8_t getAutoSmuxChannelCount(void);
+
+    /// @brief Select which channels the data reads fetch.
+    /// @details Bit n of the mask selects channel n (see sfe_as7343_channel_t).
+    /// The data registers are consecutive, so reads fetch one burst from the
+    /// first to the last selected channel that the AutoSmux setting fills, and
+    /// channels outside that burst keep the value of the last read that
+    /// included them.
+    /// @param channelMask Channels to read, not 0. The default is
+    /// ksfAS7343AllChannels.
+    /// @return True if successful, false if the mask is invalid.
+    bool setChannelMask(uint32_t channelMask);
+
+    /// @brief Get the channel mask.
+    /// @return The channels selected by setChannelMask().
+    uint32_t getChannelMask(void);
+
     /// @brief Turn on or off the LED.
     /// @details This method turns on or off the LED by setting or clearing the
     /// LED_ACT bit in the LED register (ksfAS7343RegLed).
@@ -810,6 +1310,15 @@ class sfDevAS7343
     /// @return True if successful, false if it fails.
     bool setSpectralIntThresholdLow(uint16_t spThL);
 
+    /// @brief Set both spectral interrupt thresholds.
+    /// @details This method writes the SP_TH_L and SP_TH_H registers
+    /// (ksfAS7343RegSpThL, ksfAS7343RegSpThH) in one I2C write, so the window
+    /// can be moved without a half updated state in between.
+    /// @param spThL The spectral threshold low to set.
+    /// @param spThH The spectral threshold high to set.
+    /// @return True if successful, false if it fails.
+    bool setSpectralIntThresholds(uint16_t spThL, uint16_t spThH);
+
     /// @brief Enable or Disable the spectral interrupt.
     /// @details This method enables or disables the spectral interrupt by
     /// setting or clearing the SP_IEN bit in the INT_ENAB register
@@ -896,6 +1405,131 @@ class sfDevAS7343
     /// @return True if successful, false if it fails.
     bool disableWaitTime(void);
 
+    /// @brief Enable or Disable the long wait time.
+    /// @details This method sets or clears the WLONG bit in the CFG0 register
+    /// (ksfAS7343RegCfg0), which multiplies the wait time by 16.
+    /// @param enable True to enable the long wait time, false to disable.
+    /// @return True if successful, false if it fails.
+    bool enableWaitLong(bool enable = true);
+
+    /// @brief Disable the long wait time.
+    /// @return True if successful, false if it fails.
+    bool disableWaitLong(void);
+
+    /// @brief Set the wait time in milliseconds.
+    /// @details Picks WTIME, and WLONG for waits over (255 + 1) x 2.78ms, to
+    /// get as close to the requested time as the device allows. The longest
+    /// wait is (255 + 1) x 2.78ms x 16, about 11.4s.
+    /// @param waitTimeMs The wait time between measurements, in milliseconds.
+    /// @return True if successful, false if it fails or the time is too long.
+    bool setWaitTimeMs(uint32_t waitTimeMs);
+
+    /// @brief Enable or Disable the low power idle mode.
+    /// @details This method sets or clears the LOW_POWER bit in the CFG0
+    /// register (ksfAS7343RegCfg0). When set, the device drops to a low power
+    /// state whenever all functions are waiting or disabled, e.g. during the
+    /// wait time or sleep after interrupt.
+    /// @param enable True to enable the low power idle mode, false to disable.
+    /// @return True if successful, false if it fails.
+    bool enableLowPower(bool enable = true);
+
+    /// @brief Disable the low power idle mode.
+    /// @return True if successful, false if it fails.
+    bool disableLowPower(void);
+
+    /// @brief Enable or Disable sleep after interrupt.
+    /// @details This method sets or clears the SAI bit in the CFG3 register
+    /// (ksfAS7343RegCfg3). When set, the device turns its oscillator off as
+    /// soon as an interrupt is asserted and sleeps (SAI_ACTIVE) until
+    /// resumeAfterInterrupt() is called.
+    /// @param enable True to enable sleep after interrupt, false to disable.
+    /// @return True if successful, false if it fails.
+    bool enableSleepAfterInterrupt(bool enable = true);
+
+    /// @brief Disable sleep after interrupt.
+    /// @return True if successful, false if it fails.
+    bool disableSleepAfterInterrupt(void);
+
+    /// @brief Get the Sleep After Interrupt Active Status.
+    /// @details This method reads the SAI_ACT bit in the STATUS4 register
+    /// (ksfAS7343RegStatus4).
+    /// @return True if the device sleeps after an interrupt, false if it does not.
+    bool isSleepAfterInterruptActive(void);
+
+    /// @brief Wake the device from sleep after interrupt.
+    /// @details Clears the flags in the STATUS register, then sets the
+    /// CLEAR_SAI_ACT bit in the CONTROL register (ksfAS7343RegControl), which
+    /// ends the sleep and restarts the measurement cycle. Read the data first.
+    /// @return True if successful, false if it fails.
+    bool resumeAfterInterrupt(void);
+
+    /// @brief Configure a duty-cycled measurement.
+    /// @details Sets the device up to take one measurement, assert INT, and
+    /// sleep until resumeAfterInterrupt(): spectral interrupt on every
+    /// measurement (APERS 0), sleep after interrupt, low power idle, and the
+    /// wait time (see setWaitTimeMs()) between the resume and the next
+    /// measurement. The MCU can deep-sleep until INT wakes it. For periods
+    /// longer than the wait time allows, resume later: the device sleeps for
+    /// as long as the interrupt stays unserviced. Enable the spectral
+    /// measurement afterwards to start.
+    /// @param waitTimeMs The wait time after each resume, in milliseconds.
+    /// @return True if successful, false if it fails.
+    bool setDutyCycle(uint32_t waitTimeMs);
+
+    /// @brief Set the spectral integration time.
+    /// @details This method writes the ATIME register (ksfAS7343RegATime) and
+    /// the ASTEP registers (ksfAS7343RegAStep). The integration time is
+    /// (ATIME + 1) x (ASTEP + 1) x 2.78us, and the ADC full scale is
+    /// (ATIME + 1) x (ASTEP + 1) counts, up to 65535.
+    /// @param atime Number of integration steps minus one, 0-255.
+    /// @param astep Integration step size minus one, 0-65534. ATIME and ASTEP
+    /// must not both be 0.
+    /// @return True if successful, false if it fails.
+    bool setIntegrationTime(uint8_t atime, uint16_t astep);
+
+    /// @brief Set the spectral integration time in microseconds.
+    /// @details This method picks the ATIME and ASTEP that come closest to the
+    /// requested time, then calls setIntegrationTime(atime, astep). Use
+    /// getIntegrationTimeUs() for the exact time that was set.
+    /// @param integrationTimeUs The integration time, 6us to about 46.6s.
+    /// @return True if successful, false if it fails.
+    bool setIntegrationTime(uint32_t integrationTimeUs);
+
+    /// @brief Get the spectral integration time settings.
+    /// @details This method gets ATIME and ASTEP from the shadow register file.
+    /// @param atime Reference to store ATIME.
+    /// @param astep Reference to store ASTEP.
+    /// @return True if successful, false if it fails.
+    bool getIntegrationTime(uint8_t &atime, uint16_t &astep);
+
+    /// @brief Get the spectral integration time in microseconds.
+    /// @return The integration time of one SMUX cycle in microseconds. Returns
+    /// 0 on error.
+    uint32_t getIntegrationTimeUs(void);
+
+    /// @brief Set the time the device takes between SMUX cycles.
+    /// @details The datasheet does not specify how long switching the SMUX
+    /// between cycles takes, so getFramePeriodUs() leaves it out by default.
+    /// Measure it once (e.g. from the interval between spectral interrupts with
+    /// the wait time disabled) and set it here to make the period exact.
+    /// @param overheadUs Time added per SMUX cycle, in microseconds.
+    void setCycleOverheadUs(uint16_t overheadUs);
+
+    /// @brief Get the time the device takes between SMUX cycles.
+    /// @return The time set with setCycleOverheadUs(), in microseconds.
+    uint16_t getCycleOverheadUs(void);
+
+    /// @brief Get the spectral frame period.
+    /// @details This method computes the time from the start of one complete
+    /// spectral measurement (all SMUX cycles of the AutoSmux setting) to the
+    /// start of the next. The measurement takes one integration time plus the
+    /// cycle overhead (see setCycleOverheadUs()) per SMUX cycle. With the wait
+    /// time enabled the period is the wait time, (WTIME + 1) x 2.78ms (x 16
+    /// with WLONG), or the measurement time if that is longer. Only the shadow
+    /// registers are used, so this method normally does no I2C traffic.
+    /// @return The frame period in microseconds. Returns 0 on error.
+    uint32_t getFramePeriodUs(void);
+
     /// @brief Get the Spectral Valid Status.
     /// @details This method gets the spectral valid status by reading the AVALID
     /// bit in the STATUS2 register (ksfAS7343RegStatus2).
@@ -963,6 +1597,143 @@ class sfDevAS7343
     /// @return True if successful, false if it fails.
     bool readRegisterBank(uint8_t reg, uint8_t &data);
 
+    /// @brief Fill the shadow register file from the device.
+    /// @details The driver keeps a RAM copy of the writable configuration
+    /// registers (sfe_as7343_shadow_reg_t), so setters only write to the device
+    /// instead of doing a read-modify-write. This is done by begin(), and lazily
+    /// after reset() or setCommunicationBus(). Call it again if something other
+    /// than this driver changes the device configuration.
+    /// @return True if successful, false if it fails.
+    bool syncShadowRegisters(void);
+
+    /// @brief Enable or disable shadow verify mode.
+    /// @details When enabled, every configuration write is read back from the
+    /// device and compared against the value written. Useful for debugging bus
+    /// or wiring issues, at the cost of an extra read per write.
+    /// @param enable True to enable verify mode, false to disable (default).
+    void setShadowVerify(bool enable = true);
+
+    /// @brief Get the shadow verify mode.
+    /// @return True if verify mode is enabled, false if it is not.
+    bool getShadowVerify(void);
+
+    /// @brief Get the current sensor configuration.
+    /// @details Decodes the shadow register file into a sfe_as7343_config_t, no
+    /// I2C traffic is needed once the shadow is filled.
+    /// @param config Reference to the configuration struct to fill.
+    /// @return True if successful, false if it fails.
+    bool getConfig(sfe_as7343_config_t &config);
+
+    /// @brief Apply a full sensor configuration in as few I2C transactions as possible.
+    /// @details The configuration is compared against the shadow register file
+    /// and only changed registers are written. Changed registers at consecutive
+    /// addresses are written in a single auto-increment burst, and writes are
+    /// grouped by register bank. Clearing enable bits happens before, and
+    /// setting them after, everything else, so measurements never run on a
+    /// half applied configuration. The bank is therefore switched at most three
+    /// times: to bank 0 to clear enable bits, to bank 1 for the bank 1
+    /// registers, and back to bank 0 for the rest.
+    /// @param config The configuration to apply.
+    /// @return True if successful, false if it fails (or the config is invalid).
+    bool applyConfig(const sfe_as7343_config_t &config);
+
+    /// @brief Set which data is pushed into the FIFO.
+    /// @details This method writes the FIFO_MAP register (ksfAS7343RegFifoMap).
+    /// Each set bit in channelMask pushes the data of that ADC channel (CH0-CH5)
+    /// into the FIFO at the end of every SMUX cycle, two bytes per sample. With
+    /// AutoSmux set to 12 or 18 channels, each cycle pushes its own set of six
+    /// channels (see sfe_as7343_channel_t for the cycle order).
+    /// @param channelMask Bit mask of ADC channels, bit 0 = CH0 ... bit 5 = CH5.
+    /// @param writeAStatus True to also push ASTATUS (one byte per sample).
+    /// @return True if successful, false if it fails.
+    bool setFifoMap(uint8_t channelMask, bool writeAStatus = false);
+
+    /// @brief Set the FIFO threshold.
+    /// @details This method sets the FIFO_TH bits in the CFG8 register
+    /// (ksfAS7343RegCfg8). A FIFO interrupt (FINT) is raised once FIFO_LVL
+    /// reaches the threshold.
+    /// @param threshold The FIFO threshold to set.
+    /// @details Options: FIFO_THRESHOLD_LVL_1, FIFO_THRESHOLD_LVL_4,
+    /// FIFO_THRESHOLD_LVL_8 (default), FIFO_THRESHOLD_LVL_16.
+    /// @return True if successful, false if it fails.
+    bool setFifoThreshold(sfe_as7343_fifo_threshold_t threshold);
+
+    /// @brief Enable or Disable the FIFO interrupt.
+    /// @details This method enables or disables the FIFO interrupt by setting
+    /// or clearing the FIEN bit in the INT_ENAB register (ksfAS7343RegIntEnab).
+    /// @param enable True to enable the FIFO interrupt, false to disable.
+    /// @return True if successful, false if it fails.
+    bool enableFifoInterrupt(bool enable = true);
+
+    /// @brief Disable the FIFO interrupt.
+    /// @details This method disables the FIFO interrupt by calling the
+    /// enableFifoInterrupt method with false.
+    /// @return True if successful, false if it fails.
+    bool disableFifoInterrupt(void);
+
+    /// @brief Clear the FIFO.
+    /// @details This method sets the FIFO_CLR bit in the CONTROL register
+    /// (ksfAS7343RegControl), which clears all FIFO data, FINT, FIFO_OV and
+    /// FIFO_LVL.
+    /// @return True if successful, false if it fails.
+    bool clearFifo(void);
+
+    /// @brief Get the FIFO level.
+    /// @details This method reads the FIFO_LVL register (ksfAS7343RegFifoLvl).
+    /// @return The number of 2-byte entries waiting in the FIFO (0-128).
+    /// Returns 0 on error.
+    uint8_t getFifoLevel(void);
+
+    /// @brief Get the FIFO Overflow Status.
+    /// @details This method gets the FIFO overflow status by reading the
+    /// FIFO_OV bit in the STATUS4 register (ksfAS7343RegStatus4).
+    /// @return True if the FIFO has overflowed, false if it has not.
+    bool getFifoOverflowStatus(void);
+
+    /// @brief Drain the FIFO into a caller supplied buffer.
+    /// @details This method reads FIFO_LVL, then reads up to that many entries
+    /// in a single burst from FDATA (ksfAS7343RegFData). The FIFO read pointer
+    /// wraps from 0xFF to 0xFE on the device, so the whole drain is one I2C read.
+    /// @param data Pointer to the buffer to store the entries.
+    /// @param maxEntries Size of the buffer, in entries.
+    /// @return The number of entries written to the buffer. 0 on error, or if
+    /// the FIFO is empty.
+    size_t readFifo(uint16_t *data, size_t maxEntries);
+
+    /// @brief Drain the FIFO into a caller supplied byte buffer.
+    /// @details Like readFifo(), but stores the raw FIFO bytes. Use this when
+    /// one byte samples (ASTATUS, 8-bit flicker data) are mapped into the FIFO.
+    /// @param data Pointer to the buffer to store the bytes.
+    /// @param maxBytes Size of the buffer, in bytes. Only whole 2-byte entries
+    /// are read.
+    /// @return The number of bytes written to the buffer. 0 on error, or if
+    /// the FIFO is empty.
+    size_t readFifoBytes(uint8_t *data, size_t maxBytes);
+
+    /// @brief Read a known number of entries from the FIFO.
+    /// @details This method reads numEntries entries from FDATA
+    /// (ksfAS7343RegFData) in one burst, without reading FIFO_LVL first. Use it
+    /// when the level is already known, e.g. from getFifoLevel().
+    /// @param data Pointer to the buffer to store the entries.
+    /// @param numEntries Number of entries to read (1-128).
+    /// @return True if successful, false if it fails.
+    bool readFifoEntries(uint16_t *data, size_t numEntries);
+
+    /// @brief Read the STATUS register.
+    /// @details This method reads the whole STATUS register
+    /// (ksfAS7343RegStatus), so all interrupt flags are known from one read.
+    /// @param status Reference to the variable to store the register value.
+    /// @return True if successful, false if it fails.
+    bool readStatusReg(uint8_t &status);
+
+    /// @brief Clear interrupt flags in the STATUS register.
+    /// @details This method writes the given bits to the STATUS register
+    /// (ksfAS7343RegStatus). Flags are cleared by writing a 1 to them, so
+    /// passing the value from readStatusReg() clears everything that was set.
+    /// @param status The flags to clear.
+    /// @return True if successful, false if it fails.
+    bool clearStatusReg(uint8_t status);
+
     /// Brief Set AGAIN value
     /// @details This method sets the AGAIN value by writing to the AGAIN bits in
     /// the CFG1 register (ksfAS7343RegCfg1).
@@ -973,6 +1744,65 @@ class sfDevAS7343
     /// @return True if successful, false if it fails.
     bool setAgain(sfe_as7343_again_t again);
 
+    /// @brief Get the AGAIN value
+    /// @details This method gets the AGAIN bits of the CFG1 register
+    /// (ksfAS7343RegCfg1) from the shadow register file.
+    /// @return The AGAIN value. Returns AGAIN_0_5 on error.
+    sfe_as7343_again_t getAgain(void);
+
+    /// @brief Set the maximum gain of the flicker detection AGC.
+    /// @details The AS7343 has an on-chip AGC for flicker detection only. This
+    /// method sets its upper limit, the AGC_FD_GAIN_MAX bits in the
+    /// AGC_GAIN_MAX register (ksfAS7343RegAgcGainMax). Spectral measurements
+    /// have no on-chip AGC, see enableAutoGain() for that.
+    /// @param gainMax The maximum gain, FD_GAIN_0_5 to FD_GAIN_2048.
+    /// The default is FD_GAIN_256.
+    /// @return True if successful, false if it fails.
+    bool setFlickerGainMax(sfe_as7343_fd_gain_t gainMax);
+
+    /// @brief Enable or Disable spectral auto-ranging.
+    /// @details When enabled, every readFrame() is followed by
+    /// updateAutoGain(), so the gain tracks the light level without any extra
+    /// reads.
+    /// @param enable True to enable auto-ranging, false to disable.
+    void enableAutoGain(bool enable = true);
+
+    /// @brief Disable spectral auto-ranging.
+    void disableAutoGain(void);
+
+    /// @brief Set the gain range and count window of the auto-ranging.
+    /// @details The gain is left alone while the highest channel count stays
+    /// between lowPercent and highPercent of the ADC full scale. Once it leaves
+    /// that window, the gain that brings it closest to (below) the middle of
+    /// the window is set in a single step.
+    /// @param minGain Lowest gain to use.
+    /// @param maxGain Highest gain to use.
+    /// @param lowPercent Lower end of the window, in percent of full scale.
+    /// The default is 10.
+    /// @param highPercent Upper end of the window, in percent of full scale.
+    /// The default is 80.
+    /// @return True if successful, false if the settings are invalid.
+    bool setAutoGainRange(sfe_as7343_again_t minGain, sfe_as7343_again_t maxGain, uint8_t lowPercent = 10,
+                          uint8_t highPercent = 80);
+
+    /// @brief Pick the gain for the next measurement from a frame.
+    /// @details The highest count among the channels that were read is
+    /// compared with the ADC full scale, min(65535, (ATIME + 1) x (ASTEP + 1)).
+    /// The gain is scaled by the ratio to the target in one step (gain steps
+    /// are powers of two). A saturated frame has no usable count, so the gain
+    /// drops four steps at once. Frames measured with an older gain than the
+    /// one configured are ignored, the change is still on its way.
+    /// @param frame Frame from readFrame().
+    /// @return True if successful (including when the gain is kept), false if
+    /// it fails.
+    bool updateAutoGain(const sfe_as7343_frame_t &frame);
+
+    /// @brief Get the ADC full scale.
+    /// @return The highest count the data registers can reach with the current
+    /// integration time, min(65535, (ATIME + 1) x (ASTEP + 1)). Returns 0 on
+    /// error.
+    uint16_t getFullScale(void);
+
     /// @brief Enable or Disable the Flicker Detection
     /// @details This method enables or disables the flicker detection by setting
     /// or clearing the FD_EN bit in the ENABLE register (ksfAS7343RegEnable).
@@ -986,30 +1816,322 @@ class sfDevAS7343
     /// @return True if successful, false if it fails.
     bool disableFlickerDetection(void);
 
+    /// @brief Read the flicker detection status.
+    /// @details This method reads the FD_STATUS register (ksfAS7343RegFdStatus)
+    /// once and decodes all of its bits, so they all belong to the same
+    /// reading. Use it instead of the single bit getters below, which read
+    /// FD_STATUS again on every call.
+    /// @param status Reference to the struct to fill.
+    /// @return True if successful, false if it fails.
+    bool readFlickerStatus(sfe_as7343_flicker_status_t &status);
+
     /// @brief Get the Flicker Detection Measurement Valid Status
-    /// @details This method gets the flicker detection measurement valid status by
-    /// reading the FD_MEAS_VALID bit in the FD_STATUS register
-    /// (ksfAS7343RegFdStatus).
+    /// @details This method reads the FD_STATUS register
+    /// (ksfAS7343RegFdStatus) and returns its FD_MEAS_VALID bit.
     /// @return True if the flicker detection measurement is valid, false if it is not valid.
     bool isFlickerDetectionValid(void);
 
     /// @brief Get the Flicker Detection Saturation Detected Status
-    /// @details This method gets the flicker detection saturation detected status by
-    /// reading the FD_SATURATION bit in the FD_STATUS register
-    /// (ksfAS7343RegFdStatus).
+    /// @details This method reads the FD_STATUS register
+    /// (ksfAS7343RegFdStatus) and returns its FD_SATURATION bit.
     /// @return True if the flicker detection saturation is detected, false if it is not detected.
     bool isFlickerDetectionSaturated(void);
 
     /// @brief Get the Flicker Detection Frequency Detected
-    /// @details This method gets the flicker detection frequency detected by reading
-    /// the FD_100HZ_DET and FD_120HZ_DET bits in the FD_STATUS register
-    /// (ksfAS7343RegFdStatus).
+    /// @details This method reads the FD_STATUS register
+    /// (ksfAS7343RegFdStatus) and decodes its FD_100HZ_DET and FD_120HZ_DET
+    /// bits.
     /// @return The flicker detection frequency detected (100 or 120)
     /// or 0 if no frequency is detected.
     uint8_t getFlickerDetectionFrequency(void);
 
-  private:
-    sfe_as7343_reg_data_t _data[ksfAS7343NumChannels]; // Array of data structs, to hold data from the sensor.
+    /// @brief Set the flicker detection integration time.
+    /// @details This method sets FD_TIME, split over the FD_TIME_1
+    /// (ksfAS7343RegFdTime1) and FD_TIME_2 (ksfAS7343RegFdTime2) registers.
+    /// FD_TIME must not change while flicker detection runs, so flicker
+    /// detection is paused for the write if it is enabled.
+    /// @param fdTime The integration time in steps of 2.78us, 1 to
+    /// ksfAS7343FdTimeMax. The default is 359 (about 1ms).
+    /// @return True if successful, false if it fails.
+    bool setFlickerTime(uint16_t fdTime);
+
+    /// @brief Get the flicker detection integration time.
+    /// @details This method gets FD_TIME from the shadow register file.
+    /// @return The integration time in steps of 2.78us. Returns 0 on error.
+    uint16_t getFlickerTime(void);
+
+    /// @brief Set the flicker detection gain.
+    /// @details This method sets the FD_GAIN bits of the FD_TIME_2 register
+    /// (ksfAS7343RegFdTime2), pausing flicker detection like setFlickerTime().
+    /// @param gain The gain, FD_GAIN_0_5 to FD_GAIN_2048. The default is
+    /// FD_GAIN_256.
+    /// @return True if successful, false if it fails.
+    bool setFlickerGain(sfe_as7343_fd_gain_t gain);
+
+    /// @brief Get the time between flicker detection samples.
+    /// @details Flicker detection samples back to back, so this is the
+    /// integration time, FD_TIME x 2.78us.
+    /// @return The sample period in nanoseconds. Returns 0 on error.
+    uint32_t getFlickerSamplePeriodNs(void);
+
+    /// @brief Enable or Disable streaming of raw flicker detection samples.
+    /// @details When enabled, the flicker detection writes its raw samples to
+    /// the FIFO as 8-bit values (FD_FIFO_8b in CFG20 and FIFO_WRITE_FD in
+    /// FD_CFG0), other FIFO data is turned off (FIFO_MAP), the FIFO is
+    /// cleared and flicker detection is started. Drain the samples with
+    /// readFlickerSamples() faster than the FIFO fills, 256 samples take
+    /// 256 x getFlickerSamplePeriodNs(). When disabled, flicker detection
+    /// stops, the FIFO returns to 16-bit data and is cleared. Use
+    /// setFifoMap() to map spectral data again.
+    /// @details The 8-bit mode needs FD_TIME below 256, so a longer FD_TIME
+    /// (like the default of 359) is cut to ksfAS7343FdTimeStream when
+    /// streaming starts. It stays there after the stream is stopped.
+    /// @param enable True to start streaming, false to stop.
+    /// @return True if successful, false if it fails.
+    bool enableFlickerStream(bool enable = true);
+
+    /// @brief Disable streaming of raw flicker detection samples.
+    /// @details This method calls the enableFlickerStream method with false.
+    /// @return True if successful, false if it fails.
+    bool disableFlickerStream(void);
+
+    /// @brief Drain streamed flicker detection samples.
+    /// @details Reads the samples waiting in the FIFO in a single burst (see
+    /// readFifoBytes()). Each FIFO entry holds two samples, so the FIFO
+    /// buffers up to 256 of them. Check getFifoOverflowStatus() to find out if
+    /// samples were lost.
+    /// @param samples Pointer to the buffer for the samples.
+    /// @param maxSamples Size of the buffer, read in pairs.
+    /// @return The number of samples read, 0 if it fails or the FIFO is empty.
+    size_t readFlickerSamples(uint8_t *samples, size_t maxSamples);
+
+    /// @brief Set how often the spectral engines auto zero.
+    /// @details This method writes the AZ_CONFIG register
+    /// (ksfAS7343RegAzConfig). Every auto zero takes about
+    /// ksfAS7343AutoZeroTimeUs, which at short integration times costs more
+    /// than the measurement. Running it less often trades that time for
+    /// offset drift with temperature, which dark offsets (see
+    /// setDarkOffsets()) or an occasional startAutoZero() make up for.
+    /// @param interval Measurements between auto zeros: 1 before every
+    /// measurement, n every n-th, ksfAS7343AutoZeroFirstOnly (the default)
+    /// only before the first one, ksfAS7343AutoZeroNever never.
+    /// @return True if successful, false if it fails.
+    bool setAutoZeroInterval(uint8_t interval);
+
+    /// @brief Get how often the spectral engines auto zero.
+    /// @details This method gets AZ_CONFIG from the shadow register file.
+    /// @return The interval, see setAutoZeroInterval(). Returns
+    /// ksfAS7343AutoZeroFirstOnly on error.
+    uint8_t getAutoZeroInterval(void);
+
+    /// @brief Start a manual auto zero of the spectral engines.
+    /// @details This method sets the SP_MAN_AZ bit in the CONTROL register
+    /// (ksfAS7343RegControl). It only works while spectral measurements are
+    /// stopped, so stop them first (disableSpectralMeasurement()) and wait
+    /// ksfAS7343AutoZeroTimeUs before starting them again.
+    /// @return True if successful, false if it fails or spectral measurements
+    /// are running.
+    bool startAutoZero(void);
+
+    /// @brief Attach a dark offset table.
+    /// @details readFrame() subtracts the table's offsets for the frame's gain
+    /// from the data, once the frame is read and auto-ranging is done, and
+    /// sets frame.darkCorrected. Only frames measured with the integration
+    /// time the table was captured at are corrected. The table lives in
+    /// memory, so this costs no I2C traffic. Other reads (getData(),
+    /// readSpectraDataFromSensor(), the FIFO) keep the raw counts.
+    /// @param offsets Pointer to the table, nullptr to detach it. It must stay
+    /// valid while attached.
+    void setDarkOffsets(const sfDevAS7343DarkOffsets *offsets);
+
+    /// @brief Get the attached dark offset table.
+    /// @return The table set with setDarkOffsets(), nullptr if none.
+    const sfDevAS7343DarkOffsets *getDarkOffsets(void);
+
+    /// @brief Get a snapshot of the bus statistics.
+    /// @details Counts the I2C transactions, bytes, bank switches and failures
+    /// of each operation (see sfe_as7343_stats_op_t), and times the calls with
+    /// the timestamp source. Only counted when the library is built with
+    /// SFE_AS7343_STATS defined (see sfDevAS7343.h).
+    /// @param stats Reference to the snapshot to fill, all zero without
+    /// SFE_AS7343_STATS.
+    /// @return True if successful, false if the instrumentation is not built in.
+    bool getStats(sfe_as7343_stats_t &stats);
+
+    /// @brief Reset the bus statistics.
+    void resetStats(void);
+
+  protected:
+    // Double buffered channel data: reads fill the back buffer, then _front switches to it.
+    sfe_as7343_reg_data_t _data[2][ksfAS7343NumChannels];
+    volatile uint8_t _front; // Index of the buffer holding the last complete read.
 
+  private:
     sfTkIBus *_theBus; // Pointer to bus device.
+
+    /// @brief Read a register from the bus, counted by the instrumentation.
+    /// @param reg The register to read.
+    /// @param data Reference to the variable to store the register value.
+    /// @return The bus result.
+    sfTkError_t busReadRegister(uint8_t reg, uint8_t &data);
+
+    /// @brief Read consecutive registers from the bus, counted by the instrumentation.
+    /// @param reg The first register to read.
+    /// @param data Pointer to the buffer for the register values.
+    /// @param length Number of bytes to read.
+    /// @param nRead Set to the number of bytes read.
+    /// @return The bus result.
+    sfTkError_t busReadRegister(uint8_t reg, uint8_t *data, size_t length, size_t &nRead);
+
+    /// @brief Write a register on the bus, counted by the instrumentation.
+    /// @param reg The register to write.
+    /// @param data The register value.
+    /// @return The bus result.
+    sfTkError_t busWriteRegister(uint8_t reg, uint8_t data);
+
+    /// @brief Write consecutive registers on the bus, counted by the instrumentation.
+    /// @param reg The first register to write.
+    /// @param data Pointer to the register values.
+    /// @param length Number of bytes to write.
+    /// @return The bus result.
+    sfTkError_t busWriteRegister(uint8_t reg, const uint8_t *data, size_t length);
+
+    // Counts one API call: the bus traffic in its lifetime goes to its operation, and it times the call.
+    class StatsScope
+    {
+      public:
+        StatsScope(sfDevAS7343 *device, sfe_as7343_stats_op_t op);
+        ~StatsScope();
+
+      private:
+        sfDevAS7343 *_device; // The instrumented device.
+        uint8_t _outerOp;     // Operation of the enclosing call, restored at the end.
+        uint32_t _start;      // Timestamp source time at the start of the call.
+    };
+
+    /// @brief Count a bus transaction for the current operation.
+    /// @param write True for a write, false for a read.
+    /// @param bytes Number of register bytes moved.
+    /// @param result The bus result.
+    void countBusTransaction(bool write, size_t bytes, sfTkError_t result);
+
+    sfe_as7343_stats_t _stats; // Bus statistics.
+    uint8_t _statsOp;          // Operation the bus traffic is counted for, sfe_as7343_stats_op_t.
+
+    /// @brief Get a configuration register from the shadow register file.
+    /// @param reg The shadow entry to get.
+    /// @param data Reference to the variable to store the register value.
+    /// @return True if successful, false if it fails.
+    bool readShadowRegister(sfe_as7343_shadow_reg_t reg, uint8_t &data);
+
+    /// @brief Write a configuration register to the device and the shadow register file.
+    /// @param reg The shadow entry to write.
+    /// @param data The register value to write.
+    /// @return True if successful, false if it fails.
+    bool writeShadowRegister(sfe_as7343_shadow_reg_t reg, uint8_t data);
+
+    /// @brief Write consecutive configuration registers in one burst.
+    /// @param first The first shadow entry to write.
+    /// @param data Pointer to the register values to write.
+    /// @param count Number of registers to write, all at consecutive addresses.
+    /// @return True if successful, false if it fails.
+    bool writeShadowRegisters(sfe_as7343_shadow_reg_t first, const uint8_t *data, uint8_t count);
+
+    /// @brief Bring the device (and the shadow) to the given register values.
+    /// @param target Desired value of every shadow entry.
+    /// @return True if successful, false if it fails.
+    bool writeShadowDiff(const uint8_t target[SHADOW_NUM_REGS]);
+
+    sfe_as7343_reg_cfg0_t _cfg0; // Shadow copy of CFG0 (reg_bank, low_power, wlong).
+    bool _cfg0Valid;             // True when _cfg0 matches the device.
+
+    uint8_t _shadow[SHADOW_NUM_REGS]; // Shadow register file, indexed by sfe_as7343_shadow_reg_t.
+    bool _shadowValid;                // True when _shadow matches the device.
+    bool _shadowVerify;               // True to read back and compare every configuration write.
+
+    /// @brief Get the channels the next data read covers.
+    /// @param first Set to the first channel to read.
+    /// @param count Set to the number of consecutive channels to read.
+    /// @return True if successful, false if it fails or no selected channel is filled.
+    bool getReadWindow(uint8_t &first, uint8_t &count);
+
+    /// @brief Store raw data register bytes (DATAx_L first) in the data array.
+    /// @details raw may point into the data array itself, at channel first.
+    /// @param raw Pointer to the raw bytes.
+    /// @param first Channel of the first raw word.
+    /// @param count Number of channels in the raw bytes.
+    void unpackSpectraData(const uint8_t *raw, uint8_t first, uint8_t count);
+
+    /// @brief Completion callback handed to the asynchronous bus.
+    /// @param context The device.
+    static void asyncReadComplete(void *context);
+
+    /// @brief Pick up the result of the read in flight from the asynchronous bus.
+    void finishRead(void);
+
+    /// @brief Move a finished read to where it belongs, and set the read state.
+    /// @param success True if the bus read succeeded.
+    /// @param nRead Number of bytes read.
+    void endRead(bool success, size_t nRead);
+
+    sfDevAS7343AsyncBus *_asyncBus;              // Optional background bus for startRead().
+    bool _asyncNotifies;                         // True if _asyncBus reports finished reads.
+    volatile sfe_as7343_read_state_t _readState; // State of the startRead() read.
+    // startRead() destination.
+    uint8_t _readBuffer[ksfAS7343NumChannels * sizeof(sfe_as7343_reg_data_t)];
+    uint8_t _readFirst;                          // First channel of the startRead() read.
+    uint8_t _readCount;                          // Channels in the startRead() read.
+    uint16_t *_fifoReadData;                     // startFifoRead() destination, nullptr for a startRead() read.
+    size_t _fifoReadEntries;                     // Entries startFifoRead() submitted.
+    size_t _fifoReadCount;                       // Entries the last startFifoRead() read.
+    void (*_readCallback)(sfDevAS7343 *device, sfe_as7343_read_state_t state); // See setReadCallback().
+
+    uint32_t _channelMask; // Channels selected by setChannelMask().
+
+    uint16_t _cycleOverheadUs; // Time between SMUX cycles, see setCycleOverheadUs().
+
+    bool _autoGain;                  // True when readFrame() runs updateAutoGain().
+    sfe_as7343_again_t _autoGainMin; // Lowest auto-ranging gain.
+    sfe_as7343_again_t _autoGainMax; // Highest auto-ranging gain.
+    uint8_t _autoGainLow;            // Lower end of the auto-ranging window, percent of full scale.
+    uint8_t _autoGainHigh;           // Upper end of the auto-ranging window, percent of full scale.
+
+    /// @brief Make the cached basic counts scale match a gain and the integration time.
+    /// @param gain The gain the data was measured with.
+    /// @return True if successful, false if it fails.
+    bool updateScale(sfe_as7343_again_t gain);
+
+    uint32_t _scaleKey;  // ATIME, ASTEP and gain the cached scale belongs to.
+    float _scale;        // Basic counts per count.
+    uint32_t _scaleMant; // Basic counts per count in 16.16 fixed point, as mantissa...
+    uint8_t _scaleShift; // ... and right shift: (counts x mant) >> shift.
+
+    bool _armed; // True after armSpectralMeasurement(), until the trigger.
+
+    volatile uint32_t _dataSequence[2]; // Frame sequence number of each data buffer.
+    uint32_t _dataTimestamp[2];         // Timestamp of each data buffer.
+    uint32_t (*_timestampSource)(void); // Clock for the timestamps, see setTimestampSource().
+
+    const sfDevAS7343DarkOffsets *_darkOffsets; // Dark offsets readFrame() applies, see setDarkOffsets().
+
+    /// @brief Bring the device to a configuration, see applyConfig().
+    /// @param config The configuration to apply.
+    /// @param powerOn True to also set PON, with the last ENABLE write.
+    /// @return True if successful, false if it fails (or the config is invalid).
+    bool writeConfig(const sfe_as7343_config_t &config, bool powerOn);
+
+    /// @brief Load the CFG0 shadow from the device, unless it is already valid.
+    /// @return True if successful, false if it fails.
+    bool loadCfg0(void);
+
+    /// @brief Write CFG0 to the device and the CFG0 shadow, if it changed.
+    /// @param cfg0 The new CFG0 value.
+    /// @return True if successful, false if it fails.
+    bool writeCfg0(sfe_as7343_reg_cfg0_t cfg0);
+
+    /// @brief Write FD_TIME_1 and FD_TIME_2, pausing flicker detection if it runs.
+    /// @param fdTime1 The new FD_TIME_1 value.
+    /// @param fdTime2 The new FD_TIME_2 value.
+    /// @return True if successful, false if it fails.
+    bool writeFlickerTiming(uint8_t fdTime1, uint8_t fdTime2);
 };
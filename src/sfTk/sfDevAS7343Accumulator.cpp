@@ -0,0 +1,158 @@
+/**
+ * @file sfDevAS7343Accumulator.cpp
+ * @brief Implementation file for the SparkFun AS7343 statistics accumulator.
+ *
+ * @details
+ * Implements the integer Welford update, the decimation and the moving
+ * average of sfDevAS7343Accumulator.
+ *
+ * @author SparkFun Electronics
+ * @date 2026
+ * @copyright Copyright (c) 2026, SparkFun Electronics Inc. All rights reserved.
+ *
+ * @section License License
+ * SPDX-License-Identifier: MIT
+ *
+ * @see https://github.com/sparkfun/SparkFun_AS7343_Arduino_Library
+ */
+#include "sfDevAS7343Accumulator.h"
+
+// The means are kept in 1/256 counts, so the rounding of the running update stays below a count.
+const uint8_t ksfAccumulatorFracBits = 8;
+
+bool sfDevAS7343Accumulator::begin(uint16_t window, uint8_t decimation, sfe_as7343_average_mode_t mode)
+{
+    if (window == 0 || window > ksfAS7343AccumulatorMaxWindow || decimation == 0 || mode > AVERAGE_EMA)
+        return false;
+
+    _window = window;
+    _decimation = decimation;
+    _mode = mode;
+    _summaryValid = false;
+
+    reset();
+
+    return true;
+}
+
+void sfDevAS7343Accumulator::reset(void)
+{
+    _decimationCount = 0;
+    _count = 0;
+    _saturated = false;
+    _emaValid = false;
+}
+
+bool sfDevAS7343Accumulator::addFrame(const sfe_as7343_frame_t &frame)
+{
+    if (!frame.valid)
+        return false;
+
+    return addData(frame.data, frame.gain, frame.timestamp, frame.saturatedAnalog || frame.saturatedDigital);
+}
+
+bool sfDevAS7343Accumulator::addData(const uint16_t data[ksfAS7343NumChannels], sfe_as7343_again_t gain,
+                                     uint32_t timestamp, bool saturated)
+{
+    if (!data)
+        return false;
+
+    // Counts of another gain don't mix with the window so far, or with the moving average carried over
+    // from the last window, start over with this one.
+    if ((_count > 0 || _emaValid) && gain != _gain)
+    {
+        _count = 0;
+        _saturated = false;
+        _emaValid = false;
+    }
+
+    // Decimation: only every _decimation-th frame is used.
+    bool use = _decimationCount == 0;
+
+    if (++_decimationCount >= _decimation)
+        _decimationCount = 0;
+
+    if (!use)
+        return false;
+
+    _count++;
+    _gain = gain;
+    _timestamp = timestamp;
+    _saturated = _saturated || saturated;
+
+    for (uint8_t ch = 0; ch < ksfAS7343NumChannels; ch++)
+    {
+        uint16_t count = data[ch];
+        int32_t x = (int32_t)count << ksfAccumulatorFracBits;
+
+        if (_count == 1)
+        {
+            _mean[ch] = x;
+            _m2[ch] = 0;
+            _min[ch] = _max[ch] = count;
+        }
+        else
+        {
+            // Welford: mean += (x - mean) / n, M2 += (x - old mean) x (x - new mean).
+            int32_t delta = x - _mean[ch];
+            _mean[ch] += delta / _count;
+            _m2[ch] += (int64_t)delta * (x - _mean[ch]);
+
+            if (count < _min[ch])
+                _min[ch] = count;
+            if (count > _max[ch])
+                _max[ch] = count;
+        }
+
+        // The moving average starts at the first value, then follows with alpha = 1 / window.
+        if (_mode == AVERAGE_EMA)
+            _ema[ch] = _emaValid ? _ema[ch] + (x - _ema[ch]) / (int32_t)_window : x;
+    }
+
+    _emaValid = true;
+
+    if (_count < _window)
+        return false;
+
+    finishWindow();
+
+    return true;
+}
+
+bool sfDevAS7343Accumulator::getSummary(sfe_as7343_summary_t &summary)
+{
+    if (!_summaryValid)
+        return false;
+
+    summary = _summary;
+
+    return true;
+}
+
+void sfDevAS7343Accumulator::finishWindow(void)
+{
+    const int32_t half = 1 << (ksfAccumulatorFracBits - 1);
+
+    _summary.timestamp = _timestamp;
+    _summary.frames = _count;
+    _summary.gain = _gain;
+    _summary.saturated = _saturated;
+
+    for (uint8_t ch = 0; ch < ksfAS7343NumChannels; ch++)
+    {
+        int32_t mean = _mode == AVERAGE_EMA ? _ema[ch] : _mean[ch];
+        int64_t m2 = _m2[ch] > 0 ? _m2[ch] : 0;
+
+        // Back to counts, rounded. The variance is M2 / n, in counts^2.
+        _summary.mean[ch] = (uint16_t)((mean + half) >> ksfAccumulatorFracBits);
+        _summary.min[ch] = _min[ch];
+        _summary.max[ch] = _max[ch];
+        _summary.variance[ch] = (uint32_t)((m2 / _count) >> (2 * ksfAccumulatorFracBits));
+    }
+
+    _summaryValid = true;
+
+    // The next window starts empty, the moving average carries on.
+    _count = 0;
+    _saturated = false;
+}
@@ -0,0 +1,140 @@
+/**
+ * @file sfDevAS7343Accumulator.h
+ * @brief Frame decimation and statistics stage for the SparkFun AS7343 Sensor.
+ *
+ * @details
+ * sfDevAS7343Accumulator folds a stream of frames into one summary per
+ * window of N frames: the per channel mean, minimum, maximum and variance.
+ * Sending the summary instead of every frame cuts the data to send by the
+ * window size.
+ *
+ * The statistics use Welford's running update in integer arithmetic (the
+ * mean in 1/256 counts), so no frames are stored. Frames can be decimated
+ * (only every n-th frame is used) before they are accumulated, and the mean
+ * is either the box car average of the window or an exponential moving
+ * average over N frames that carries on from window to window.
+ *
+ * @author SparkFun Electronics
+ * @date 2026
+ * @copyright Copyright (c) 2026, SparkFun Electronics Inc. This project is released under the MIT License.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * @section Repository Repository
+ * https://github.com/sparkfun/SparkFun_AS7343_Arduino_Library
+ */
+
+#pragma once
+
+#include "sfDevAS7343.h"
+
+// Longest window, in frames. Keeps the integer sums within 64 bits.
+const uint16_t ksfAS7343AccumulatorMaxWindow = 4096;
+
+// How the summary mean is averaged.
+typedef enum
+{
+    AVERAGE_BOXCAR = 0x00, // Mean of the frames in the window
+    AVERAGE_EMA,           // Exponential moving average, alpha = 1 / window, across windows
+} sfe_as7343_average_mode_t;
+
+// Summary of one window of frames.
+typedef struct
+{
+    uint32_t timestamp;                      // Timestamp of the last frame in the window
+    uint16_t frames;                         // Frames accumulated in the window
+    sfe_as7343_again_t gain;                 // Gain of all frames in the window
+    bool saturated;                          // At least one frame was saturated
+    uint16_t mean[ksfAS7343NumChannels];     // Mean (box car) or moving average (EMA) of each channel
+    uint16_t min[ksfAS7343NumChannels];      // Smallest count of each channel
+    uint16_t max[ksfAS7343NumChannels];      // Largest count of each channel
+    uint32_t variance[ksfAS7343NumChannels]; // Variance of each channel, in counts^2
+} sfe_as7343_summary_t;
+
+/**
+ * @class sfDevAS7343Accumulator
+ * @brief Streaming per channel statistics over windows of frames.
+ *
+ * @details
+ * Usage:
+ * @code
+ * sfDevAS7343Accumulator accumulator;
+ * accumulator.begin(100);
+ *
+ * // loop():
+ * if (sensor.readFrame(frame) && accumulator.addFrame(frame))
+ *     accumulator.getSummary(summary); // One summary per 100 frames
+ * @endcode
+ *
+ * Counts measured with different gains don't average, so a gain change
+ * (e.g. by auto-ranging) restarts the window, the frames of the old gain are
+ * dropped.
+ */
+class sfDevAS7343Accumulator
+{
+  public:
+    sfDevAS7343Accumulator()
+        : _window{1}, _decimation{1}, _mode{AVERAGE_BOXCAR}, _decimationCount{0}, _count{0}, _gain{AGAIN_0_5},
+          _saturated{false}, _timestamp{0}, _mean{}, _m2{}, _min{}, _max{}, _ema{}, _emaValid{false}, _summary{},
+          _summaryValid{false}
+    {
+    }
+
+    /// @brief Set up the accumulator, and start a new window.
+    /// @param window Frames per summary, 1 to ksfAS7343AccumulatorMaxWindow.
+    /// In EMA mode also the averaging length.
+    /// @param decimation Use every n-th frame, 1 uses them all. The default is 1.
+    /// @param mode AVERAGE_BOXCAR (the default) or AVERAGE_EMA.
+    /// @return True if successful, false if the settings are invalid.
+    bool begin(uint16_t window, uint8_t decimation = 1, sfe_as7343_average_mode_t mode = AVERAGE_BOXCAR);
+
+    /// @brief Drop the current window, and restart the moving average.
+    void reset(void);
+
+    /// @brief Add a frame.
+    /// @details Frames that are not valid are skipped, the others go through
+    /// decimation first.
+    /// @param frame Frame from sfDevAS7343::readFrame().
+    /// @return True if the frame completed a window, getSummary() has the
+    /// new summary.
+    bool addFrame(const sfe_as7343_frame_t &frame);
+
+    /// @brief Add channel data.
+    /// @details Like addFrame(), for data from getData(), with all channels
+    /// measured at one gain.
+    /// @param data Channel data, indexed by sfe_as7343_channel_t.
+    /// @param gain Gain the data was measured with.
+    /// @param timestamp Time of the measurement.
+    /// @param saturated True if the measurement was saturated.
+    /// @return True if the data completed a window.
+    bool addData(const uint16_t data[ksfAS7343NumChannels], sfe_as7343_again_t gain, uint32_t timestamp,
+                 bool saturated = false);
+
+    /// @brief Get the summary of the last completed window.
+    /// @param summary Reference to the summary to fill.
+    /// @return True if a window has been completed, false if not.
+    bool getSummary(sfe_as7343_summary_t &summary);
+
+  private:
+    /// @brief Turn the running statistics into the summary, and start a new window.
+    void finishWindow(void);
+
+    uint16_t _window;                  // Frames per window.
+    uint8_t _decimation;               // Use every n-th frame.
+    sfe_as7343_average_mode_t _mode;   // Box car or EMA mean.
+    uint8_t _decimationCount;          // Frames skipped since the last one used.
+    uint16_t _count;                   // Frames in the current window.
+    sfe_as7343_again_t _gain;          // Gain of the current window, kept for the moving average after it.
+    bool _saturated;                   // A frame in the current window was saturated.
+    uint32_t _timestamp;               // Timestamp of the last frame in the window.
+
+    int32_t _mean[ksfAS7343NumChannels]; // Running mean, 1/256 counts.
+    int64_t _m2[ksfAS7343NumChannels];   // Sum of squared differences from the mean, 1/65536 counts^2.
+    uint16_t _min[ksfAS7343NumChannels]; // Smallest count in the window.
+    uint16_t _max[ksfAS7343NumChannels]; // Largest count in the window.
+    int32_t _ema[ksfAS7343NumChannels];  // Moving average, 1/256 counts.
+    bool _emaValid;                      // True once the moving average has a start value.
+
+    sfe_as7343_summary_t _summary; // Summary of the last completed window.
+    bool _summaryValid;            // True once a window was completed.
+};
@@ -0,0 +1,315 @@
+/**
+ * @file sfDevAS7343Acquisition.h
+ * @brief Interrupt driven acquisition engine for the SparkFun AS7343 Sensor.
+ *
+ * @details
+ * The engine sits on top of sfDevAS7343. It arms the sensor to raise its INT
+ * pin once per measurement (or once per FIFO threshold), takes a lightweight
+ * notification from the pin's ISR, and does all bus work later in service():
+ * read the status and data, clear the interrupt. Finished frames are queued
+ * in a lock-free ring buffer, so the application just pops frames and never
+ * busy-polls the status registers.
+ *
+ * Usage:
+ * @code
+ * SfeAS7343ArdI2C mySensor;
+ * sfDevAS7343Acquisition<8> myEngine;
+ *
+ * void onSensorInterrupt() { myEngine.onInterrupt(micros()); }
+ *
+ * // setup(): myEngine.begin(&mySensor); myEngine.arm();
+ * //          attachInterrupt(digitalPinToInterrupt(pin), onSensorInterrupt, FALLING);
+ * // loop():  myEngine.service(); while (myEngine.pop(frame)) { ... }
+ * @endcode
+ *
+ * @author SparkFun Electronics
+ * @date 2026
+ * @copyright Copyright (c) 2026, SparkFun Electronics Inc. This project is released under the MIT License.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * @section Repository Repository
+ * https://github.com/sparkfun/SparkFun_AS7343_Arduino_Library
+ */
+
+#pragma once
+
+#include "sfDevAS7343.h"
+#include "sfDevAS7343RingBuffer.h"
+
+// Acquisition engine interrupt source
+typedef enum
+{
+    ACQUISITION_MODE_FRAME = 0x00, // Interrupt after every spectral measurement (AINT, APERS = 0)
+    ACQUISITION_MODE_FIFO,         // Interrupt when FIFO_LVL reaches the FIFO threshold (FINT)
+} sfe_as7343_acquisition_mode_t;
+
+/**
+ * @class sfDevAS7343Acquisition
+ * @brief Interrupt driven acquisition engine with a queue of N frames.
+ *
+ * @details
+ * onInterrupt() is the only method meant for interrupt context. service() and
+ * pop() may run on different threads or cores, service() is the producer and
+ * pop() the consumer of the frame queue.
+ *
+ * In ACQUISITION_MODE_FRAME every queued frame holds one
+ * sfDevAS7343::readFrame(): status, gain, saturation and data in one burst.
+ * In ACQUISITION_MODE_FIFO the FIFO is drained and split into frames of
+ * as many entries as there are channels set in the FIFO map (see
+ * sfDevAS7343::setFifoMap()), each entry going to data[0], data[1], ...
+ * The FIFO holds no per entry status, so these frames carry the STATUS and
+ * STATUS2 read when the interrupt was serviced (saturation is sticky across
+ * the drained measurements), and the configured gain.
+ *
+ * @tparam N Frame queue depth, a power of two from 2 to 128.
+ */
+template <uint8_t N = 4> class sfDevAS7343Acquisition
+{
+  public:
+    sfDevAS7343Acquisition()
+        : _sensor{nullptr}, _mode{ACQUISITION_MODE_FRAME}, _fifoFrameSize{0}, _irqCount{0}, _irqTimestamp{0},
+          _serviced{0}, _clearPending{false}, _clearStatus{0}, _dropped{0}
+    {
+    }
+
+    /// @brief Attach the engine to a sensor.
+    /// @param sensor Pointer to an initialized sensor object.
+    /// @return True if successful, false if it fails.
+    bool begin(sfDevAS7343 *sensor)
+    {
+        if (!sensor)
+            return false;
+
+        _sensor = sensor;
+
+        return true;
+    }
+
+    /// @brief Arm the sensor interrupt.
+    /// @details In ACQUISITION_MODE_FRAME the spectral interrupt persistence is
+    /// set to 0, so every measurement raises INT, and the spectral interrupt is
+    /// enabled. In ACQUISITION_MODE_FIFO the FIFO interrupt is enabled, set up
+    /// the FIFO map and threshold on the sensor first.
+    /// @param mode The interrupt source to arm.
+    /// @param fifoFrameSize In FIFO mode, the number of FIFO entries per frame
+    /// (1 to ksfAS7343NumChannels). Ignored in frame mode.
+    /// @return True if successful, false if it fails.
+    bool arm(sfe_as7343_acquisition_mode_t mode = ACQUISITION_MODE_FRAME, uint8_t fifoFrameSize = 0)
+    {
+        if (!_sensor)
+            return false;
+
+        _mode = mode;
+
+        // Pick up any edge that arrives from here on.
+        _serviced = _irqCount;
+        _clearPending = false;
+
+        if (mode == ACQUISITION_MODE_FIFO)
+        {
+            if (fifoFrameSize == 0 || fifoFrameSize > ksfAS7343NumChannels)
+                return false;
+
+            _fifoFrameSize = fifoFrameSize;
+
+            return _sensor->clearFifo() && _sensor->enableFifoInterrupt();
+        }
+
+        return _sensor->setSpectralIntPersistence(0) && _sensor->enableSpectralInterrupt();
+    }
+
+    /// @brief Disarm the sensor interrupt.
+    /// @return True if successful, false if it fails.
+    bool disarm(void)
+    {
+        if (!_sensor)
+            return false;
+
+        if (_mode == ACQUISITION_MODE_FIFO)
+            return _sensor->disableFifoInterrupt();
+
+        return _sensor->disableSpectralInterrupt();
+    }
+
+    /// @brief Notify the engine that the INT pin fired.
+    /// @details Call this from the INT pin ISR. It only records the time and
+    /// bumps a counter, no bus access is done here.
+    /// @param timestamp Time of the interrupt, usually micros().
+    void onInterrupt(uint32_t timestamp)
+    {
+        _irqTimestamp = timestamp;
+
+        // Publish the timestamp before the count, service() reads them in the opposite order.
+        SFE_AS7343_MEMORY_BARRIER();
+
+        _irqCount = _irqCount + 1;
+    }
+
+    /// @brief Service a pending interrupt.
+    /// @details Call this regularly from the application loop (or a task). If
+    /// an interrupt is pending it reads the status and the data (data
+    /// registers or FIFO), clears the interrupt and queues the frame(s). It returns
+    /// immediately when nothing is pending. If the status or data read fails,
+    /// the interrupt stays pending and the next call tries again. If the
+    /// clear fails, INT stays asserted and no new edge comes, so the next
+    /// call retries the clear before anything else.
+    /// @return True if at least one frame was queued and the interrupt
+    /// cleared, false otherwise.
+    bool service(void)
+    {
+        if (!_sensor)
+            return false;
+
+        // A failed clear first, until it goes through no measurement can raise INT again.
+        if (_clearPending)
+        {
+            if (_sensor->clearStatusReg(_clearStatus) == false)
+                return false;
+
+            _clearPending = false;
+        }
+
+        if (_irqCount == _serviced)
+            return false;
+
+        // Take a consistent snapshot of the count and timestamp written by the ISR.
+        uint8_t count;
+        uint32_t timestamp;
+
+        do
+        {
+            count = _irqCount;
+            SFE_AS7343_MEMORY_BARRIER();
+            timestamp = _irqTimestamp;
+            SFE_AS7343_MEMORY_BARRIER();
+        } while (count != _irqCount);
+
+        sfe_as7343_frame_t frame;
+        frame.timestamp = timestamp;
+
+        bool queued = false;
+
+        // If a read fails, the interrupt stays pending (INT stays asserted, no new edge comes), so the
+        // count is left alone and the next service() tries again.
+        if (_mode == ACQUISITION_MODE_FIFO)
+        {
+            if (_sensor->readStatusReg(frame.status) == false ||
+                _sensor->readRegisterBank(ksfAS7343RegStatus2, frame.status2) == false)
+                return false;
+
+            // Edges since the last service are collapsed, the device only holds the latest data anyway.
+            _serviced = count;
+
+            queued = serviceFifo(frame);
+        }
+        else
+        {
+            // Status and data in one burst.
+            if (_sensor->readFrame(frame) == false)
+                return false;
+
+            // The interrupt time is closer to the end of the measurement than the read.
+            frame.timestamp = timestamp;
+
+            // Edges since the last service are collapsed, the device only holds the latest data anyway.
+            _serviced = count;
+
+            queued = queueFrame(frame);
+        }
+
+        // Write the status back to clear the interrupt flags that were set (write 1 to clear). The
+        // frames are queued already, only the clear is retried.
+        if (_sensor->clearStatusReg(frame.status) == false)
+        {
+            _clearStatus = frame.status;
+            _clearPending = true;
+            return false;
+        }
+
+        return queued;
+    }
+
+    /// @brief Get the oldest queued frame.
+    /// @param frame Reference to store the frame in.
+    /// @return True if a frame was returned, false if the queue is empty.
+    bool pop(sfe_as7343_frame_t &frame)
+    {
+        return _frames.pop(frame);
+    }
+
+    /// @brief Get the number of queued frames.
+    /// @return The number of frames waiting to be popped.
+    uint8_t available(void) const
+    {
+        return _frames.available();
+    }
+
+    /// @brief Get the number of frames dropped because the queue was full.
+    /// @return The number of dropped frames since begin().
+    uint32_t getDroppedFrames(void) const
+    {
+        return _dropped;
+    }
+
+  private:
+    /// @brief Queue a frame, counting it as dropped if the queue is full.
+    bool queueFrame(const sfe_as7343_frame_t &frame)
+    {
+        if (_frames.push(frame))
+            return true;
+
+        _dropped++;
+        return false;
+    }
+
+    /// @brief Drain the FIFO and queue it as frames of _fifoFrameSize entries.
+    bool serviceFifo(sfe_as7343_frame_t &frame)
+    {
+        // Only whole frames are taken, a partly written frame stays in the FIFO for next time.
+        size_t numEntries = _sensor->getFifoLevel();
+        numEntries -= numEntries % _fifoFrameSize;
+
+        bool queued = false;
+
+        // Only the data comes from the FIFO. Validity and saturation come from the status read by service(),
+        // the gain from the shadow of CFG1 (entries queued before a gain change carry the new one).
+        sfe_as7343_reg_status_t status;
+        sfe_as7343_reg_status2_t status2;
+
+        status.byte = frame.status;
+        status2.byte = frame.status2;
+
+        frame.status3 = frame.astatus = 0;
+        frame.gain = _sensor->getAgain();
+        frame.valid = status.fint || status2.avalid;
+        frame.saturatedAnalog = status2.asat_ana;
+        frame.saturatedDigital = status2.asat_dig;
+        frame.darkCorrected = false;
+
+        // One burst per frame, straight into the frame buffer.
+        for (; numEntries > 0; numEntries -= _fifoFrameSize)
+        {
+            if (_sensor->readFifoEntries(frame.data, _fifoFrameSize) == false)
+                break;
+
+            for (uint8_t ch = _fifoFrameSize; ch < ksfAS7343NumChannels; ch++)
+                frame.data[ch] = 0;
+
+            queued = queueFrame(frame) || queued;
+        }
+
+        return queued;
+    }
+
+    sfDevAS7343 *_sensor;                          // Sensor the engine is attached to.
+    sfe_as7343_acquisition_mode_t _mode;           // Armed interrupt source.
+    uint8_t _fifoFrameSize;                        // FIFO entries per frame, in FIFO mode.
+    volatile uint8_t _irqCount;                    // Interrupt count, only changed by onInterrupt().
+    volatile uint32_t _irqTimestamp;               // Time of the latest interrupt.
+    uint8_t _serviced;                             // Interrupt count handled by service().
+    bool _clearPending;                            // True if the status clear failed, service() retries it.
+    uint8_t _clearStatus;                          // Status flags the pending clear writes back.
+    uint32_t _dropped;                             // Frames dropped because the queue was full.
+    sfDevAS7343RingBuffer<sfe_as7343_frame_t, N> _frames; // Queue of finished frames.
+};
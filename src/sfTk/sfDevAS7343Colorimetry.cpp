@@ -0,0 +1,168 @@
+/**
+ * @file sfDevAS7343Colorimetry.cpp
+ * @brief Implementation file for the SparkFun AS7343 colorimetry stage.
+ *
+ * @details
+ * Implements the Q15 matrix kernel and the XYZ to xy / CCT / lux conversions
+ * of sfDevAS7343Colorimetry.
+ *
+ * @author SparkFun Electronics
+ * @date 2026
+ * @copyright Copyright (c) 2026, SparkFun Electronics Inc. All rights reserved.
+ *
+ * @section License License
+ * SPDX-License-Identifier: MIT
+ *
+ * @see https://github.com/sparkfun/SparkFun_AS7343_Arduino_Library
+ */
+#include "sfDevAS7343Colorimetry.h"
+
+#include <string.h>
+
+#if defined(__ARM_FEATURE_SIMD32) && __ARM_FEATURE_SIMD32
+#include <arm_acle.h>
+#define SFE_AS7343_COLOR_DSP 1
+#endif
+
+// Channels feeding the matrix, in column order: the 18 channel layout without the VIS and FD slots.
+static const uint8_t ksfColorChannels[ksfAS7343ColorInputs] = {
+    CH_BLUE_FZ_450NM,      CH_GREEN_FY_555NM,      CH_ORANGE_FXL_600NM, CH_NIR_855NM,
+    CH_DARK_BLUE_F2_425NM, CH_LIGHT_BLUE_F3_475NM, CH_BLUE_F4_515NM,    CH_BROWN_F6_640NM,
+    CH_PURPLE_F1_405NM,    CH_RED_F7_690NM,        CH_DARK_RED_F8_745NM, CH_GREEN_F5_550NM};
+
+// Largest usable coefficient scale, 2^15 takes a Q15 coefficient to an integer.
+const uint8_t ksfColorMaxShift = 15;
+
+// McCamy's CCT approximation, n = (x - xe) / (ye - y).
+const float ksfMcCamyXe = 0.3320f;
+const float ksfMcCamyYe = 0.1858f;
+
+/// @brief Q15 matrix kernel: out[r] = sum(matrix[r][c] x in[c]).
+/// @param matrix The 3x12 coefficients, 4 byte aligned.
+/// @param in The 12 inputs, 4 byte aligned.
+/// @param out The 3 results, in Q15.
+static void sfColorMatrixQ15(const int16_t matrix[ksfAS7343ColorOutputs][ksfAS7343ColorInputs],
+                             const int16_t in[ksfAS7343ColorInputs], int64_t out[ksfAS7343ColorOutputs])
+{
+    for (uint8_t r = 0; r < ksfAS7343ColorOutputs; r++)
+    {
+        int64_t acc = 0;
+
+#ifdef SFE_AS7343_COLOR_DSP
+        // Two 16 x 16 bit products per SMLALD, accumulated in 64 bits.
+        for (uint8_t c = 0; c < ksfAS7343ColorInputs; c += 2)
+        {
+            int16x2_t m, x;
+            memcpy(&m, &matrix[r][c], sizeof(m));
+            memcpy(&x, &in[c], sizeof(x));
+
+            acc = __smlald(m, x, acc);
+        }
+#else
+        for (uint8_t c = 0; c < ksfAS7343ColorInputs; c++)
+            acc += (int32_t)matrix[r][c] * in[c];
+#endif
+
+        out[r] = acc;
+    }
+}
+
+bool sfDevAS7343Colorimetry::begin(sfDevAS7343 *sensor)
+{
+    if (!sensor)
+        return false;
+
+    _sensor = sensor;
+
+    return true;
+}
+
+bool sfDevAS7343Colorimetry::setMatrix(const int16_t matrix[ksfAS7343ColorOutputs][ksfAS7343ColorInputs],
+                                       uint8_t shift)
+{
+    if (!matrix || shift > ksfColorMaxShift)
+        return false;
+
+    memcpy(_matrix, matrix, sizeof(_matrix));
+    _shift = shift;
+    _matrixValid = true;
+
+    return true;
+}
+
+bool sfDevAS7343Colorimetry::setMatrix(const uint8_t *data, size_t size)
+{
+    if (!data || size != ksfAS7343ColorMatrixBytes || data[size - 1] > ksfColorMaxShift)
+        return false;
+
+    // Little-endian coefficients, assembled without depending on host byte order.
+    for (uint8_t r = 0; r < ksfAS7343ColorOutputs; r++)
+    {
+        for (uint8_t c = 0; c < ksfAS7343ColorInputs; c++)
+        {
+            const uint8_t *coef = data + 2 * (r * ksfAS7343ColorInputs + c);
+            _matrix[r][c] = (int16_t)((uint16_t)coef[0] | ((uint16_t)coef[1] << 8));
+        }
+    }
+
+    _shift = data[size - 1];
+    _matrixValid = true;
+
+    return true;
+}
+
+bool sfDevAS7343Colorimetry::compute(const sfe_as7343_frame_t &frame, sfe_as7343_color_t &color)
+{
+    float scale;
+
+    // The scale for the gain the frame was measured with.
+    if (!_sensor || _sensor->getBasicCountsScale(frame.gain, scale) == false)
+        return false;
+
+    return compute(frame.data, scale, color);
+}
+
+bool sfDevAS7343Colorimetry::compute(const uint16_t data[ksfAS7343NumChannels], float basicCountsScale,
+                                     sfe_as7343_color_t &color)
+{
+    if (!data || !_matrixValid)
+        return false;
+
+    // Counts are halved to fit signed 16 bits, the scale below makes up for it.
+    alignas(4) int16_t in[ksfAS7343ColorInputs];
+    for (uint8_t c = 0; c < ksfAS7343ColorInputs; c++)
+        in[c] = (int16_t)(data[ksfColorChannels[c]] >> 1);
+
+    int64_t xyz[ksfAS7343ColorOutputs];
+    sfColorMatrixQ15(_matrix, in, xyz);
+
+    // One multiply per output: Q15 to real, x2 for the halved counts, x2^shift, then basic counts.
+    float outScale = basicCountsScale * (float)(1UL << (_shift + 1)) / 32768.0f;
+
+    color.X = xyz[0] * outScale;
+    color.Y = xyz[1] * outScale;
+    color.Z = xyz[2] * outScale;
+
+    float sum = color.X + color.Y + color.Z;
+
+    // Chromaticity and CCT are only defined for some light.
+    if (sum <= 0.0f)
+    {
+        color.x = color.y = color.cct = 0.0f;
+    }
+    else
+    {
+        color.x = color.X / sum;
+        color.y = color.Y / sum;
+
+        float n = (color.x - ksfMcCamyXe) / (ksfMcCamyYe - color.y);
+        color.cct = ((449.0f * n + 3525.0f) * n + 6823.3f) * n + 5520.33f;
+
+        if (color.cct < 0.0f)
+            color.cct = 0.0f;
+    }
+
+    color.lux = color.Y > 0.0f ? color.Y : 0.0f;
+
+    return true;
+}
@@ -0,0 +1,119 @@
+/**
+ * @file sfDevAS7343Colorimetry.h
+ * @brief Colorimetry stage (CIE XYZ, xy, CCT, lux) for the SparkFun AS7343 Sensor.
+ *
+ * @details
+ * sfDevAS7343Colorimetry maps the 12 spectral channels of an 18 channel
+ * frame (sfe_as7343_channel_t layout, VIS and FD slots skipped) to CIE XYZ
+ * with a 3x12 calibration matrix, then derives the chromaticity (x, y), the
+ * correlated color temperature and the illuminance.
+ *
+ * The matrix is applied in Q15 fixed point. On ARM cores with the DSP
+ * (SIMD32) extension, e.g. Cortex-M4/M7/M33, the kernel uses dual 16-bit multiply
+ * accumulate instructions, elsewhere plain C that the compiler maps to the
+ * core's multiply accumulate.
+ *
+ * The matrix depends on the sensor, its optical stack and the light sources
+ * of interest, so the library ships none. Load the one from your
+ * calibration with setMatrix().
+ *
+ * @author SparkFun Electronics
+ * @date 2026
+ * @copyright Copyright (c) 2026, SparkFun Electronics Inc. This project is released under the MIT License.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * @section Repository Repository
+ * https://github.com/sparkfun/SparkFun_AS7343_Arduino_Library
+ */
+
+#pragma once
+
+#include "sfDevAS7343.h"
+
+// Colorimetry matrix dimensions.
+const uint8_t ksfAS7343ColorInputs = 12; // Spectral channels used, VIS and FD excluded
+const uint8_t ksfAS7343ColorOutputs = 3; // X, Y and Z
+
+// Size of a serialized matrix (see sfDevAS7343Colorimetry::setMatrix()): 36 little-endian Q15
+// coefficients, row by row, followed by the shift byte.
+const uint8_t ksfAS7343ColorMatrixBytes = ksfAS7343ColorInputs * ksfAS7343ColorOutputs * 2 + 1;
+
+// Colorimetry result.
+typedef struct
+{
+    float X;   // CIE 1931 tristimulus X
+    float Y;   // CIE 1931 tristimulus Y
+    float Z;   // CIE 1931 tristimulus Z
+    float x;   // Chromaticity x, X / (X + Y + Z)
+    float y;   // Chromaticity y, Y / (X + Y + Z)
+    float cct; // Correlated color temperature in Kelvin (McCamy), 0 if not defined
+    float lux; // Illuminance, Y of a matrix calibrated in lux
+} sfe_as7343_color_t;
+
+/**
+ * @class sfDevAS7343Colorimetry
+ * @brief Calibration matrix driven colorimetry for AS7343 frames.
+ *
+ * @details
+ * XYZ = M x counts x basicCountsScale x 2^shift, with M in Q15. The raw
+ * counts go through the matrix, and the gain / integration time scaling is
+ * applied once to the three results instead of to every channel.
+ */
+class sfDevAS7343Colorimetry
+{
+  public:
+    sfDevAS7343Colorimetry() : _sensor{nullptr}, _matrix{}, _shift{0}, _matrixValid{false}
+    {
+    }
+
+    /// @brief Attach the stage to a sensor.
+    /// @details The sensor provides the basic counts scale for each frame
+    /// (gain and integration time). It must produce 18 channels
+    /// (AUTOSMUX_18_CHANNELS).
+    /// @param sensor Pointer to an initialized sensor object.
+    /// @return True if successful, false if it fails.
+    bool begin(sfDevAS7343 *sensor);
+
+    /// @brief Load the calibration matrix.
+    /// @details Rows are X, Y, Z. Columns follow the channel order with the
+    /// VIS and FD slots removed: FZ, FY, FXL, NIR, F2, F3, F4, F6, F1, F7, F8,
+    /// F5. Each coefficient is Q15 (-1.0 to 0.99997), scaled by 2^shift so
+    /// larger coefficients fit.
+    /// @param matrix The 3x12 coefficients in Q15.
+    /// @param shift Power of two all coefficients are scaled by, 0-15.
+    /// @return True if successful, false if the shift is invalid.
+    bool setMatrix(const int16_t matrix[ksfAS7343ColorOutputs][ksfAS7343ColorInputs], uint8_t shift);
+
+    /// @brief Load a serialized calibration matrix.
+    /// @details Use this to load a matrix stored in EEPROM or flash:
+    /// ksfAS7343ColorMatrixBytes bytes, the coefficients of setMatrix() as
+    /// little-endian int16_t row by row, then the shift.
+    /// @param data Pointer to the serialized matrix.
+    /// @param size Number of bytes, must be ksfAS7343ColorMatrixBytes.
+    /// @return True if successful, false if the data is invalid.
+    bool setMatrix(const uint8_t *data, size_t size);
+
+    /// @brief Compute the colorimetry of a frame.
+    /// @param frame 18 channel frame from sfDevAS7343::readFrame().
+    /// @param color Reference to the result.
+    /// @return True if successful, false if it fails (no matrix or sensor).
+    bool compute(const sfe_as7343_frame_t &frame, sfe_as7343_color_t &color);
+
+    /// @brief Compute the colorimetry of raw channel data.
+    /// @param data 18 channel data, indexed by sfe_as7343_channel_t.
+    /// @param basicCountsScale Basic counts per count of the data, see
+    /// sfDevAS7343::getBasicCountsScale().
+    /// @param color Reference to the result.
+    /// @return True if successful, false if no matrix is loaded.
+    bool compute(const uint16_t data[ksfAS7343NumChannels], float basicCountsScale, sfe_as7343_color_t &color);
+
+  private:
+    sfDevAS7343 *_sensor; // Sensor providing the basic counts scale.
+
+    // Q15 coefficients, aligned so the DSP kernel can load coefficient pairs as words.
+    alignas(4) int16_t _matrix[ksfAS7343ColorOutputs][ksfAS7343ColorInputs];
+
+    uint8_t _shift;    // Power of two the coefficients are scaled by.
+    bool _matrixValid; // True once a matrix is loaded.
+};
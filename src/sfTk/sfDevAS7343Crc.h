@@ -0,0 +1,45 @@
+/**
+ * @file sfDevAS7343Crc.h
+ * @brief CRC-8 used by the SparkFun AS7343 blob and record formats.
+ *
+ * @details
+ * CRC-8 with polynomial x^8 + x^5 + x^4 + 1 (0x31) and init 0xFF, the
+ * check of the dark offset blob (sfDevAS7343DarkOffsets) and of the binary
+ * frame records (sfDevAS7343Record.h).
+ *
+ * @author SparkFun Electronics
+ * @date 2026
+ * @copyright Copyright (c) 2026, SparkFun Electronics Inc. This project is released under the MIT License.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * @section Repository Repository
+ * https://github.com/sparkfun/SparkFun_AS7343_Arduino_Library
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+const uint8_t ksfAS7343CrcPoly = 0x31;
+const uint8_t ksfAS7343CrcInit = 0xFF;
+
+/// @brief CRC-8 over a block of bytes.
+/// @param data Pointer to the bytes.
+/// @param size Number of bytes.
+/// @return The CRC.
+inline uint8_t sfDevAS7343Crc8(const uint8_t *data, size_t size)
+{
+    uint8_t crc = ksfAS7343CrcInit;
+
+    for (size_t i = 0; i < size; i++)
+    {
+        crc ^= data[i];
+
+        for (uint8_t bit = 0; bit < 8; bit++)
+            crc = (crc & 0x80) ? (uint8_t)((crc << 1) ^ ksfAS7343CrcPoly) : (uint8_t)(crc << 1);
+    }
+
+    return crc;
+}
@@ -0,0 +1,239 @@
+/**
+ * @file sfDevAS7343DarkOffsets.cpp
+ * @brief Implementation file for the SparkFun AS7343 dark offset table.
+ *
+ * @details
+ * Implements the dark frame capture, the offset subtraction and the blob
+ * format of sfDevAS7343DarkOffsets.
+ *
+ * @author SparkFun Electronics
+ * @date 2026
+ * @copyright Copyright (c) 2026, SparkFun Electronics Inc. All rights reserved.
+ *
+ * @section License License
+ * SPDX-License-Identifier: MIT
+ *
+ * @see https://github.com/sparkfun/SparkFun_AS7343_Arduino_Library
+ */
+#include "sfDevAS7343DarkOffsets.h"
+#include "sfDevAS7343Crc.h"
+
+#include <string.h>
+
+// Blob magic, 'A' 'D'.
+const uint8_t ksfDarkMagic0 = 'A';
+const uint8_t ksfDarkMagic1 = 'D';
+
+/// @brief Count the gains in a gain mask.
+/// @param mask The gain mask.
+/// @return The number of bits set.
+static uint8_t sfDarkNumGains(uint16_t mask)
+{
+    uint8_t count = 0;
+
+    for (; mask; mask &= mask - 1)
+        count++;
+
+    return count;
+}
+
+void sfDevAS7343DarkOffsets::clear(void)
+{
+    _gainMask = 0;
+    _captureFrames = 0;
+}
+
+void sfDevAS7343DarkOffsets::setIntegrationTime(uint8_t atime, uint16_t astep)
+{
+    if (atime == _atime && astep == _astep)
+        return;
+
+    clear();
+    _atime = atime;
+    _astep = astep;
+}
+
+bool sfDevAS7343DarkOffsets::setOffsets(sfe_as7343_again_t gain, const uint16_t offsets[ksfAS7343NumChannels])
+{
+    if (!offsets || gain >= ksfAS7343NumGains)
+        return false;
+
+    memcpy(_offsets[gain], offsets, sizeof(_offsets[gain]));
+    _gainMask |= (uint16_t)(1U << gain);
+
+    return true;
+}
+
+bool sfDevAS7343DarkOffsets::getOffsets(sfe_as7343_again_t gain, uint16_t offsets[ksfAS7343NumChannels]) const
+{
+    if (!offsets || !hasOffsets(gain))
+        return false;
+
+    memcpy(offsets, _offsets[gain], sizeof(_offsets[gain]));
+
+    return true;
+}
+
+bool sfDevAS7343DarkOffsets::hasOffsets(sfe_as7343_again_t gain) const
+{
+    return gain < ksfAS7343NumGains && (_gainMask & (1U << gain));
+}
+
+bool sfDevAS7343DarkOffsets::beginCapture(sfDevAS7343 *sensor, sfe_as7343_again_t gain, uint8_t numFrames)
+{
+    if (!sensor || gain >= ksfAS7343NumGains || numFrames == 0)
+        return false;
+
+    uint8_t atime;
+    uint16_t astep;
+
+    // The integration time comes from the shadow, the gain change is the only write.
+    if (sensor->getIntegrationTime(atime, astep) == false || sensor->setAgain(gain) == false)
+        return false;
+
+    // A capture still running hands its sensor the table back first.
+    if (_captureFrames != 0)
+        _captureSensor->setDarkOffsets(_captureRestore);
+
+    // The frames must keep their raw counts, corrected ones would average to offsets of about 0.
+    _captureSensor = sensor;
+    _captureRestore = sensor->getDarkOffsets();
+    sensor->setDarkOffsets(nullptr);
+
+    setIntegrationTime(atime, astep);
+
+    memset(_captureSum, 0, sizeof(_captureSum));
+    _captureGain = gain;
+    _captureCount = 0;
+    _captureFrames = numFrames;
+
+    return true;
+}
+
+bool sfDevAS7343DarkOffsets::captureFrame(const sfe_as7343_frame_t &frame)
+{
+    // Frames from before the gain change, incomplete ones, or ones with offsets subtracted don't count.
+    if (_captureFrames == 0 || !frame.valid || frame.gain != _captureGain || frame.darkCorrected)
+        return false;
+
+    for (uint8_t ch = 0; ch < ksfAS7343NumChannels; ch++)
+        _captureSum[ch] += frame.data[ch];
+
+    if (++_captureCount < _captureFrames)
+        return false;
+
+    // The rounded average becomes the offsets.
+    uint16_t offsets[ksfAS7343NumChannels];
+    for (uint8_t ch = 0; ch < ksfAS7343NumChannels; ch++)
+        offsets[ch] = (uint16_t)((_captureSum[ch] + _captureFrames / 2) / _captureFrames);
+
+    _captureFrames = 0;
+
+    bool stored = setOffsets(_captureGain, offsets);
+
+    // The table is attached again with the new offsets.
+    _captureSensor->setDarkOffsets(_captureRestore);
+
+    return stored;
+}
+
+bool sfDevAS7343DarkOffsets::isCapturing(void) const
+{
+    return _captureFrames != 0;
+}
+
+bool sfDevAS7343DarkOffsets::apply(sfe_as7343_frame_t &frame, uint8_t atime, uint16_t astep) const
+{
+    if (atime != _atime || astep != _astep || !hasOffsets(frame.gain))
+        return false;
+
+    const uint16_t *offsets = _offsets[frame.gain];
+
+    for (uint8_t ch = 0; ch < ksfAS7343NumChannels; ch++)
+        frame.data[ch] = frame.data[ch] > offsets[ch] ? frame.data[ch] - offsets[ch] : 0;
+
+    frame.darkCorrected = true;
+
+    return true;
+}
+
+size_t sfDevAS7343DarkOffsets::getBlobSize(void) const
+{
+    return ksfAS7343DarkHeaderBytes + sfDarkNumGains(_gainMask) * ksfAS7343NumChannels * 2 + 1;
+}
+
+size_t sfDevAS7343DarkOffsets::save(uint8_t *blob, size_t size) const
+{
+    size_t blobSize = getBlobSize();
+
+    if (!blob || size < blobSize)
+        return 0;
+
+    blob[0] = ksfDarkMagic0;
+    blob[1] = ksfDarkMagic1;
+    blob[2] = ksfAS7343DarkVersion;
+    blob[3] = ksfAS7343NumChannels;
+    blob[4] = _atime;
+    blob[5] = (uint8_t)(_astep & 0xFF);
+    blob[6] = (uint8_t)(_astep >> 8);
+    blob[7] = (uint8_t)(_gainMask & 0xFF);
+    blob[8] = (uint8_t)(_gainMask >> 8);
+
+    // Offsets of the gains in the mask, little-endian without depending on host byte order.
+    uint8_t *out = blob + ksfAS7343DarkHeaderBytes;
+
+    for (uint8_t gain = 0; gain < ksfAS7343NumGains; gain++)
+    {
+        if (!(_gainMask & (1U << gain)))
+            continue;
+
+        for (uint8_t ch = 0; ch < ksfAS7343NumChannels; ch++)
+        {
+            *out++ = (uint8_t)(_offsets[gain][ch] & 0xFF);
+            *out++ = (uint8_t)(_offsets[gain][ch] >> 8);
+        }
+    }
+
+    *out = sfDevAS7343Crc8(blob, blobSize - 1);
+
+    return blobSize;
+}
+
+bool sfDevAS7343DarkOffsets::load(const uint8_t *blob, size_t size)
+{
+    if (!blob || size < ksfAS7343DarkHeaderBytes + 1)
+        return false;
+
+    // Check the header before trusting the mask it holds.
+    if (blob[0] != ksfDarkMagic0 || blob[1] != ksfDarkMagic1 || blob[2] != ksfAS7343DarkVersion ||
+        blob[3] != ksfAS7343NumChannels)
+        return false;
+
+    uint16_t mask = (uint16_t)blob[7] | ((uint16_t)blob[8] << 8);
+
+    if (mask >> ksfAS7343NumGains)
+        return false;
+
+    size_t blobSize = ksfAS7343DarkHeaderBytes + sfDarkNumGains(mask) * ksfAS7343NumChannels * 2 + 1;
+
+    if (size < blobSize || sfDevAS7343Crc8(blob, blobSize - 1) != blob[blobSize - 1])
+        return false;
+
+    clear();
+    _atime = blob[4];
+    _astep = (uint16_t)blob[5] | ((uint16_t)blob[6] << 8);
+    _gainMask = mask;
+
+    const uint8_t *in = blob + ksfAS7343DarkHeaderBytes;
+
+    for (uint8_t gain = 0; gain < ksfAS7343NumGains; gain++)
+    {
+        if (!(mask & (1U << gain)))
+            continue;
+
+        for (uint8_t ch = 0; ch < ksfAS7343NumChannels; ch++, in += 2)
+            _offsets[gain][ch] = (uint16_t)in[0] | ((uint16_t)in[1] << 8);
+    }
+
+    return true;
+}
@@ -0,0 +1,168 @@
+/**
+ * @file sfDevAS7343DarkOffsets.h
+ * @brief Per gain dark offset table for the SparkFun AS7343 Sensor.
+ *
+ * @details
+ * sfDevAS7343DarkOffsets holds the dark counts of every channel for each
+ * gain, captured with the sensor covered. Attached to a sensor with
+ * sfDevAS7343::setDarkOffsets(), readFrame() subtracts the entry of the gain
+ * the frame was measured with, from memory, without any extra I2C traffic.
+ *
+ * With the offsets taken care of, the auto zero of the spectral engines does
+ * not have to run before every measurement, see
+ * sfDevAS7343::setAutoZeroInterval().
+ *
+ * The table is captured for one integration time (ATIME, ASTEP), and only
+ * applies while the sensor uses it. It can be saved to and loaded from a
+ * compact blob, e.g. in EEPROM or flash:
+ *
+ * - 2 bytes magic, 'A' 'D'
+ * - 1 byte version, ksfAS7343DarkVersion
+ * - 1 byte number of channels, ksfAS7343NumChannels
+ * - 1 byte ATIME, 2 bytes ASTEP
+ * - 2 bytes mask of the gains in the table, bit n = sfe_as7343_again_t n
+ * - for each gain in the mask, lowest first, one offset per channel
+ * - 1 byte CRC-8 (polynomial 0x31, init 0xFF) of all bytes before it
+ *
+ * All multi-byte values are little-endian.
+ *
+ * @author SparkFun Electronics
+ * @date 2026
+ * @copyright Copyright (c) 2026, SparkFun Electronics Inc. This project is released under the MIT License.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * @section Repository Repository
+ * https://github.com/sparkfun/SparkFun_AS7343_Arduino_Library
+ */
+
+#pragma once
+
+#include "sfDevAS7343.h"
+
+// Number of gain settings, AGAIN_0_5 to AGAIN_2048.
+const uint8_t ksfAS7343NumGains = AGAIN_2048 + 1;
+
+// Dark offset blob format version.
+const uint8_t ksfAS7343DarkVersion = 1;
+
+// Blob sizes: the header, then the offsets of each gain, then the CRC.
+const uint8_t ksfAS7343DarkHeaderBytes = 9;
+const uint16_t ksfAS7343DarkMaxBytes = ksfAS7343DarkHeaderBytes + ksfAS7343NumGains * ksfAS7343NumChannels * 2 + 1;
+
+/**
+ * @class sfDevAS7343DarkOffsets
+ * @brief Dark frame table, one channel offset set per gain.
+ *
+ * @details
+ * Capturing, with the sensor covered and measuring:
+ * @code
+ * offsets.beginCapture(&sensor, AGAIN_64, 8);
+ * while (offsets.isCapturing())
+ *     if (sensor.readFrame(frame) && frame.valid)
+ *         offsets.captureFrame(frame);
+ * @endcode
+ */
+class sfDevAS7343DarkOffsets
+{
+  public:
+    sfDevAS7343DarkOffsets()
+        : _offsets{}, _gainMask{0}, _atime{0}, _astep{0}, _captureSum{}, _captureGain{AGAIN_0_5}, _captureCount{0},
+          _captureFrames{0}, _captureSensor{nullptr}, _captureRestore{nullptr}
+    {
+    }
+
+    /// @brief Remove all offsets.
+    void clear(void);
+
+    /// @brief Set the integration time the offsets belong to.
+    /// @details Changing it clears the table, the offsets of one integration
+    /// time don't apply to another. beginCapture() sets it from the sensor.
+    /// @param atime ATIME of the captures.
+    /// @param astep ASTEP of the captures.
+    void setIntegrationTime(uint8_t atime, uint16_t astep);
+
+    /// @brief Set the offsets of a gain.
+    /// @param gain The gain the offsets belong to.
+    /// @param offsets Dark counts, indexed by sfe_as7343_channel_t.
+    /// @return True if successful, false if the gain is invalid.
+    bool setOffsets(sfe_as7343_again_t gain, const uint16_t offsets[ksfAS7343NumChannels]);
+
+    /// @brief Get the offsets of a gain.
+    /// @param gain The gain to get the offsets of.
+    /// @param offsets Buffer for the dark counts, indexed by sfe_as7343_channel_t.
+    /// @return True if successful, false if the table has no offsets for the gain.
+    bool getOffsets(sfe_as7343_again_t gain, uint16_t offsets[ksfAS7343NumChannels]) const;
+
+    /// @brief Check if the table has offsets for a gain.
+    /// @param gain The gain to check.
+    /// @return True if the gain has offsets, false if not.
+    bool hasOffsets(sfe_as7343_again_t gain) const;
+
+    /// @brief Start capturing the offsets of a gain.
+    /// @details Sets the sensor gain and takes the integration time from the
+    /// sensor (no I2C traffic for that). Feed the next frames to
+    /// captureFrame(), their average becomes the offsets. Cover the sensor
+    /// and turn the LED off first. The dark offset table attached to the
+    /// sensor (e.g. this one, for a re-capture) is detached until the capture
+    /// completes, so readFrame() returns raw counts.
+    /// @param sensor Pointer to the sensor to capture from.
+    /// @param gain The gain to capture.
+    /// @param numFrames Number of frames to average, at least 1.
+    /// @return True if successful, false if it fails.
+    bool beginCapture(sfDevAS7343 *sensor, sfe_as7343_again_t gain, uint8_t numFrames);
+
+    /// @brief Add a dark frame to the capture.
+    /// @details Frames that are not valid, measured with a different gain
+    /// (e.g. the one before the gain change), or already dark corrected are
+    /// skipped.
+    /// @param frame Frame from sfDevAS7343::readFrame().
+    /// @return True when the capture is complete and the offsets are stored,
+    /// false if more frames are needed.
+    bool captureFrame(const sfe_as7343_frame_t &frame);
+
+    /// @brief Check if a capture is running.
+    /// @return True while captureFrame() needs more frames, false if not.
+    bool isCapturing(void) const;
+
+    /// @brief Subtract the offsets from a frame.
+    /// @details Counts below the offset become 0. frame.darkCorrected is set
+    /// if the offsets were applied.
+    /// @param frame The frame to correct.
+    /// @param atime ATIME the frame was measured with.
+    /// @param astep ASTEP the frame was measured with.
+    /// @return True if the offsets were applied, false if the table has none
+    /// for the frame's gain and integration time.
+    bool apply(sfe_as7343_frame_t &frame, uint8_t atime, uint16_t astep) const;
+
+    /// @brief Get the size of the blob save() writes.
+    /// @return The number of bytes, up to ksfAS7343DarkMaxBytes.
+    size_t getBlobSize(void) const;
+
+    /// @brief Save the table to a blob.
+    /// @param blob Buffer for the blob.
+    /// @param size Size of the buffer, at least getBlobSize().
+    /// @return The number of bytes written, 0 if the buffer is too small.
+    size_t save(uint8_t *blob, size_t size) const;
+
+    /// @brief Load the table from a blob.
+    /// @details The table is only changed if the blob is valid: magic,
+    /// version, channel count, size and CRC all check out.
+    /// @param blob Pointer to the blob, from save().
+    /// @param size Number of bytes available, at least the blob size.
+    /// @return True if successful, false if the blob is invalid.
+    bool load(const uint8_t *blob, size_t size);
+
+  private:
+    uint16_t _offsets[ksfAS7343NumGains][ksfAS7343NumChannels]; // Dark counts, per gain and channel.
+    uint16_t _gainMask;                                          // Gains with offsets, bit n = gain n.
+    uint8_t _atime;                                              // ATIME the offsets belong to.
+    uint16_t _astep;                                             // ASTEP the offsets belong to.
+
+    uint32_t _captureSum[ksfAS7343NumChannels];     // Sum of the captured frames.
+    sfe_as7343_again_t _captureGain;                // Gain being captured.
+    uint8_t _captureCount;                          // Frames captured so far.
+    uint8_t _captureFrames;                         // Frames to capture, 0 when not capturing.
+    sfDevAS7343 *_captureSensor;                    // Sensor being captured from.
+    const sfDevAS7343DarkOffsets *_captureRestore;  // Table to attach to it again when the capture ends.
+};
@@ -0,0 +1,193 @@
+/**
+ * @file sfDevAS7343Events.cpp
+ * @brief Implementation file for the SparkFun AS7343 threshold event detection.
+ *
+ * @details
+ * Implements the hardware gate and the per channel hysteresis check of
+ * sfDevAS7343EventDetector.
+ *
+ * @author SparkFun Electronics
+ * @date 2026
+ * @copyright Copyright (c) 2026, SparkFun Electronics Inc. All rights reserved.
+ *
+ * @section License License
+ * SPDX-License-Identifier: MIT
+ *
+ * @see https://github.com/sparkfun/SparkFun_AS7343_Arduino_Library
+ */
+#include "sfDevAS7343Events.h"
+
+bool sfDevAS7343EventDetector::begin(sfDevAS7343 *sensor, uint8_t gatePercent, uint8_t persistence)
+{
+    if (!sensor || gatePercent == 0 || gatePercent > 100)
+        return false;
+
+    _sensor = sensor;
+    _gatePercent = gatePercent;
+    _enabledMask = 0;
+
+    reset();
+
+    // Low above high, so the first measurement is outside and fires the gate.
+    if (_sensor->setSpectralThresholdChannel(_gateChannel) == false ||
+        _sensor->setSpectralIntPersistence(persistence) == false ||
+        _sensor->setSpectralIntThresholds(0xFFFF, 0) == false || _sensor->enableSpectralInterrupt() == false)
+        return false;
+
+    return true;
+}
+
+bool sfDevAS7343EventDetector::setGateChannel(sfe_as7343_spectral_threshold_channel_t spThCh)
+{
+    if (spThCh > SPECTRAL_THRESHOLD_CHANNEL_5)
+        return false;
+
+    _gateChannel = spThCh;
+
+    // The window belongs to the old channel, fire on the next measurement and start over.
+    if (_sensor && (_sensor->setSpectralThresholdChannel(spThCh) == false ||
+                    _sensor->setSpectralIntThresholds(0xFFFF, 0) == false))
+        return false;
+
+    return true;
+}
+
+bool sfDevAS7343EventDetector::setThreshold(sfe_as7343_channel_t channel, uint16_t low, uint16_t high,
+                                            uint16_t hysteresis)
+{
+    if (channel >= ksfAS7343NumChannels || low > high)
+        return false;
+
+    _low[channel] = low;
+    _high[channel] = high;
+    _hysteresis[channel] = hysteresis;
+    _state[channel] = EVENT_STATE_INSIDE;
+    _enabledMask |= 1UL << channel;
+
+    // The next frame sets the state of the channel.
+    _started = false;
+
+    return true;
+}
+
+void sfDevAS7343EventDetector::clearThreshold(sfe_as7343_channel_t channel)
+{
+    if (channel >= ksfAS7343NumChannels)
+        return;
+
+    _enabledMask &= ~(1UL << channel);
+    _state[channel] = EVENT_STATE_INSIDE;
+}
+
+void sfDevAS7343EventDetector::reset(void)
+{
+    for (uint8_t ch = 0; ch < ksfAS7343NumChannels; ch++)
+        _state[ch] = EVENT_STATE_INSIDE;
+
+    _changedMask = 0;
+    _started = false;
+}
+
+bool sfDevAS7343EventDetector::poll(sfe_as7343_frame_t &frame)
+{
+    if (!_sensor)
+        return false;
+
+    sfe_as7343_reg_status_t status;
+
+    // Read the STATUS register, if it errors then return false.
+    if (_sensor->readStatusReg(status.byte) == false)
+        return false;
+
+    // The gate didn't fire, the light is as it was.
+    if (!status.aint)
+        return false;
+
+    return service(frame);
+}
+
+bool sfDevAS7343EventDetector::service(sfe_as7343_frame_t &frame)
+{
+    if (!_sensor)
+        return false;
+
+    // Read the frame, then clear what it found (AINT included) for the next measurement.
+    if (_sensor->readFrame(frame) == false || _sensor->clearStatusReg(frame.status) == false)
+        return false;
+
+    if (!frame.valid)
+        return false;
+
+    bool event = checkFrame(frame);
+
+    // Move the gate window to the new reading, changed or not.
+    if (armGate(frame) == false)
+        return false;
+
+    return event;
+}
+
+bool sfDevAS7343EventDetector::checkFrame(const sfe_as7343_frame_t &frame)
+{
+    _changedMask = 0;
+
+    for (uint8_t ch = 0; ch < ksfAS7343NumChannels; ch++)
+    {
+        if (!(_enabledMask & (1UL << ch)))
+            continue;
+
+        // 32 bits, so high + hysteresis doesn't wrap.
+        uint32_t value = frame.data[ch];
+        uint8_t state;
+
+        if (value > _high[ch])
+            state = EVENT_STATE_ABOVE;
+        else if (value < _low[ch])
+            state = EVENT_STATE_BELOW;
+        else if (_state[ch] == EVENT_STATE_ABOVE && value + _hysteresis[ch] > _high[ch])
+            state = EVENT_STATE_ABOVE;
+        else if (_state[ch] == EVENT_STATE_BELOW && value < (uint32_t)_low[ch] + _hysteresis[ch])
+            state = EVENT_STATE_BELOW;
+        else
+            state = EVENT_STATE_INSIDE;
+
+        if (state != _state[ch])
+            _changedMask |= 1UL << ch;
+
+        _state[ch] = state;
+    }
+
+    // The first frame reports the starting states, even if they are all inside.
+    bool first = !_started;
+    _started = true;
+
+    return first || _changedMask != 0;
+}
+
+uint32_t sfDevAS7343EventDetector::getChangedMask(void)
+{
+    return _changedMask;
+}
+
+sfe_as7343_event_state_t sfDevAS7343EventDetector::getState(sfe_as7343_channel_t channel)
+{
+    if (channel >= ksfAS7343NumChannels)
+        return EVENT_STATE_INSIDE;
+
+    return (sfe_as7343_event_state_t)_state[channel];
+}
+
+bool sfDevAS7343EventDetector::armGate(const sfe_as7343_frame_t &frame)
+{
+    // The gate channel is the ADC, its reading is in the first SMUX cycle part of the frame.
+    uint32_t reference = frame.data[_gateChannel];
+    uint32_t margin = reference * _gatePercent / 100;
+
+    if (margin < ksfAS7343EventGateMinCounts)
+        margin = ksfAS7343EventGateMinCounts;
+
+    uint16_t low = reference > margin ? (uint16_t)(reference - margin) : 0;
+    uint16_t high = reference + margin < 0xFFFF ? (uint16_t)(reference + margin) : 0xFFFF;
+
+    return _sensor->setSpectralIntThresholds(low, high);
+}
@@ -0,0 +1,166 @@
+/**
+ * @file sfDevAS7343Events.h
+ * @brief Threshold event detection for the SparkFun AS7343 Sensor.
+ *
+ * @details
+ * The hardware threshold of the AS7343 watches a single ADC channel
+ * (setSpectralThresholdChannel()) against one low / high pair.
+ * sfDevAS7343EventDetector builds "tell me when any of these channels
+ * crosses its bounds" on top of it, in two stages:
+ *
+ * - Gate: the hardware threshold watches the VIS channel (ADC 4, the
+ *   broadband photodiode, VIS in every SMUX cycle) with a window of a few
+ *   percent around its last reading. As long as the light doesn't change,
+ *   the spectral interrupt stays quiet and nothing is read from the sensor.
+ * - Check: when the gate fires, the fresh frame is compared against the
+ *   software thresholds of each channel, with hysteresis. Only frames that
+ *   move a channel across its bounds are passed on. The gate window then
+ *   moves to the new reading.
+ *
+ * Thresholds are in counts, so they hold for one gain and integration time.
+ * Use a fixed gain with the detector.
+ *
+ * @author SparkFun Electronics
+ * @date 2026
+ * @copyright Copyright (c) 2026, SparkFun Electronics Inc. This project is released under the MIT License.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * @section Repository Repository
+ * https://github.com/sparkfun/SparkFun_AS7343_Arduino_Library
+ */
+
+#pragma once
+
+#include "sfDevAS7343.h"
+
+// Smallest gate window half width, in counts. Keeps noise on dark readings from waking the MCU.
+const uint16_t ksfAS7343EventGateMinCounts = 16;
+
+// Where a channel reading is relative to its thresholds.
+typedef enum
+{
+    EVENT_STATE_INSIDE = 0x00, // Between the low and high threshold
+    EVENT_STATE_BELOW,         // Below the low threshold
+    EVENT_STATE_ABOVE,         // Above the high threshold
+} sfe_as7343_event_state_t;
+
+/**
+ * @class sfDevAS7343EventDetector
+ * @brief Wakes on a hardware threshold, reports per channel threshold crossings.
+ *
+ * @details
+ * Usage:
+ * @code
+ * sfDevAS7343EventDetector detector;
+ * detector.begin(&sensor);
+ * detector.setThreshold(CH_RED_F7_690NM, 500, 4000, 50);
+ *
+ * // loop(), e.g. when the INT pin is low:
+ * if (detector.poll(frame))
+ *     ...; // A channel changed state, see getChangedMask() and getState()
+ * @endcode
+ *
+ * The first frame after begin() or reset() is always reported, it sets the
+ * starting state of every channel.
+ */
+class sfDevAS7343EventDetector
+{
+  public:
+    sfDevAS7343EventDetector()
+        : _sensor{nullptr}, _gateChannel{SPECTRAL_THRESHOLD_CHANNEL_4}, _gatePercent{0}, _enabledMask{0},
+          _changedMask{0}, _low{}, _high{}, _hysteresis{}, _state{}, _started{false}
+    {
+    }
+
+    /// @brief Set up the detector, and the spectral interrupt of the sensor.
+    /// @details Sets the threshold channel, the persistence, and enables the
+    /// spectral interrupt with a window no reading fits in, so the first
+    /// measurement fires the gate. The sensor is expected to be set up and measuring
+    /// (see enableSpectralMeasurement()). All software thresholds are cleared.
+    /// @param sensor The sensor.
+    /// @param gatePercent Half width of the gate window, in percent of the
+    /// last gate channel reading, 1 to 100. The default is 5. Changes that
+    /// move a channel but not the gate channel by this much are missed, a
+    /// smaller window catches more of them and wakes more often.
+    /// @param persistence Out of window measurements in a row before the gate
+    /// fires, see setSpectralIntPersistence(). The default is 1.
+    /// @return True if successful, false if it fails.
+    bool begin(sfDevAS7343 *sensor, uint8_t gatePercent = 5, uint8_t persistence = 1);
+
+    /// @brief Set the channel the hardware gate watches.
+    /// @details The default, SPECTRAL_THRESHOLD_CHANNEL_4, is VIS in every
+    /// SMUX cycle. Other channels are a different filter in each cycle of the
+    /// 12 and 18 channel modes, only use them in the 6 channel mode.
+    /// @param spThCh The ADC channel.
+    /// @return True if successful, false if it fails.
+    bool setGateChannel(sfe_as7343_spectral_threshold_channel_t spThCh);
+
+    /// @brief Set the thresholds of a channel.
+    /// @details A channel is above once it reads more than high, and stays
+    /// above until it reads high - hysteresis or less. Below works the same way
+    /// with low + hysteresis.
+    /// @param channel The channel, sfe_as7343_channel_t.
+    /// @param low Low threshold, 0 for none.
+    /// @param high High threshold, 65535 for none.
+    /// @param hysteresis Hysteresis, in counts.
+    /// @return True if successful, false if the channel or thresholds are invalid.
+    bool setThreshold(sfe_as7343_channel_t channel, uint16_t low, uint16_t high, uint16_t hysteresis = 0);
+
+    /// @brief Stop checking a channel.
+    /// @param channel The channel, sfe_as7343_channel_t.
+    void clearThreshold(sfe_as7343_channel_t channel);
+
+    /// @brief Forget the channel states, the next frame is reported again.
+    void reset(void);
+
+    /// @brief Check the gate, and read and check a frame if it fired.
+    /// @details Reads the STATUS register. Nothing else is read while the
+    /// spectral interrupt (AINT) isn't set, so this is cheap to call from
+    /// loop(). When the INT pin is wired, call service() when it asserts instead.
+    /// @param frame Reference to the frame to fill.
+    /// @return True if the frame moved a channel across its thresholds, false
+    /// if there is no event (or it fails).
+    bool poll(sfe_as7343_frame_t &frame);
+
+    /// @brief Read and check a frame, then move the gate window.
+    /// @details Call this when the gate fired (INT asserted). Clears the
+    /// status flags of the frame.
+    /// @param frame Reference to the frame to fill.
+    /// @return True if the frame moved a channel across its thresholds, false
+    /// if there is no event (or it fails).
+    bool service(sfe_as7343_frame_t &frame);
+
+    /// @brief Check a frame against the software thresholds.
+    /// @details The check stage alone, for frames read elsewhere. Doesn't
+    /// touch the gate.
+    /// @param frame The frame.
+    /// @return True if a channel changed state (or it is the first frame).
+    bool checkFrame(const sfe_as7343_frame_t &frame);
+
+    /// @brief Get the channels the last checked frame moved.
+    /// @return Bit n set if channel n changed state.
+    uint32_t getChangedMask(void);
+
+    /// @brief Get the state of a channel.
+    /// @param channel The channel, sfe_as7343_channel_t.
+    /// @return EVENT_STATE_INSIDE, EVENT_STATE_BELOW or EVENT_STATE_ABOVE.
+    sfe_as7343_event_state_t getState(sfe_as7343_channel_t channel);
+
+  private:
+    /// @brief Center the gate window on the gate channel of a frame.
+    /// @param frame The frame.
+    /// @return True if successful, false if it fails.
+    bool armGate(const sfe_as7343_frame_t &frame);
+
+    sfDevAS7343 *_sensor;                                 // The sensor.
+    sfe_as7343_spectral_threshold_channel_t _gateChannel; // ADC channel the hardware gate watches.
+    uint8_t _gatePercent;                                 // Gate window half width, percent of the reading.
+    uint32_t _enabledMask;                                // Channels with thresholds.
+    uint32_t _changedMask;                                // Channels the last frame moved.
+    uint16_t _low[ksfAS7343NumChannels];                  // Low thresholds.
+    uint16_t _high[ksfAS7343NumChannels];                 // High thresholds.
+    uint16_t _hysteresis[ksfAS7343NumChannels];           // Hysteresis of each channel.
+    uint8_t _state[ksfAS7343NumChannels];                 // sfe_as7343_event_state_t of each channel.
+    bool _started;                                        // True once a frame set the starting states.
+};
@@ -0,0 +1,196 @@
+/**
+ * @file sfDevAS7343Flicker.cpp
+ * @brief Implementation file for the SparkFun AS7343 flicker analyzer.
+ *
+ * @details
+ * Implements the fixed point Goertzel filter bank and the peak search of
+ * sfDevAS7343FlickerAnalyzer.
+ *
+ * @author SparkFun Electronics
+ * @date 2026
+ * @copyright Copyright (c) 2026, SparkFun Electronics Inc. All rights reserved.
+ *
+ * @section License License
+ * SPDX-License-Identifier: MIT
+ *
+ * @see https://github.com/sparkfun/SparkFun_AS7343_Arduino_Library
+ */
+#include "sfDevAS7343Flicker.h"
+
+#include <math.h>
+
+// Goertzel coefficients are Q14, 2 cos() spans -2 to 2.
+const uint8_t ksfFlickerCoefShift = 14;
+
+// Samples are centered on mid scale, DC lands in bin 0, which is never analyzed.
+const int16_t ksfFlickerSampleMid = 128;
+
+// Shortest sensible analysis block.
+const uint16_t ksfFlickerMinBlock = 16;
+
+// A flicker is detected if the strongest filter has this many times the mean
+// power of the others, and the light is modulated by at least
+// ksfFlickerMinModulation percent.
+const uint8_t ksfFlickerPeakRatio = 4;
+const uint8_t ksfFlickerMinModulation = 1;
+
+bool sfDevAS7343FlickerAnalyzer::begin(uint32_t samplePeriodNs, uint16_t blockSize, uint16_t minHz, uint16_t maxHz)
+{
+    if (samplePeriodNs == 0 || blockSize < ksfFlickerMinBlock || blockSize > ksfAS7343FlickerMaxBlock ||
+        minHz > maxHz)
+        return false;
+
+    // DFT bin k is at k / (N x T), so k = f x N x T.
+    uint64_t binScale = (uint64_t)blockSize * samplePeriodNs;
+    uint32_t kMin = (uint32_t)(((uint64_t)minHz * binScale + 999999999ULL) / 1000000000ULL);
+    uint32_t kMax = (uint32_t)(((uint64_t)maxHz * binScale) / 1000000000ULL);
+
+    // Bin 0 is DC, bins from N / 2 on mirror the ones below.
+    if (kMin < 1)
+        kMin = 1;
+    if (kMax > (uint32_t)blockSize / 2 - 1)
+        kMax = blockSize / 2 - 1;
+
+    if (kMin > kMax)
+        return false;
+
+    // Spread the filters evenly if the range has more bins than filters.
+    uint32_t span = kMax - kMin + 1;
+    _binStep = (uint16_t)((span + ksfAS7343FlickerMaxBins - 1) / ksfAS7343FlickerMaxBins);
+    _numBins = (uint8_t)((span - 1) / _binStep + 1);
+    _binFirst = (uint16_t)kMin;
+    _blockSize = blockSize;
+    _samplePeriodNs = samplePeriodNs;
+
+    for (uint8_t i = 0; i < _numBins; i++)
+    {
+        float w = 2.0f * (float)M_PI * (float)(_binFirst + i * _binStep) / (float)blockSize;
+        long coef = lroundf(2.0f * cosf(w) * (float)(1 << ksfFlickerCoefShift));
+
+        // Only bins close to DC round up to 2.0, which does not fit.
+        _coef[i] = (int16_t)(coef > INT16_MAX ? INT16_MAX : coef);
+    }
+
+    _result = {};
+    reset();
+
+    return true;
+}
+
+void sfDevAS7343FlickerAnalyzer::reset(void)
+{
+    for (uint8_t i = 0; i < _numBins; i++)
+        _s1[i] = _s2[i] = 0;
+
+    _count = 0;
+    _sum = 0;
+    _min = 0xFF;
+    _max = 0;
+}
+
+bool sfDevAS7343FlickerAnalyzer::addSamples(const uint8_t *samples, size_t count)
+{
+    if (!samples || _numBins == 0)
+        return false;
+
+    bool completed = false;
+
+    for (size_t n = 0; n < count; n++)
+    {
+        uint8_t sample = samples[n];
+        int32_t x = (int32_t)sample - ksfFlickerSampleMid;
+
+        // s = x + 2 cos(w) s1 - s2, the state stays below N x 128 / sin(w), within 32 bits.
+        for (uint8_t i = 0; i < _numBins; i++)
+        {
+            int32_t s = x + (int32_t)(((int64_t)_coef[i] * _s1[i]) >> ksfFlickerCoefShift) - _s2[i];
+            _s2[i] = _s1[i];
+            _s1[i] = s;
+        }
+
+        _sum += sample;
+        if (sample < _min)
+            _min = sample;
+        if (sample > _max)
+            _max = sample;
+
+        if (++_count == _blockSize)
+        {
+            finishBlock();
+            completed = true;
+        }
+    }
+
+    return completed;
+}
+
+bool sfDevAS7343FlickerAnalyzer::getResult(sfe_as7343_flicker_result_t &result)
+{
+    result = _result;
+
+    return _result.valid;
+}
+
+void sfDevAS7343FlickerAnalyzer::finishBlock(void)
+{
+    // Power of each filter, s1^2 + s2^2 - 2 cos(w) s1 s2.
+    float magnitude[ksfAS7343FlickerMaxBins];
+    float totalPower = 0.0f;
+    uint8_t peak = 0;
+
+    for (uint8_t i = 0; i < _numBins; i++)
+    {
+        int64_t s1 = _s1[i];
+        int64_t s2 = _s2[i];
+        int64_t power = s1 * s1 + s2 * s2 - ((_coef[i] * s1) >> ksfFlickerCoefShift) * s2;
+
+        if (power < 0)
+            power = 0;
+
+        magnitude[i] = (float)power;
+        totalPower += magnitude[i];
+
+        if (magnitude[i] > magnitude[peak])
+            peak = i;
+    }
+
+    _result.valid = true;
+    _result.saturated = _max == 0xFF;
+    _result.mean = (uint8_t)((_sum + _blockSize / 2) / _blockSize);
+    _result.modulation = (_max + _min) == 0 ? 0 : (uint8_t)(100 * (_max - _min) / (_max + _min));
+
+    // The peak has to stand out from the mean of the other filters.
+    float otherPower = _numBins > 1 ? (totalPower - magnitude[peak]) / (_numBins - 1) : 0.0f;
+
+    _result.detected = magnitude[peak] > 0.0f && magnitude[peak] > ksfFlickerPeakRatio * otherPower &&
+                       _result.modulation >= ksfFlickerMinModulation;
+
+    if (!_result.detected)
+    {
+        _result.frequency = 0.0f;
+    }
+    else
+    {
+        // Refine the peak with a parabola through it and its neighbours' magnitudes.
+        float offset = 0.0f;
+        if (peak > 0 && peak < _numBins - 1)
+        {
+            float a = sqrtf(magnitude[peak - 1]);
+            float b = sqrtf(magnitude[peak]);
+            float c = sqrtf(magnitude[peak + 1]);
+            float denom = a - 2.0f * b + c;
+
+            if (denom < 0.0f)
+                offset = 0.5f * (a - c) / denom;
+            if (offset > 0.5f)
+                offset = 0.5f;
+            else if (offset < -0.5f)
+                offset = -0.5f;
+        }
+
+        float bin = (float)(_binFirst + peak * _binStep) + offset * _binStep;
+        _result.frequency = bin * 1e9f / ((float)_blockSize * (float)_samplePeriodNs);
+    }
+
+    reset();
+}
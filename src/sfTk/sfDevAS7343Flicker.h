@@ -0,0 +1,126 @@
+/**
+ * @file sfDevAS7343Flicker.h
+ * @brief Flicker frequency analysis of raw AS7343 flicker detection samples.
+ *
+ * @details
+ * The on-chip flicker detection only reports 100Hz and 120Hz. With
+ * sfDevAS7343::enableFlickerStream() the device writes its raw 8-bit flicker
+ * detection (ADC5) samples to the FIFO instead, and
+ * sfDevAS7343FlickerAnalyzer finds the dominant flicker frequency in them,
+ * e.g. from PWM dimmed LEDs.
+ *
+ * Each block of samples runs through a bank of fixed point Goertzel filters
+ * spread over the frequency range of interest, one multiply per filter and
+ * sample, so the analysis keeps up while the samples stream in and no block
+ * buffer is needed. At the end of a block the strongest filter, refined by
+ * interpolation with its neighbours, gives the frequency. The modulation
+ * depth is the percent flicker, 100 x (max - min) / (max + min).
+ *
+ * @author SparkFun Electronics
+ * @date 2026
+ * @copyright Copyright (c) 2026, SparkFun Electronics Inc. This project is released under the MIT License.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * @section Repository Repository
+ * https://github.com/sparkfun/SparkFun_AS7343_Arduino_Library
+ */
+
+#pragma once
+
+#include "sfDevAS7343.h"
+
+// Goertzel filters per analyzer, spread evenly over the frequency range.
+const uint8_t ksfAS7343FlickerMaxBins = 32;
+
+// Longest analysis block, in samples.
+const uint16_t ksfAS7343FlickerMaxBlock = 1024;
+
+// Flicker analysis result, of one block of samples.
+typedef struct
+{
+    bool valid;         // A block has been analyzed
+    bool detected;      // A periodic flicker stands out in the range
+    bool saturated;     // At least one sample was at full scale (0xFF)
+    float frequency;    // Dominant flicker frequency in Hz, 0 if none detected
+    uint8_t modulation; // Modulation depth (percent flicker), 0-100
+    uint8_t mean;       // Mean sample value
+} sfe_as7343_flicker_result_t;
+
+/**
+ * @class sfDevAS7343FlickerAnalyzer
+ * @brief Fixed point Goertzel filter bank for streamed flicker samples.
+ *
+ * @details
+ * Usage:
+ * @code
+ * sfDevAS7343FlickerAnalyzer analyzer;
+ * analyzer.begin(sensor.getFlickerSamplePeriodNs(), 512, 50, 400);
+ *
+ * // loop():
+ * uint8_t samples[64];
+ * size_t n = sensor.readFlickerSamples(samples, sizeof(samples));
+ * if (analyzer.addSamples(samples, n)) analyzer.getResult(result);
+ * @endcode
+ *
+ * The frequency resolution of the filters is the sample rate / blockSize,
+ * larger blocks resolve closer frequencies. Frequencies up to half the
+ * sample rate can be analyzed.
+ *
+ * The filter multiply is 32 x 16 bits with a 64-bit result, a single
+ * instruction on 32-bit cores. On 8-bit AVR boards it is slow, keep the
+ * sample rate low or the range narrow (fewer filters) there.
+ */
+class sfDevAS7343FlickerAnalyzer
+{
+  public:
+    sfDevAS7343FlickerAnalyzer()
+        : _numBins{0}, _binStep{1}, _binFirst{0}, _blockSize{0}, _samplePeriodNs{0}, _count{0}, _sum{0}, _min{0xFF},
+          _max{0}, _result{}
+    {
+    }
+
+    /// @brief Set up the analysis.
+    /// @param samplePeriodNs Time between samples in nanoseconds, see
+    /// sfDevAS7343::getFlickerSamplePeriodNs().
+    /// @param blockSize Samples per analysis block, up to ksfAS7343FlickerMaxBlock.
+    /// @param minHz Lowest frequency of interest.
+    /// @param maxHz Highest frequency of interest, limited to half the sample rate.
+    /// @return True if successful, false if the settings leave no frequency to analyze.
+    bool begin(uint32_t samplePeriodNs, uint16_t blockSize, uint16_t minHz, uint16_t maxHz);
+
+    /// @brief Restart the current block, e.g. after samples were lost.
+    void reset(void);
+
+    /// @brief Feed samples into the analysis.
+    /// @details Samples beyond the end of a block start the next one. Each
+    /// sample costs one fixed point multiply per filter.
+    /// @param samples Pointer to the samples, from sfDevAS7343::readFlickerSamples().
+    /// @param count Number of samples.
+    /// @return True if at least one block was completed, getResult() has the
+    /// result of the last one.
+    bool addSamples(const uint8_t *samples, size_t count);
+
+    /// @brief Get the result of the last completed block.
+    /// @param result Reference to the result to fill.
+    /// @return True if a block has been analyzed, false if not.
+    bool getResult(sfe_as7343_flicker_result_t &result);
+
+  private:
+    /// @brief Turn the filter states of a completed block into the result.
+    void finishBlock(void);
+
+    int16_t _coef[ksfAS7343FlickerMaxBins];   // 2 cos(2 pi k / N) of each filter, Q14.
+    int32_t _s1[ksfAS7343FlickerMaxBins];     // Goertzel state, last output.
+    int32_t _s2[ksfAS7343FlickerMaxBins];     // Goertzel state, output before that.
+    uint8_t _numBins;                         // Filters in use.
+    uint16_t _binStep;                        // Spacing of the filters, in DFT bins.
+    uint16_t _binFirst;                       // DFT bin of the first filter.
+    uint16_t _blockSize;                      // Samples per block (N).
+    uint32_t _samplePeriodNs;                 // Time between samples.
+    uint16_t _count;                          // Samples in the current block.
+    uint32_t _sum;                            // Sum of the samples in the current block.
+    uint8_t _min;                             // Smallest sample in the current block.
+    uint8_t _max;                             // Largest sample in the current block.
+    sfe_as7343_flicker_result_t _result;      // Result of the last completed block.
+};
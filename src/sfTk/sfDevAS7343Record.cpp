@@ -0,0 +1,303 @@
+/**
+ * @file sfDevAS7343Record.cpp
+ * @brief Implementation file for the SparkFun AS7343 binary frame records.
+ *
+ * @details
+ * Implements the varint / zigzag coding and the key and delta records of
+ * sfDevAS7343RecordEncoder and sfDevAS7343RecordDecoder.
+ *
+ * @author SparkFun Electronics
+ * @date 2026
+ * @copyright Copyright (c) 2026, SparkFun Electronics Inc. All rights reserved.
+ *
+ * @section License License
+ * SPDX-License-Identifier: MIT
+ *
+ * @see https://github.com/sparkfun/SparkFun_AS7343_Arduino_Library
+ */
+#include "sfDevAS7343Record.h"
+#include "sfDevAS7343Crc.h"
+
+#include <string.h>
+
+// Version / type byte.
+const uint8_t ksfRecordKeyFlag = 0x01;
+const uint8_t ksfRecordVersionShift = 4;
+
+// Flags byte.
+const uint8_t ksfRecordFlagValid = 0x01;
+const uint8_t ksfRecordFlagSatAnalog = 0x02;
+const uint8_t ksfRecordFlagSatDigital = 0x04;
+const uint8_t ksfRecordFlagDarkCorrected = 0x08;
+const uint8_t ksfRecordSmuxShift = 4;
+const uint8_t ksfRecordSmuxMask = 0x03;
+
+/// @brief Number of channels a SMUX mode fills.
+/// @param autoSmux The SMUX mode.
+/// @return 6, 12 or 18.
+static uint8_t sfRecordNumChannels(uint8_t autoSmux)
+{
+    if (autoSmux == AUTOSMUX_18_CHANNELS)
+        return 18;
+    if (autoSmux == AUTOSMUX_12_CHANNELS)
+        return 12;
+
+    return 6;
+}
+
+/// @brief Append an unsigned LEB128 varint.
+/// @param out Write position, moved past the varint.
+/// @param value The value.
+static void sfRecordPutVarint(uint8_t *&out, uint32_t value)
+{
+    while (value >= 0x80)
+    {
+        *out++ = (uint8_t)(value | 0x80);
+        value >>= 7;
+    }
+
+    *out++ = (uint8_t)value;
+}
+
+/// @brief Read an unsigned LEB128 varint.
+/// @param in Read position, moved past the varint.
+/// @param end End of the bytes.
+/// @param value Set to the value.
+/// @return True if successful, false if the varint runs past the end or 32 bits.
+static bool sfRecordGetVarint(const uint8_t *&in, const uint8_t *end, uint32_t &value)
+{
+    value = 0;
+
+    for (uint8_t shift = 0; shift < 35; shift += 7)
+    {
+        if (in >= end)
+            return false;
+
+        uint8_t byte = *in++;
+        value |= (uint32_t)(byte & 0x7F) << shift;
+
+        if (!(byte & 0x80))
+            return true;
+    }
+
+    return false;
+}
+
+bool sfDevAS7343RecordEncoder::begin(sfDevAS7343 *sensor, uint8_t keyInterval)
+{
+    if (keyInterval == 0)
+        return false;
+
+    _sensor = sensor;
+    _keyInterval = keyInterval;
+
+    restart();
+
+    return true;
+}
+
+void sfDevAS7343RecordEncoder::restart(void)
+{
+    _sinceKey = 0;
+}
+
+size_t sfDevAS7343RecordEncoder::encode(const sfe_as7343_frame_t &frame, uint8_t *out, size_t size)
+{
+    if (!_sensor)
+        return 0;
+
+    sfe_as7343_record_t record;
+
+    // Everything but the frame comes from the shadow and the data buffer, no I2C traffic.
+    if (_sensor->getIntegrationTime(record.atime, record.astep) == false)
+        return 0;
+
+    uint8_t numChannels = _sensor->getAutoSmuxChannelCount();
+
+    record.autoSmux = numChannels == 18   ? AUTOSMUX_18_CHANNELS
+                      : numChannels == 12 ? AUTOSMUX_12_CHANNELS
+                                          : AUTOSMUX_6_CHANNELS;
+    record.sequence = _sensor->getFrameSequence();
+    record.frame = frame;
+
+    return encode(record, out, size);
+}
+
+size_t sfDevAS7343RecordEncoder::encode(const sfe_as7343_record_t &record, uint8_t *out, size_t size)
+{
+    if (!out || size < ksfAS7343RecordMaxBytes)
+        return 0;
+
+    const sfe_as7343_frame_t &frame = record.frame;
+    uint8_t numChannels = sfRecordNumChannels(record.autoSmux);
+
+    // Delta records need the previous record in the same SMUX mode.
+    bool key = _sinceKey == 0 || record.autoSmux != _prevAutoSmux;
+
+    uint8_t *p = out + ksfAS7343RecordHeaderBytes;
+
+    *p++ = (frame.valid ? ksfRecordFlagValid : 0) | (frame.saturatedAnalog ? ksfRecordFlagSatAnalog : 0) |
+           (frame.saturatedDigital ? ksfRecordFlagSatDigital : 0) |
+           (frame.darkCorrected ? ksfRecordFlagDarkCorrected : 0) |
+           (uint8_t)((record.autoSmux & ksfRecordSmuxMask) << ksfRecordSmuxShift);
+    *p++ = (uint8_t)frame.gain;
+    *p++ = record.atime;
+    sfRecordPutVarint(p, record.astep);
+
+    if (key)
+    {
+        sfRecordPutVarint(p, record.sequence);
+        sfRecordPutVarint(p, frame.timestamp);
+
+        for (uint8_t ch = 0; ch < numChannels; ch++)
+            sfRecordPutVarint(p, frame.data[ch]);
+    }
+    else
+    {
+        // Unsigned differences wrap along with the counters.
+        sfRecordPutVarint(p, record.sequence - _prevSequence);
+        sfRecordPutVarint(p, frame.timestamp - _prevTimestamp);
+
+        // Zigzag keeps small differences of either sign small.
+        for (uint8_t ch = 0; ch < numChannels; ch++)
+        {
+            int32_t delta = (int32_t)frame.data[ch] - (int32_t)_prevData[ch];
+            sfRecordPutVarint(p, delta >= 0 ? (uint32_t)delta << 1 : ((uint32_t)(-delta) << 1) - 1);
+        }
+    }
+
+    size_t length = p - out;
+
+    out[0] = ksfAS7343RecordSync;
+    out[1] = (uint8_t)(ksfAS7343RecordVersion << ksfRecordVersionShift) | (key ? ksfRecordKeyFlag : 0);
+    out[2] = (uint8_t)(length - ksfAS7343RecordHeaderBytes);
+    out[length] = sfDevAS7343Crc8(out, length);
+
+    _prevSequence = record.sequence;
+    _prevTimestamp = frame.timestamp;
+    _prevAutoSmux = record.autoSmux;
+    memcpy(_prevData, frame.data, sizeof(_prevData));
+
+    _sinceKey = key ? 1 : _sinceKey + 1;
+    if (_sinceKey >= _keyInterval)
+        _sinceKey = 0;
+
+    return length + 1;
+}
+
+void sfDevAS7343RecordDecoder::reset(void)
+{
+    _synced = false;
+}
+
+bool sfDevAS7343RecordDecoder::decode(const uint8_t *in, size_t size, size_t &used, sfe_as7343_record_t &record)
+{
+    used = 0;
+
+    if (!in)
+        return false;
+
+    // Skip to the next sync byte.
+    while (used < size && in[used] != ksfAS7343RecordSync)
+        used++;
+
+    // Bytes between records mean a record was lost, a delta record after it has nothing to build on.
+    if (used > 0)
+    {
+        _synced = false;
+        return false;
+    }
+
+    if (size < ksfAS7343RecordHeaderBytes)
+        return false;
+
+    uint8_t type = in[1];
+    size_t length = ksfAS7343RecordHeaderBytes + in[2];
+
+    // A version this decoder doesn't know, or a length no record has, means this is no record start.
+    if ((type >> ksfRecordVersionShift) != ksfAS7343RecordVersion || length + 1 > ksfAS7343RecordMaxBytes)
+    {
+        _synced = false;
+        used = 1;
+        return false;
+    }
+
+    if (size < length + 1)
+        return false;
+
+    if (sfDevAS7343Crc8(in, length) != in[length])
+    {
+        _synced = false;
+        used = 1;
+        return false;
+    }
+
+    // From here on the record is intact, it is consumed whether it decodes or not.
+    used = length + 1;
+
+    bool key = type & ksfRecordKeyFlag;
+
+    if (!key && !_synced)
+        return false;
+
+    // Until this record decodes, a delta record after it has nothing to build on.
+    _synced = false;
+
+    const uint8_t *p = in + ksfAS7343RecordHeaderBytes;
+    const uint8_t *end = in + length;
+
+    if (end - p < 3)
+        return false;
+
+    uint8_t flags = *p++;
+    uint8_t gain = *p++;
+
+    sfe_as7343_record_t next;
+    memset(&next, 0, sizeof(next));
+
+    next.atime = *p++;
+    next.autoSmux = (sfe_as7343_auto_smux_channel_t)((flags >> ksfRecordSmuxShift) & ksfRecordSmuxMask);
+    next.frame.gain = (sfe_as7343_again_t)gain;
+    next.frame.valid = flags & ksfRecordFlagValid;
+    next.frame.saturatedAnalog = flags & ksfRecordFlagSatAnalog;
+    next.frame.saturatedDigital = flags & ksfRecordFlagSatDigital;
+    next.frame.darkCorrected = flags & ksfRecordFlagDarkCorrected;
+
+    uint32_t astep, sequence, timestamp;
+    if (!sfRecordGetVarint(p, end, astep) || !sfRecordGetVarint(p, end, sequence) ||
+        !sfRecordGetVarint(p, end, timestamp))
+        return false;
+
+    // A delta record only follows a record of its own SMUX mode.
+    if (!key && next.autoSmux != _prev.autoSmux)
+        return false;
+
+    next.astep = (uint16_t)astep;
+    next.sequence = key ? sequence : _prev.sequence + sequence;
+    next.frame.timestamp = key ? timestamp : _prev.frame.timestamp + timestamp;
+
+    uint8_t numChannels = sfRecordNumChannels(next.autoSmux);
+
+    for (uint8_t ch = 0; ch < numChannels; ch++)
+    {
+        uint32_t value;
+        if (!sfRecordGetVarint(p, end, value))
+            return false;
+
+        if (key)
+        {
+            next.frame.data[ch] = (uint16_t)value;
+        }
+        else
+        {
+            int32_t delta = (value & 1) ? -(int32_t)((value + 1) >> 1) : (int32_t)(value >> 1);
+            next.frame.data[ch] = (uint16_t)(_prev.frame.data[ch] + delta);
+        }
+    }
+
+    _prev = next;
+    _synced = true;
+    record = next;
+
+    return true;
+}
@@ -0,0 +1,175 @@
+/**
+ * @file sfDevAS7343Record.h
+ * @brief Compact binary frame records for logging SparkFun AS7343 frames.
+ *
+ * @details
+ * A record holds one frame with everything needed to interpret it: the
+ * sequence number, timestamp, gain, ATIME, ASTEP, SMUX mode and the
+ * saturation flags. An 18 channel frame takes about 30 to 45 bytes instead
+ * of the ~150 bytes of the printed text, so SD card and UART loggers can
+ * keep up with the sensor.
+ *
+ * Record layout, version 1:
+ *
+ * - 1 byte sync, ksfAS7343RecordSync
+ * - 1 byte version (bits 7:4) and type (bit 0: 1 key record, 0 delta record)
+ * - 1 byte payload length
+ * - payload:
+ *   - 1 byte flags: bit 0 valid, bit 1 analog saturation, bit 2 digital
+ *     saturation, bit 3 dark corrected, bits 5:4 SMUX mode (auto_smux)
+ *   - 1 byte gain (sfe_as7343_again_t)
+ *   - 1 byte ATIME
+ *   - varint ASTEP
+ *   - varint sequence number, key records the number, delta records the
+ *     increase from the previous record
+ *   - varint timestamp, key records the time, delta records the increase
+ *   - one value per channel of the SMUX mode (6, 12 or 18), key records
+ *     varint counts, delta records zigzag varint differences from the
+ *     previous record
+ * - 1 byte CRC-8 (see sfDevAS7343Crc.h) of all bytes before it
+ *
+ * Varints are unsigned LEB128, 7 bits per byte, lowest first, bit 7 set on
+ * all but the last byte. Zigzag maps 0, -1, 1, -2, ... to 0, 1, 2, 3, ...
+ * Delta records need the record before them, so every n-th record (see
+ * sfDevAS7343RecordEncoder::begin()) is a key record a decoder can start at.
+ *
+ * tools/as7343_decode.py decodes records on a host.
+ *
+ * @author SparkFun Electronics
+ * @date 2026
+ * @copyright Copyright (c) 2026, SparkFun Electronics Inc. This project is released under the MIT License.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * @section Repository Repository
+ * https://github.com/sparkfun/SparkFun_AS7343_Arduino_Library
+ */
+
+#pragma once
+
+#include "sfDevAS7343.h"
+
+// Record format constants.
+const uint8_t ksfAS7343RecordSync = 0xA7;     // First byte of every record
+const uint8_t ksfAS7343RecordVersion = 1;     // Record format version
+const uint8_t ksfAS7343RecordMaxBytes = 74;   // Longest record: 18 channels, all varints at full length
+const uint8_t ksfAS7343RecordHeaderBytes = 3; // Sync, version / type and length
+
+// One frame with the settings it was measured with, as encoded and decoded.
+typedef struct
+{
+    uint32_t sequence;                       // Frame sequence number (sfDevAS7343::getFrameSequence())
+    uint8_t atime;                           // ATIME of the measurement
+    uint16_t astep;                          // ASTEP of the measurement
+    sfe_as7343_auto_smux_channel_t autoSmux; // SMUX mode, sets the channels in the record
+    sfe_as7343_frame_t frame;                // The frame, the status registers are not recorded
+} sfe_as7343_record_t;
+
+/**
+ * @class sfDevAS7343RecordEncoder
+ * @brief Encodes frames to binary records.
+ *
+ * @details
+ * Usage:
+ * @code
+ * sfDevAS7343RecordEncoder encoder;
+ * encoder.begin(&sensor);
+ *
+ * // loop():
+ * uint8_t record[ksfAS7343RecordMaxBytes];
+ * if (sensor.readFrame(frame) && frame.valid)
+ *     Serial.write(record, encoder.encode(frame, record, sizeof(record)));
+ * @endcode
+ */
+class sfDevAS7343RecordEncoder
+{
+  public:
+    sfDevAS7343RecordEncoder()
+        : _sensor{nullptr}, _keyInterval{1}, _sinceKey{0}, _prevSequence{0}, _prevTimestamp{0}, _prevAutoSmux{},
+          _prevData{}
+    {
+    }
+
+    /// @brief Set up the encoder.
+    /// @param sensor Sensor the frames come from, provides the sequence number,
+    /// integration time and SMUX mode for encode(frame). nullptr if only
+    /// encode(record) is used.
+    /// @param keyInterval Every n-th record is a key record, 1 makes them all
+    /// key records. The default is 16.
+    /// @return True if successful, false if the interval is 0.
+    bool begin(sfDevAS7343 *sensor, uint8_t keyInterval = 16);
+
+    /// @brief Make the next record a key record.
+    /// @details Call this when records were lost on the way (e.g. a full
+    /// buffer), so the decoder can pick up again.
+    void restart(void);
+
+    /// @brief Encode a frame that was just read.
+    /// @details The sequence number, integration time and SMUX mode come from
+    /// the sensor, without any I2C traffic. Encode right after
+    /// readFrame(), before the next read or setting change.
+    /// @param frame Frame from sfDevAS7343::readFrame().
+    /// @param out Buffer for the record.
+    /// @param size Size of the buffer, ksfAS7343RecordMaxBytes always fits.
+    /// @return The record length, 0 if it fails or the buffer is too small.
+    size_t encode(const sfe_as7343_frame_t &frame, uint8_t *out, size_t size);
+
+    /// @brief Encode a record.
+    /// @param record The record to encode.
+    /// @param out Buffer for the record.
+    /// @param size Size of the buffer, ksfAS7343RecordMaxBytes always fits.
+    /// @return The record length, 0 if the buffer is too small.
+    size_t encode(const sfe_as7343_record_t &record, uint8_t *out, size_t size);
+
+  private:
+    sfDevAS7343 *_sensor;                         // Sensor the frames come from.
+    uint8_t _keyInterval;                         // Records per key record.
+    uint8_t _sinceKey;                            // Records since the last key record, 0 forces a key record.
+    uint32_t _prevSequence;                       // Sequence number of the previous record.
+    uint32_t _prevTimestamp;                      // Timestamp of the previous record.
+    sfe_as7343_auto_smux_channel_t _prevAutoSmux; // SMUX mode of the previous record.
+    uint16_t _prevData[ksfAS7343NumChannels];     // Channels of the previous record.
+};
+
+/**
+ * @class sfDevAS7343RecordDecoder
+ * @brief Decodes binary records back to frames.
+ *
+ * @details
+ * Feed it the bytes as they come in, it syncs to the first key record and
+ * skips damaged records:
+ * @code
+ * size_t used;
+ * while (decoder.decode(buffer, length, used, record) || used)
+ * {
+ *     // record is valid if decode() returned true
+ *     buffer += used;
+ *     length -= used;
+ * }
+ * @endcode
+ */
+class sfDevAS7343RecordDecoder
+{
+  public:
+    sfDevAS7343RecordDecoder() : _synced{false}, _prev{}
+    {
+    }
+
+    /// @brief Forget the previous record, wait for the next key record.
+    void reset(void);
+
+    /// @brief Decode the next record.
+    /// @param in Pointer to the bytes.
+    /// @param size Number of bytes.
+    /// @param used Set to the number of bytes to drop before the next call:
+    /// the record, or bytes skipped while looking for one. 0 if more bytes
+    /// are needed.
+    /// @param record Reference to the record to fill.
+    /// @return True if a record was decoded, false if not (more bytes needed,
+    /// a damaged record, or a delta record before the first key record).
+    bool decode(const uint8_t *in, size_t size, size_t &used, sfe_as7343_record_t &record);
+
+  private:
+    bool _synced;              // True once a key record was decoded.
+    sfe_as7343_record_t _prev; // The previous record.
+};
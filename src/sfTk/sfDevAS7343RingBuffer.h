@@ -0,0 +1,113 @@
+/**
+ * @file sfDevAS7343RingBuffer.h
+ * @brief Fixed capacity single-producer/single-consumer ring buffer.
+ *
+ * @details
+ * A small lock-free queue used to hand frames from the code that services the
+ * AS7343 interrupt to the application. One side only ever calls push(), the
+ * other only ever calls pop(), so no locks or interrupt masking are needed.
+ *
+ * The head and tail indexes are single bytes, which every supported MCU
+ * (including AVR) reads and writes atomically.
+ *
+ * @author SparkFun Electronics
+ * @date 2026
+ * @copyright Copyright (c) 2026, SparkFun Electronics Inc. This project is released under the MIT License.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * @section Repository Repository
+ * https://github.com/sparkfun/SparkFun_AS7343_Arduino_Library
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+// Memory barrier between writing an element and publishing the index that makes it visible.
+// AVR is single core and in-order, so a compiler barrier is enough there.
+#if defined(__AVR__)
+#define SFE_AS7343_MEMORY_BARRIER() __asm__ __volatile__("" ::: "memory")
+#else
+#define SFE_AS7343_MEMORY_BARRIER() __atomic_thread_fence(__ATOMIC_SEQ_CST)
+#endif
+
+/**
+ * @class sfDevAS7343RingBuffer
+ * @brief Lock-free SPSC ring buffer of N elements of type T.
+ *
+ * @tparam T Element type, copied in and out by value.
+ * @tparam N Capacity, a power of two from 2 to 128.
+ */
+template <typename T, uint8_t N> class sfDevAS7343RingBuffer
+{
+    static_assert(N >= 2 && N <= 128 && (N & (N - 1)) == 0, "Capacity must be a power of two from 2 to 128");
+
+  public:
+    sfDevAS7343RingBuffer() : _head{0}, _tail{0}
+    {
+    }
+
+    /// @brief Add an element (producer side).
+    /// @param item The element to add.
+    /// @return True if successful, false if the buffer is full.
+    bool push(const T &item)
+    {
+        uint8_t head = _head;
+
+        if ((uint8_t)(head - _tail) >= N)
+            return false;
+
+        _items[head & (N - 1)] = item;
+
+        // Make sure the element is written before the consumer can see it.
+        SFE_AS7343_MEMORY_BARRIER();
+
+        _head = head + 1;
+
+        return true;
+    }
+
+    /// @brief Remove the oldest element (consumer side).
+    /// @param item Reference to store the element in.
+    /// @return True if successful, false if the buffer is empty.
+    bool pop(T &item)
+    {
+        uint8_t tail = _tail;
+
+        if (tail == _head)
+            return false;
+
+        // Make sure the element is read after the producer published it.
+        SFE_AS7343_MEMORY_BARRIER();
+
+        item = _items[tail & (N - 1)];
+
+        // Make sure the element is copied out before the slot is handed back to the producer.
+        SFE_AS7343_MEMORY_BARRIER();
+
+        _tail = tail + 1;
+
+        return true;
+    }
+
+    /// @brief Get the number of elements waiting.
+    /// @return The number of elements in the buffer.
+    uint8_t available(void) const
+    {
+        return (uint8_t)(_head - _tail);
+    }
+
+    /// @brief Get the capacity.
+    /// @return The maximum number of elements the buffer holds.
+    uint8_t capacity(void) const
+    {
+        return N;
+    }
+
+  private:
+    T _items[N]; // Element storage.
+
+    volatile uint8_t _head; // Free running write count, only changed by the producer.
+    volatile uint8_t _tail; // Free running read count, only changed by the consumer.
+};
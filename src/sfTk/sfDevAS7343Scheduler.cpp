@@ -0,0 +1,308 @@
+/**
+ * @file sfDevAS7343Scheduler.cpp
+ * @brief Implementation file for the SparkFun AS7343 adaptive measurement scheduling.
+ *
+ * @details
+ * Implements the time budget, the SNR index and saturation estimates, and the
+ * re-tuning of sfDevAS7343Scheduler.
+ *
+ * @author SparkFun Electronics
+ * @date 2026
+ * @copyright Copyright (c) 2026, SparkFun Electronics Inc. All rights reserved.
+ *
+ * @section License License
+ * SPDX-License-Identifier: MIT
+ *
+ * @see https://github.com/sparkfun/SparkFun_AS7343_Arduino_Library
+ */
+#include "sfDevAS7343Scheduler.h"
+
+#include <math.h>
+
+bool sfDevAS7343Scheduler::begin(sfDevAS7343 *sensor, uint16_t targetFps, uint16_t minSnrIndex)
+{
+    if (!sensor)
+        return false;
+
+    _sensor = sensor;
+    _minSnrIndex = minSnrIndex;
+    _numCycles = 0;
+
+    if (setTargetFps(targetFps) == false)
+        return false;
+
+    return restart();
+}
+
+bool sfDevAS7343Scheduler::setTargetFps(uint16_t targetFps)
+{
+    if (targetFps == 0)
+        return false;
+
+    uint32_t periodUs = _periodUs;
+    _periodUs = 1000000UL / targetFps;
+
+    // The fewest channels must at least fit.
+    if (getCycleTimeUs(_minCycles, 0) < ksfAS7343SchedulerMinCycleUs)
+    {
+        _periodUs = periodUs;
+        return false;
+    }
+
+    // Running, the old settings belong to the old rate.
+    if (_numCycles != 0)
+        return restart();
+
+    return true;
+}
+
+void sfDevAS7343Scheduler::setMinSnrIndex(uint16_t minSnrIndex)
+{
+    _minSnrIndex = minSnrIndex;
+}
+
+bool sfDevAS7343Scheduler::setMaxSaturationPercent(uint8_t percent)
+{
+    if (percent > 100)
+        return false;
+
+    _maxSaturation = percent;
+
+    return true;
+}
+
+bool sfDevAS7343Scheduler::setChannelRange(sfe_as7343_auto_smux_channel_t minChannels,
+                                           sfe_as7343_auto_smux_channel_t maxChannels)
+{
+    // Value 1 is reserved, 0, 2 and 3 are 1, 2 and 3 SMUX cycles.
+    if (minChannels == 1 || maxChannels == 1 || minChannels > AUTOSMUX_18_CHANNELS ||
+        maxChannels > AUTOSMUX_18_CHANNELS || minChannels > maxChannels)
+        return false;
+
+    uint8_t minCycles = _minCycles;
+    uint8_t maxCycles = _maxCycles;
+
+    _minCycles = minChannels == AUTOSMUX_6_CHANNELS ? 1 : (uint8_t)minChannels;
+    _maxCycles = maxChannels == AUTOSMUX_6_CHANNELS ? 1 : (uint8_t)maxChannels;
+
+    // Once the rate is set, the fewest channels must fit in it.
+    if (_periodUs && getCycleTimeUs(_minCycles, 0) < ksfAS7343SchedulerMinCycleUs)
+    {
+        _minCycles = minCycles;
+        _maxCycles = maxCycles;
+        return false;
+    }
+
+    // Running, the mode set may be out of the range now.
+    if (_numCycles != 0)
+        return restart();
+
+    return true;
+}
+
+bool sfDevAS7343Scheduler::update(const sfe_as7343_frame_t &frame)
+{
+    if (!_sensor || _numCycles == 0)
+        return false;
+
+    // Measured (at least partly) with the settings before the re-tune.
+    if (_settle)
+    {
+        _settle--;
+        return true;
+    }
+
+    if (!frame.valid)
+        return true;
+
+    sfe_as7343_again_t gain = _sensor->getAgain();
+
+    // Measured before the last gain change took effect, the counts don't go with the gain.
+    if (frame.gain != gain)
+        return true;
+
+    uint16_t fullScale = _sensor->getFullScale();
+    uint32_t integrationUs = _sensor->getIntegrationTimeUs();
+
+    if (fullScale == 0 || integrationUs == 0)
+        return false;
+
+    // Brightest of the channels the SMUX mode fills, they come first.
+    uint16_t peak = 0;
+    for (uint8_t ch = 0; ch < _numCycles * 6; ch++)
+    {
+        if (frame.data[ch] > peak)
+            peak = frame.data[ch];
+    }
+
+    bool saturated = frame.saturatedAnalog || frame.saturatedDigital || peak >= fullScale;
+
+    _history = (_history << 1) | (saturated ? 1 : 0);
+    if (_historyCount < ksfAS7343SchedulerHistory)
+        _historyCount++;
+
+    // Signal in counts at 1x gain (AGAIN_0_5 is 0.5x, every step doubles). Without the electrons per
+    // count its square root is only proportional to the shot noise SNR, hence an index.
+    float signal = (float)peak * 2 / (float)(1UL << gain);
+    _snrIndex = (uint16_t)sqrtf(signal);
+
+    // The gain follows every frame.
+    if (_sensor->updateAutoGain(frame) == false)
+        return false;
+
+    // Saturating more than allowed, and the gain couldn't stop it. Up to the 65535 count cap the full
+    // scale grows with the integration time just like the counts, only past it does a shorter one help.
+    if (getSaturationPercent() > _maxSaturation)
+    {
+        if (fullScale == 0xFFFF && _shift < ksfAS7343SchedulerMaxShift &&
+            getCycleTimeUs(_numCycles, _shift + 1) >= ksfAS7343SchedulerMinCycleUs)
+            return retune(_numCycles, _shift + 1);
+
+        return true;
+    }
+
+    // A clipped count says nothing about the SNR index.
+    if (saturated)
+        return true;
+
+    // A full history without saturation, and a gain step left to take back a longer integration: try it.
+    if (_shift > 0 && _historyCount == ksfAS7343SchedulerHistory && gain > AGAIN_0_5)
+        return retune(_numCycles, _shift - 1);
+
+    // The most channels whose (longer or shorter) integration still reaches the SNR index, with the light as it is.
+    float required = (float)_minSnrIndex * _minSnrIndex;
+    uint8_t numCycles = _minCycles;
+
+    for (uint8_t cycles = _maxCycles; cycles > _minCycles; cycles--)
+    {
+        uint32_t cycleUs = getCycleTimeUs(cycles, _shift);
+
+        if (cycleUs < ksfAS7343SchedulerMinCycleUs)
+            continue;
+
+        float projected = signal * cycleUs / integrationUs;
+
+        // More channels than now need a margin, so a reading at the edge doesn't flap between modes.
+        if (cycles > _numCycles)
+            projected = projected * 100 / (100 + ksfAS7343SchedulerSnrMarginPercent);
+
+        if (projected >= required)
+        {
+            numCycles = cycles;
+            break;
+        }
+    }
+
+    if (numCycles == _numCycles)
+        return true;
+
+    return retune(numCycles, _shift);
+}
+
+uint8_t sfDevAS7343Scheduler::getChannelCount(void)
+{
+    return _numCycles * 6;
+}
+
+uint16_t sfDevAS7343Scheduler::getSnrIndex(void)
+{
+    return _snrIndex;
+}
+
+uint8_t sfDevAS7343Scheduler::getSaturationPercent(void)
+{
+    uint8_t count = 0;
+
+    for (uint32_t history = _history; history; history >>= 1)
+        count += history & 1;
+
+    return (uint8_t)((uint16_t)count * 100 / ksfAS7343SchedulerHistory);
+}
+
+uint32_t sfDevAS7343Scheduler::getCycleTimeUs(uint8_t numCycles, uint8_t shift)
+{
+    uint32_t shareUs = _periodUs / numCycles;
+    uint16_t overheadUs = _sensor ? _sensor->getCycleOverheadUs() : 0;
+
+    if (shareUs <= overheadUs)
+        return 0;
+
+    return (shareUs - overheadUs) >> shift;
+}
+
+bool sfDevAS7343Scheduler::restart(void)
+{
+    uint8_t numCycles = _maxCycles;
+
+    // The most channels whose share of the period holds an integration.
+    while (numCycles > _minCycles && getCycleTimeUs(numCycles, 0) < ksfAS7343SchedulerMinCycleUs)
+        numCycles--;
+
+    return retune(numCycles, 0);
+}
+
+bool sfDevAS7343Scheduler::retune(uint8_t numCycles, uint8_t shift)
+{
+    if (!_sensor)
+        return false;
+
+    const sfe_as7343_auto_smux_channel_t modes[] = {AUTOSMUX_6_CHANNELS, AUTOSMUX_12_CHANNELS,
+                                                    AUTOSMUX_18_CHANNELS};
+
+    uint32_t oldUs = _sensor->getIntegrationTimeUs();
+
+    // Stop the measurement first, so no frame mixes the old and new settings.
+    if (_sensor->disableSpectralMeasurement() == false || _sensor->setAutoSmux(modes[numCycles - 1]) == false ||
+        _sensor->setIntegrationTime(getCycleTimeUs(numCycles, shift)) == false)
+        return false;
+
+    uint32_t newUs = _sensor->getIntegrationTimeUs();
+
+    // Keep the counts where they were, one gain step for every doubling of the integration time.
+    int8_t gain = (int8_t)_sensor->getAgain();
+    int8_t next = gain;
+
+    if (oldUs != 0 && newUs != 0)
+    {
+        while (newUs >= oldUs * 2)
+        {
+            oldUs *= 2;
+            next--;
+        }
+        while (oldUs >= newUs * 2)
+        {
+            newUs *= 2;
+            next++;
+        }
+    }
+
+    if (next < (int8_t)AGAIN_0_5)
+        next = AGAIN_0_5;
+    if (next > (int8_t)AGAIN_2048)
+        next = AGAIN_2048;
+
+    if (next != gain && _sensor->setAgain((sfe_as7343_again_t)next) == false)
+        return false;
+
+    // The wait time pads the frame to the period, when the integration leaves enough of it.
+    uint32_t measureUs = (_sensor->getIntegrationTimeUs() + _sensor->getCycleOverheadUs()) * numCycles;
+
+    if (measureUs + ksfAS7343WaitStepUs / 2 < _periodUs)
+    {
+        if (_sensor->setWaitTimeMs((_periodUs + 500) / 1000) == false || _sensor->enableWaitTime() == false)
+            return false;
+    }
+    else if (_sensor->disableWaitTime() == false)
+        return false;
+
+    if (_sensor->enableSpectralMeasurement() == false)
+        return false;
+
+    _numCycles = numCycles;
+    _shift = shift;
+    _settle = 1;
+    _history = 0;
+    _historyCount = 0;
+
+    return true;
+}
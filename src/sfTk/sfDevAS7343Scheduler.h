@@ -0,0 +1,174 @@
+/**
+ * @file sfDevAS7343Scheduler.h
+ * @brief Adaptive measurement scheduling for the SparkFun AS7343 Sensor.
+ *
+ * @details
+ * sfDevAS7343Scheduler picks the SMUX mode (6, 12 or 18 channels), the
+ * integration time (ATIME / ASTEP), the gain and the wait time (WTIME) for a
+ * target frame rate, and keeps re-tuning them as the light changes:
+ *
+ * - Time budget: every SMUX cycle gets an equal share of the frame period,
+ *   less the cycle overhead (see sfDevAS7343::setCycleOverheadUs()). The wait
+ *   time pads the period when the integration doesn't fill it.
+ * - SNR index: a relative shot noise proxy for the brightest channel,
+ *   sqrt(counts / gain) with the counts referred to 1x gain. The true shot
+ *   noise SNR is sqrt(electrons), and the electrons per count of the AS7343
+ *   aren't published, so the index only follows it up to a constant factor
+ *   (read noise and dark counts are left out too). It is meant for comparing
+ *   light levels and settings, not as an absolute SNR. It only grows with the
+ *   integration time - gain fills the ADC range, it doesn't add signal. If the
+ *   current light can't reach the minimum index with this many channels at
+ *   this rate, the scheduler drops to fewer channels (longer integration per
+ *   cycle). It goes back up once the light allows it, with a margin so it
+ *   doesn't flap.
+ * - Saturation: the ADC full scale grows with the integration time up to
+ *   65535 counts (about 182ms), so below that only the gain helps. Past it,
+ *   when more frames than allowed saturate, the integration time is halved,
+ *   and lengthened again after a run of clean frames (slow frame rates only).
+ * - Gain: sfDevAS7343::updateAutoGain() on every frame, within the range of
+ *   sfDevAS7343::setAutoGainRange(). It is pre-scaled on every re-tune, so
+ *   the counts stay where they were.
+ *
+ * @author SparkFun Electronics
+ * @date 2026
+ * @copyright Copyright (c) 2026, SparkFun Electronics Inc. This project is released under the MIT License.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * @section Repository Repository
+ * https://github.com/sparkfun/SparkFun_AS7343_Arduino_Library
+ */
+
+#pragma once
+
+#include "sfDevAS7343.h"
+
+const uint16_t ksfAS7343SchedulerMinCycleUs = 100;       // Shortest integration time per SMUX cycle
+const uint8_t ksfAS7343SchedulerSnrMarginPercent = 25;   // Extra SNR index needed before adding channels
+const uint8_t ksfAS7343SchedulerHistory = 32;            // Frames the saturation rate is measured over
+const uint8_t ksfAS7343SchedulerMaxShift = 6;            // Integration cut to 1/64 of the budget at most
+
+/**
+ * @class sfDevAS7343Scheduler
+ * @brief Picks and re-tunes SMUX mode, integration time, gain and wait time.
+ *
+ * @details
+ * Usage:
+ * @code
+ * sfDevAS7343Scheduler scheduler;
+ * scheduler.begin(&sensor, 10, 30); // 10 frames per second, SNR index 30 or better
+ *
+ * // loop():
+ * if (sensor.readFrame(frame) && frame.valid)
+ * {
+ *     sensor.clearStatusReg(frame.status);
+ *     scheduler.update(frame);
+ *     ...; // getChannelCount() channels are fresh
+ * }
+ * @endcode
+ *
+ * The scheduler owns the SMUX, integration and wait time settings while it
+ * runs, don't change them elsewhere.
+ */
+class sfDevAS7343Scheduler
+{
+  public:
+    sfDevAS7343Scheduler()
+        : _sensor{nullptr}, _periodUs{0}, _minSnrIndex{0}, _maxSaturation{5}, _minCycles{1}, _maxCycles{3},
+          _numCycles{0}, _shift{0}, _settle{0}, _snrIndex{0}, _history{0}, _historyCount{0}
+    {
+    }
+
+    /// @brief Set up the sensor for the target, and start measuring.
+    /// @details Starts with the most channels allowed (see setChannelRange()),
+    /// the first frames then show whether the light supports them.
+    /// @param sensor The sensor, powered on.
+    /// @param targetFps Frames per second, see setTargetFps().
+    /// @param minSnrIndex Lowest SNR index of the brightest channel, see
+    /// setMinSnrIndex(). The default is 20.
+    /// @return True if successful, false if it fails or the rate is too high.
+    bool begin(sfDevAS7343 *sensor, uint16_t targetFps, uint16_t minSnrIndex = 20);
+
+    /// @brief Set the target frame rate.
+    /// @details The frames come at this rate, within the 2.78ms steps of the
+    /// wait time. At least ksfAS7343SchedulerMinCycleUs of integration per
+    /// SMUX cycle of the fewest channels allowed must fit in a frame.
+    /// @param targetFps Frames per second.
+    /// @return True if successful, false if it fails or the rate is too high.
+    bool setTargetFps(uint16_t targetFps);
+
+    /// @brief Set the lowest SNR index to keep.
+    /// @details The index is a relative shot noise proxy of the brightest
+    /// channel, not a calibrated SNR (see getSnrIndex()). 0 keeps the most
+    /// channels allowed, whatever the light.
+    /// @param minSnrIndex Lowest SNR index.
+    void setMinSnrIndex(uint16_t minSnrIndex);
+
+    /// @brief Set the highest share of saturated frames to accept.
+    /// @param percent Saturated frames, in percent of the last
+    /// ksfAS7343SchedulerHistory frames. The default is 5.
+    /// @return True if successful, false if the percent is over 100.
+    bool setMaxSaturationPercent(uint8_t percent);
+
+    /// @brief Set the SMUX modes the scheduler chooses from.
+    /// @param minChannels Fewest channels, AUTOSMUX_6_CHANNELS (the default),
+    /// AUTOSMUX_12_CHANNELS or AUTOSMUX_18_CHANNELS.
+    /// @param maxChannels Most channels, AUTOSMUX_18_CHANNELS is the default.
+    /// @return True if successful, false if the range is invalid or the rate
+    /// is too high for it.
+    bool setChannelRange(sfe_as7343_auto_smux_channel_t minChannels, sfe_as7343_auto_smux_channel_t maxChannels);
+
+    /// @brief Update the estimates with a frame, and re-tune if needed.
+    /// @details Call it with every frame. Frames measured before the last
+    /// change took effect are skipped. A re-tune stops the measurement, writes
+    /// the new settings, and starts it again.
+    /// @param frame Frame from readFrame().
+    /// @return True if successful (including when nothing changes), false if it fails.
+    bool update(const sfe_as7343_frame_t &frame);
+
+    /// @brief Get the number of channels measured.
+    /// @return 6, 12 or 18, 0 before begin().
+    uint8_t getChannelCount(void);
+
+    /// @brief Get the SNR index of the last frame.
+    /// @details sqrt(counts / gain) of the brightest channel, with the counts
+    /// referred to 1x gain. Proportional to its shot noise limited SNR, the
+    /// factor (sqrt of the electrons per count) is not calibrated.
+    /// @return The SNR index of the brightest channel.
+    uint16_t getSnrIndex(void);
+
+    /// @brief Get the share of saturated frames.
+    /// @return Saturated frames since the last re-tune, in percent of
+    /// ksfAS7343SchedulerHistory frames.
+    uint8_t getSaturationPercent(void);
+
+  private:
+    /// @brief Get the integration time budget of one SMUX cycle.
+    /// @param numCycles Number of SMUX cycles, 1 to 3.
+    /// @param shift The budget is divided by 2 ^ shift.
+    /// @return The time in microseconds, 0 if the overhead doesn't leave any.
+    uint32_t getCycleTimeUs(uint8_t numCycles, uint8_t shift);
+
+    /// @brief Start over with the most channels the target allows.
+    /// @return True if successful, false if it fails.
+    bool restart(void);
+
+    /// @brief Write a new SMUX mode and integration time, with the gain and wait time to match.
+    /// @param numCycles Number of SMUX cycles, 1 to 3.
+    /// @param shift The integration time is the budget divided by 2 ^ shift.
+    /// @return True if successful, false if it fails.
+    bool retune(uint8_t numCycles, uint8_t shift);
+
+    sfDevAS7343 *_sensor;   // The sensor.
+    uint32_t _periodUs;     // Target frame period.
+    uint16_t _minSnrIndex;  // Lowest SNR index to keep.
+    uint8_t _maxSaturation; // Highest share of saturated frames, percent.
+    uint8_t _minCycles;     // Fewest SMUX cycles.
+    uint8_t _maxCycles;     // Most SMUX cycles.
+    uint8_t _numCycles;     // SMUX cycles set.
+    uint8_t _shift;         // Integration time is the budget / 2 ^ _shift.
+    uint8_t _settle;        // Frames left to skip after a re-tune.
+    uint16_t _snrIndex;     // SNR index of the last frame.
+    uint32_t _history;      // Bit n set if the n-th last frame saturated.
+    uint8_t _historyCount;  // Frames in _history.
+};
@@ -0,0 +1,114 @@
+/**
+ * @file sfDevAS7343T.h
+ * @brief Compile-time AutoSmux front end for the SparkFun AS7343 Sensor.
+ *
+ * @details
+ * sfDevAS7343T fixes the AutoSmux mode (6, 12 or 18 channels) at compile
+ * time. The channel count is a constant, and the accessors check at compile
+ * time that a channel is produced in that mode:
+ *
+ * @code
+ * sfDevAS7343T<AUTOSMUX_6_CHANNELS, SfeAS7343ArdI2C> mySensor;
+ *
+ * mySensor.begin();                              // Also sets the AutoSmux mode
+ * mySensor.readSpectraDataFromSensor();          // Reads 12 bytes
+ * uint16_t nir = mySensor.get<CH_NIR_855NM>();   // A single load
+ * uint16_t red = mySensor.get<CH_RED_F7_690NM>(); // Does not compile, cycle 3 channel
+ * @endcode
+ *
+ * @author SparkFun Electronics
+ * @date 2026
+ * @copyright Copyright (c) 2026, SparkFun Electronics Inc. This project is released under the MIT License.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * @section Repository Repository
+ * https://github.com/sparkfun/SparkFun_AS7343_Arduino_Library
+ */
+
+#pragma once
+
+#include "sfDevAS7343.h"
+
+/**
+ * @class sfDevAS7343T
+ * @brief AS7343 driver with the AutoSmux mode fixed at compile time.
+ *
+ * @details
+ * Adds compile-time checked accessors to a driver class (sfDevAS7343, or a
+ * class derived from it such as SfeAS7343ArdI2C). begin() sets the AutoSmux
+ * mode, and applyConfig() always keeps it, so the data the accessors read is
+ * always produced by the device.
+ *
+ * @tparam SmuxMode The AutoSmux mode.
+ * @tparam Base The driver class to extend.
+ */
+template <sfe_as7343_auto_smux_channel_t SmuxMode, class Base = sfDevAS7343> class sfDevAS7343T : public Base
+{
+  public:
+    /// Number of channels produced in SmuxMode.
+    static constexpr uint8_t kNumChannels =
+        SmuxMode == AUTOSMUX_18_CHANNELS ? 18 : (SmuxMode == AUTOSMUX_12_CHANNELS ? 12 : 6);
+
+    static_assert(kNumChannels <= ksfAS7343NumChannels, "AutoSmux mode produces too many channels");
+
+    /// @brief Initialize the device, then set the AutoSmux mode.
+    /// @details Takes the same arguments as Base::begin().
+    /// @return True if successful, false if it fails.
+    template <typename... Args> bool begin(Args &&...args)
+    {
+        if (Base::begin(static_cast<Args &&>(args)...) == false)
+            return false;
+
+        return Base::setAutoSmux(SmuxMode);
+    }
+
+    /// @brief Apply a full sensor configuration, keeping the AutoSmux mode.
+    /// @param config The configuration to apply, config.autoSmux is ignored.
+    /// @return True if successful, false if it fails.
+    bool applyConfig(const sfe_as7343_config_t &config)
+    {
+        sfe_as7343_config_t fixed = config;
+        fixed.autoSmux = SmuxMode;
+
+        return Base::applyConfig(fixed);
+    }
+
+    /// @brief Get the data of one channel, from the last read.
+    /// @details The channel is checked at compile time, there is no runtime
+    /// bounds check.
+    /// @tparam Channel The channel to get, produced in SmuxMode.
+    /// @return The channel data.
+    template <sfe_as7343_channel_t Channel> uint16_t get(void) const
+    {
+        static_assert(Channel < kNumChannels, "Channel is not produced in this AutoSmux mode");
+
+        return this->_data[this->_front][Channel].word;
+    }
+
+    /// @brief Copy the data of all channels produced in SmuxMode, from the last read.
+    /// @param data Array to store the data.
+    void getData(uint16_t (&data)[kNumChannels]) const
+    {
+        const sfe_as7343_reg_data_t *front = this->_data[this->_front];
+
+        for (uint8_t i = 0; i < kNumChannels; i++)
+            data[i] = front[i].word;
+    }
+
+    /// @brief Copy channel data from the last read, see sfDevAS7343::getData().
+    /// @param data Pointer to the array to store the data.
+    /// @param size Size of the array.
+    /// @return The number of channels copied.
+    uint8_t getData(uint16_t *data, size_t size)
+    {
+        return Base::getData(data, size);
+    }
+
+  private:
+    // The mode is fixed, set it through begin() and applyConfig() only.
+    using Base::setAutoSmux;
+};
+
+template <sfe_as7343_auto_smux_channel_t SmuxMode, class Base>
+constexpr uint8_t sfDevAS7343T<SmuxMode, Base>::kNumChannels;
@@ -0,0 +1,165 @@
+#!/usr/bin/env python3
+"""
+Decode SparkFun AS7343 binary frame records to CSV.
+
+Reads the records written by sfDevAS7343RecordEncoder (see
+src/sfTk/sfDevAS7343Record.h for the layout) from a file, or stdin, and
+prints one CSV line per record. Damaged records are skipped, delta records
+after a damaged record are skipped until the next key record.
+
+Usage:
+    python3 as7343_decode.py log.bin > log.csv
+    python3 as7343_decode.py < /dev/ttyUSB0
+
+SPDX-License-Identifier: MIT
+Copyright (c) 2026, SparkFun Electronics Inc.
+"""
+
+import sys
+
+RECORD_SYNC = 0xA7
+RECORD_VERSION = 1
+RECORD_MAX_BYTES = 74
+RECORD_HEADER_BYTES = 3
+
+CRC_POLY = 0x31
+CRC_INIT = 0xFF
+
+# Channels of the 18 channel mode, in frame order.
+CHANNEL_NAMES = [
+    "FZ", "FY", "FXL", "NIR", "VIS_1", "FD_1",
+    "F2", "F3", "F4", "F6", "VIS_2", "FD_2",
+    "F1", "F7", "F8", "F5", "VIS_3", "FD_3",
+]
+
+
+def crc8(data):
+    crc = CRC_INIT
+    for byte in data:
+        crc ^= byte
+        for _ in range(8):
+            crc = ((crc << 1) ^ CRC_POLY) & 0xFF if crc & 0x80 else (crc << 1) & 0xFF
+    return crc
+
+
+def num_channels(auto_smux):
+    return {3: 18, 2: 12}.get(auto_smux, 6)
+
+
+def get_varint(data, pos, end):
+    value = 0
+    for shift in range(0, 35, 7):
+        if pos >= end:
+            raise ValueError("varint past the end")
+        byte = data[pos]
+        pos += 1
+        value |= (byte & 0x7F) << shift
+        if not byte & 0x80:
+            return value & 0xFFFFFFFF, pos
+    raise ValueError("varint too long")
+
+
+class Decoder:
+    def __init__(self):
+        self.prev = None
+
+    def decode_payload(self, key, payload):
+        flags, gain, atime = payload[0], payload[1], payload[2]
+        pos, end = 3, len(payload)
+
+        astep, pos = get_varint(payload, pos, end)
+        sequence, pos = get_varint(payload, pos, end)
+        timestamp, pos = get_varint(payload, pos, end)
+
+        auto_smux = (flags >> 4) & 0x03
+        if not key and auto_smux != self.prev["auto_smux"]:
+            raise ValueError("delta record in another SMUX mode")
+
+        if not key:
+            sequence = (self.prev["sequence"] + sequence) & 0xFFFFFFFF
+            timestamp = (self.prev["timestamp"] + timestamp) & 0xFFFFFFFF
+
+        data = [0] * len(CHANNEL_NAMES)
+        for ch in range(num_channels(auto_smux)):
+            value, pos = get_varint(payload, pos, end)
+            if key:
+                data[ch] = value & 0xFFFF
+            else:
+                delta = -((value + 1) >> 1) if value & 1 else value >> 1
+                data[ch] = (self.prev["data"][ch] + delta) & 0xFFFF
+
+        return {
+            "sequence": sequence,
+            "timestamp": timestamp,
+            "gain": gain,
+            "atime": atime,
+            "astep": astep,
+            "auto_smux": auto_smux,
+            "valid": flags & 0x01 != 0,
+            "saturated_analog": flags & 0x02 != 0,
+            "saturated_digital": flags & 0x04 != 0,
+            "dark_corrected": flags & 0x08 != 0,
+            "data": data,
+        }
+
+    def records(self, stream):
+        """Yield the records in a byte string."""
+        pos = 0
+        while pos + RECORD_HEADER_BYTES <= len(stream):
+            # Any byte that doesn't start an intact record means a record was
+            # lost, delta records wait for the next key record.
+            if stream[pos] != RECORD_SYNC:
+                self.prev = None
+                pos += 1
+                continue
+
+            kind = stream[pos + 1]
+            length = RECORD_HEADER_BYTES + stream[pos + 2]
+            if kind >> 4 != RECORD_VERSION or length + 1 > RECORD_MAX_BYTES:
+                self.prev = None
+                pos += 1
+                continue
+
+            if pos + length + 1 > len(stream):
+                break
+
+            if crc8(stream[pos:pos + length]) != stream[pos + length]:
+                self.prev = None
+                pos += 1
+                continue
+
+            key = kind & 0x01 != 0
+            payload = stream[pos + RECORD_HEADER_BYTES:pos + length]
+            pos += length + 1
+
+            if not key and self.prev is None:
+                continue
+
+            try:
+                record = self.decode_payload(key, payload)
+            except (ValueError, IndexError):
+                self.prev = None
+                continue
+
+            self.prev = record
+            yield record
+
+
+def main():
+    if len(sys.argv) > 1:
+        with open(sys.argv[1], "rb") as f:
+            stream = f.read()
+    else:
+        stream = sys.stdin.buffer.read()
+
+    columns = ["sequence", "timestamp", "gain", "atime", "astep", "auto_smux", "valid",
+               "saturated_analog", "saturated_digital", "dark_corrected"]
+    print(",".join(columns + CHANNEL_NAMES))
+
+    for record in Decoder().records(stream):
+        values = [str(int(record[c])) for c in columns] + [str(v) for v in record["data"]]
+        print(",".join(values))
+
+
+if __name__ == "__main__":
+    main()